@@ -4,8 +4,8 @@
 layout(location = 0) in vec3 pos;
 layout(location = 1) in vec3 norm;
 layout(location = 2) in vec2 texCoord;     // UV coordinates
-layout(location = 3) in vec4 boneIndices;  // Indices of bones affecting this vertex
-layout(location = 4) in vec4 boneWeights;  // Weights of each bone's influence
+layout(location = 3) in uvec4 boneIndices; // Indices of bones affecting this vertex (packed bytes)
+layout(location = 4) in vec4 boneWeights;  // Weights of each bone's influence (normalized bytes)
 
 // Uniform matrices
 uniform mat4 proj;
@@ -15,7 +15,23 @@ uniform mat4 view;
 // Animation uniforms
 uniform bool hasArmature = false;
 uniform int boneCount = 0;
-uniform mat4 boneMatrices[100];  // Array of bone transformation matrices
+uniform mat4 boneMatrices[100];  // Array of bone transformation matrices (legacy per-object path)
+
+// Bone palette: every skinned instance's matrices in one buffer texture, 4 texels per matrix
+uniform bool useBonePalette = false;
+uniform samplerBuffer bonePalette;
+uniform int boneOffset = 0;      // First matrix of this instance in the palette
+
+mat4 getBoneMatrix(int boneIndex) {
+    if (useBonePalette) {
+        int base = (boneOffset + boneIndex) * 4;
+        return mat4(texelFetch(bonePalette, base),
+                    texelFetch(bonePalette, base + 1),
+                    texelFetch(bonePalette, base + 2),
+                    texelFetch(bonePalette, base + 3));
+    }
+    return boneMatrices[boneIndex];
+}
 
 // Output to fragment shader
 out vec3 FragPos;
@@ -39,7 +55,7 @@ void main() {
             
             if (weight > 0.0 && boneIndex >= 0 && boneIndex < boneCount) {
                 // Apply bone transformation weighted by its influence
-                mat4 boneTransform = boneMatrices[boneIndex];
+                mat4 boneTransform = getBoneMatrix(boneIndex);
                 positionTransformed += weight * (boneTransform * vec4(pos, 1.0));
                 
                 // Transform normal with bone matrix (ignoring translation)
@@ -0,0 +1,42 @@
+#version 410
+
+// Inputs from vertex shader
+in vec3 FragPos;      // World position (not stored, rebuilt from depth)
+in vec3 Normal;       // Normal vector
+in vec2 TexCoord;     // Texture coordinates
+
+// Material properties
+uniform bool hasTexture = false;
+uniform sampler2D textureSampler;
+uniform vec4 objectColor = vec4(1.0, 1.0, 1.0, 1.0);
+uniform vec3 baseColor = vec3(0.7f, 0.7f, 0.7f);
+
+// Compact G-Buffer targets
+layout (location = 0) out vec4 gAlbedo;    // RGBA8 albedo
+layout (location = 1) out vec2 gNormal;    // RG16 octahedron-encoded normal
+
+// Fold the lower hemisphere over the diagonals of the octahedron
+vec2 octWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Map a unit normal onto the [0,1] square
+vec2 encodeNormal(vec3 n) {
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    n.xy = n.z >= 0.0 ? n.xy : octWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+void main() {
+    // Calculate diffuse color
+    vec3 diffuseColor;
+    if (hasTexture) {
+        diffuseColor = texture(textureSampler, TexCoord).rgb * objectColor.rgb;
+    } else {
+        diffuseColor = baseColor * objectColor.rgb;
+    }
+    
+    // Output to G-Buffer
+    gAlbedo = vec4(diffuseColor, 1.0);
+    gNormal = encodeNormal(normalize(Normal));
+}
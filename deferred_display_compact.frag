@@ -0,0 +1,65 @@
+#version 410
+
+// Input UV coordinates from vertex shader
+smooth in vec2 uv;
+
+// Samplers for compact G-Buffer textures
+uniform sampler2D diffuseTexture;  // RGBA8 albedo
+uniform sampler2D normalTexture;   // RG16 octahedron-encoded normals
+uniform sampler2D depthTexture;    // Depth buffer from the geometry pass
+
+// Inverse of proj * view, used to rebuild world positions from depth
+uniform mat4 invViewProj;
+
+// Display mode
+// 0 = Combined result (deferred lighting)
+// 1 = Diffuse buffer only
+// 2 = Normal buffer only
+// 3 = Position buffer only (reconstructed)
+uniform int displayMode = 0;
+
+// Output color to default framebuffer
+out vec4 color;
+
+// Inverse of the octahedral mapping in deferred_compact.frag
+vec3 decodeNormal(vec2 f) {
+    f = f * 2.0 - 1.0;
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// Unproject the stored depth back to world space
+vec3 reconstructPosition(vec2 texCoord, float depth) {
+    vec4 ndc = vec4(texCoord * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = invViewProj * ndc;
+    return world.xyz / world.w;
+}
+
+void main() {
+    vec3 diffuse = texture(diffuseTexture, uv).rgb;
+    float depth = texture(depthTexture, uv).r;
+    
+    // Background pixels have no normal or position
+    if (depth >= 1.0 && displayMode != 1) {
+        color = vec4(diffuse, 1.0);
+        return;
+    }
+    
+    if (displayMode == 2) {
+        // Display normal vectors (map from [-1,1] to [0,1] for visualization)
+        vec3 normal = decodeNormal(texture(normalTexture, uv).rg);
+        color = vec4(normal * 0.5 + 0.5, 1.0);
+    }
+    else if (displayMode == 3) {
+        // Display positions (fractional part, as in deferred_display.frag)
+        vec3 position = reconstructPosition(uv, depth);
+        color = vec4(fract(position * 0.1), 1.0);
+    }
+    else {
+        // Diffuse colors
+        color = vec4(diffuse, 1.0);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef ANIMATION_BLENDING_HPP
+#define ANIMATION_BLENDING_HPP
+
+#include "Animations.hpp"
+#include <vector>
+
+// Per-bone layer weights (0 = bone ignored by the layer, 1 = full layer weight)
+struct BoneMask {
+    std::vector<float> weights;
+    
+    // Every bone at the same weight
+    static BoneMask all(size_t boneCount, float weight = 1.0f);
+    
+    // A bone and all of its descendants (e.g. upper body from the spine)
+    static BoneMask subtree(const std::vector<Bone>& bones, int rootBone, float weight = 1.0f);
+    
+    float get(size_t bone) const { return bone < weights.size() ? weights[bone] : 0.0f; }
+};
+
+// Blend math on dense pose buffers. Each function is one linear pass over the bones,
+// and the output may alias an input. Poses must already be sized (no allocation).
+namespace PoseBlend {
+    // out = nlerp(a, b, weight * mask) per bone
+    void blend(const AnimationPose& a, const AnimationPose& b, float weight,
+               const BoneMask* mask, AnimationPose& out);
+    
+    // out = base * nlerp(identity, delta, weight * mask) per bone
+    void applyAdditive(const AnimationPose& base, const AnimationPose& delta, float weight,
+                       const BoneMask* mask, AnimationPose& out);
+    
+    // out = conjugate(reference) * pose, the rotation that takes reference to pose
+    void makeAdditiveDelta(const AnimationPose& pose, const AnimationPose& reference, AnimationPose& out);
+    
+    // Copy rotations and animated flags (sizes must match)
+    void copy(const AnimationPose& source, AnimationPose& out);
+}
+
+// Layered animation for one GameObject.
+// Each layer blends a weighted set of clips (a one-level blend tree); layers are then
+// stacked bottom to top, overriding or adding on top of the result, optionally masked.
+// Cross-fades move clip weights linearly, so fading costs one extra sample per outgoing clip.
+class AnimationBlender {
+public:
+    enum class LayerMode {
+        Override,   // Replace the pose below (weighted, masked)
+        Additive    // Add the clip's motion relative to its first frame
+    };
+
+private:
+    struct ClipState {
+        AnimationClip* clip;
+        float time;
+        float speed;
+        bool loop;
+        float weight;
+        float targetWeight;
+        float fadeRate;                 // Weight change per second while fading
+        AnimationClip::Cursor cursor;
+        PoseKeyBatch keyBatch;
+        AnimationPose pose;
+        AnimationPose reference;        // First frame, for additive layers
+    };
+    
+    struct Layer {
+        LayerMode mode;
+        float weight;
+        bool masked;
+        BoneMask mask;
+        std::vector<ClipState> clips;
+        AnimationPose pose;             // Result of blending this layer's clips
+    };
+    
+    GameObject* target;
+    size_t boneCount;
+    std::vector<Layer> layers;
+    AnimationPose finalPose;
+    
+    ClipState makeClipState(const Layer& layer, AnimationClip* clip, float weight, bool loop) const;
+    void sampleClip(ClipState& state) const;
+    bool evaluateLayer(Layer& layer);
+
+public:
+    AnimationBlender(GameObject* target, size_t boneCount);
+    
+    // Layers are evaluated in the order they were added; returns the layer index
+    int addLayer(LayerMode mode, float weight = 1.0f);
+    void setLayerWeight(int layer, float weight);
+    void setLayerMask(int layer, const BoneMask& mask);
+    void clearLayerMask(int layer);
+    
+    // Add a clip to a layer's weighted blend; returns its slot in the layer
+    int addClip(int layer, AnimationClip* clip, float weight = 1.0f, bool loop = true);
+    void setClipWeight(int layer, int slot, float weight);
+    void setClipSpeed(int layer, int slot, float speed);
+    
+    // Fade every clip in the layer out and the new clip in over duration seconds
+    void crossFade(int layer, AnimationClip* clip, float duration, bool loop = true);
+    
+    // Advance clip times, sample, blend all layers and apply the result to the target
+    void update(float deltaTime);
+    
+    const AnimationPose& getPose() const { return finalPose; }
+    size_t getLayerCount() const { return layers.size(); }
+    size_t getClipCount(int layer) const;
+};
+
+#endif // ANIMATION_BLENDING_HPP
@@ -4,22 +4,221 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <set>
 #include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <ostream>
 #include "GameObject.hpp"
 #include "Quaternion.hpp"
+#include "QuaternionMath.hpp"
+#include "JobSystem.hpp"
+#include "SceneGraph.hpp"
 
 // Forward declaration
 class AnimationPlayer;
 
-// Animation class to store keyframes and bone rotations
-class Animation {
+// Dense pose buffer indexed by bone ID, filled by Animation::sample
+struct AnimationPose {
+    std::vector<Quaternion> rotations;  // Local rotation per bone
+    std::vector<uint8_t> animated;      // 1 if the clip has a track for this bone
+    
+    // Size the buffer (allocates; do this once, not per frame)
+    void resize(size_t boneCount) {
+        rotations.assign(boneCount, Quaternion());
+        animated.assign(boneCount, 0);
+    }
+    
+    size_t size() const { return rotations.size(); }
+};
+
+// Bracketing keys of every track at one sample time, in SoA form so the
+// interpolation can run several bones per SIMD instruction
+struct PoseKeyBatch {
+    std::vector<uint32_t> bones;
+    std::vector<float> aw, ax, ay, az;  // Key before the sample time
+    std::vector<float> bw, bx, by, bz;  // Key after the sample time
+    std::vector<float> alpha;           // Blend factor between the keys
+    size_t count = 0;
+    
+    // Size for a clip's track count (allocates; do this once, not per frame)
+    void reserve(size_t trackCount) {
+        bones.resize(trackCount);
+        aw.resize(trackCount); ax.resize(trackCount); ay.resize(trackCount); az.resize(trackCount);
+        bw.resize(trackCount); bx.resize(trackCount); by.resize(trackCount); bz.resize(trackCount);
+        alpha.resize(trackCount);
+        count = 0;
+    }
+    
+    void push(size_t bone, const Quaternion& a, const Quaternion& b, float t) {
+        if (count >= bones.size()) return;
+        bones[count] = static_cast<uint32_t>(bone);
+        aw[count] = a.getW(); ax[count] = a.getX(); ay[count] = a.getY(); az[count] = a.getZ();
+        bw[count] = b.getW(); bx[count] = b.getX(); by[count] = b.getY(); bz[count] = b.getZ();
+        alpha[count] = t;
+        count++;
+    }
+    
+    // Keep only the bones whose mask entry is set (bones past the end of the mask are dropped)
+    void retain(const std::vector<uint8_t>& mask) {
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t bone = bones[i];
+            if (bone >= mask.size() || !mask[bone]) continue;
+            if (kept != i) {
+                bones[kept] = bone;
+                aw[kept] = aw[i]; ax[kept] = ax[i]; ay[kept] = ay[i]; az[kept] = az[i];
+                bw[kept] = bw[i]; bx[kept] = bx[i]; by[kept] = by[i]; bz[kept] = bz[i];
+                alpha[kept] = alpha[i];
+            }
+            kept++;
+        }
+        count = kept;
+    }
+};
+
+// How much of a skeleton AnimationManager evaluates, picked from its size on screen
+enum class AnimationLOD : uint8_t {
+    Full,       // Every bone, every frame
+    Reduced,    // Every bone, every Nth frame
+    Distant,    // Bones near the root only, every Nth frame
+    Culled      // Outside the view frustum; the clock runs but no pose is sampled
+};
+
+// Thresholds for AnimationLOD selection
+struct AnimationLODSettings {
+    float reducedScreenSize = 0.25f;  // Bounds height as a fraction of the viewport below which updates are throttled
+    float distantScreenSize = 0.08f;  // Below this only the bone subset is evaluated
+    uint32_t reducedInterval = 2;     // Update every Nth frame
+    uint32_t distantInterval = 4;
+    int distantBoneDepth = 2;         // Deepest bone (hierarchy levels below a root) evaluated at Distant
+};
+
+// Skeleton counts for the last AnimationManager::update
+struct AnimationLODStats {
+    size_t fullyEvaluated = 0;        // Every bone sampled
+    size_t partiallyEvaluated = 0;    // Bone subset sampled
+    size_t notEvaluated = 0;          // Culled, or throttled this frame
+    
+    void print(std::ostream& out) const;
+};
+
+// Pose cache results of one AnimationManager update
+struct AnimationPoseCacheStats {
+    size_t hits = 0;      // Poses applied from another player's sample
+    size_t misses = 0;    // Poses sampled (one per shared group, or per unshared player)
+    size_t copies = 0;    // Shared poses copied because a modifier edits them
+    
+    void print(std::ostream& out) const;
+};
+
+// Animation events are interned once into small integer IDs so firing and dispatch
+// never hash strings. The IDs are process-local; files store event names.
+using AnimationEventID = uint32_t;
+
+namespace AnimationEvents {
+    // Built-in playback events, interned under their callback names
+    enum : AnimationEventID {
+        START = 0,      // "onAnimationStart"
+        STOP,           // "onAnimationStop"
+        COMPLETE,       // "onAnimationComplete"
+        LOOP            // "onAnimationLoop"
+    };
+    
+    // ID of an event name, registering it on first use (thread-safe)
+    AnimationEventID intern(const std::string& name);
+    
+    // Name an ID was interned under (empty for unknown IDs)
+    const std::string& getName(AnimationEventID id);
+}
+
+// Common interface of playable clips (raw keyframe tracks or compressed)
+class AnimationClip {
 public:
-    struct Keyframe {
-        float timestamp;                   // Time in seconds
-        std::vector<int> boneIDs;          // IDs of bones animated in this keyframe
-        std::vector<Quaternion> rotations; // Rotations for each bone
+    // Last key used per track, so monotonic playback advances instead of searching
+    struct Cursor {
+        std::vector<uint32_t> keys;
+        float lastTime = -1.0f;
+    };
+    
+    virtual ~AnimationClip() = default;
+    
+    // Size a pose buffer / cursor for this clip (allocates; call when a clip starts playing)
+    void preparePose(AnimationPose& pose) const;
+    void prepareCursor(Cursor& cursor) const;
+    
+    void prepareKeyBatch(PoseKeyBatch& batch) const;
+    
+    // Sample every track into a prepared pose buffer; never touches the heap
+    virtual void sample(float time, AnimationPose& pose, Cursor* cursor = nullptr) const = 0;
+    
+    // Collect the bracketing keys of every track into a prepared batch
+    virtual void gatherKeys(float time, Cursor* cursor, PoseKeyBatch& batch) const = 0;
+    
+    // Batched sampling: gather keys, then interpolate all bones with SIMD
+    void sampleBatched(float time, AnimationPose& pose, Cursor* cursor, PoseKeyBatch& batch) const;
+    
+    // Interpolate every gathered key pair into the pose
+    static void interpolateBatch(const PoseKeyBatch& batch, AnimationPose& pose,
+                                 QuaternionMath::InterpolationMode mode);
+    
+    // Number of bone tracks in the clip
+    virtual size_t getTrackCount() const = 0;
+    
+    // Pose buffer size needed for this clip (highest bone ID + 1)
+    size_t getPoseSize() const { return poseSize; }
+    
+    // Event fired when playback crosses a clip time (e.g. a footstep)
+    struct EventKey {
+        float time;
+        AnimationEventID id;
+    };
+    
+    // Add an event; the track stays sorted by time
+    void addEvent(float time, AnimationEventID id);
+    void addEvent(float time, const std::string& eventName);
+    const std::vector<EventKey>& getEvents() const { return events; }
+    
+    // Call emit(id) for every event with begin < time <= end, or begin <= time <= end
+    // when includeBegin is set. Binary search, then a linear walk over the crossed keys.
+    template <typename Emit>
+    void forEachEvent(float begin, float end, bool includeBegin, Emit&& emit) const {
+        auto first = includeBegin
+            ? std::lower_bound(events.begin(), events.end(), begin,
+                               [](const EventKey& key, float t) { return key.time < t; })
+            : std::upper_bound(events.begin(), events.end(), begin,
+                               [](float t, const EventKey& key) { return t < key.time; });
+        for (auto it = first; it != events.end() && it->time <= end; ++it) {
+            emit(it->id);
+        }
+    }
+    
+    std::string name;
+    float duration;  // Total animation length
+    
+    // Key interpolation used by sample() and sampleBatched()
+    QuaternionMath::InterpolationMode interpolationMode;
+
+protected:
+    AnimationClip() : duration(0.0f), interpolationMode(QuaternionMath::InterpolationMode::ApproxSlerp), poseSize(0) {}
+    
+    size_t poseSize;
+    std::vector<EventKey> events;   // Sorted by time
+    
+    // Exact slerp (used where the reference result matters, e.g. compression error)
+    static Quaternion slerp(const Quaternion& q1, const Quaternion& q2, float t);
+};
+
+// Animation class to store per-bone rotation tracks
+class Animation : public AnimationClip {
+public:
+    // All keys of one bone; times and rotations are parallel arrays
+    struct BoneTrack {
+        int boneID;
+        std::vector<float> times;          // Key times in seconds, ascending
+        std::vector<Quaternion> rotations; // Rotation at each key time
     };
     
     Animation();
@@ -27,16 +226,24 @@ public:
     // Load animation from file
     static Animation loadFromFile(const std::string& filename);
     
-    // Get interpolated bone rotations at a specific time
+    // Sample every track into a prepared pose buffer; never touches the heap
+    void sample(float time, AnimationPose& pose, Cursor* cursor = nullptr) const override;
+    void gatherKeys(float time, Cursor* cursor, PoseKeyBatch& batch) const override;
+    
+    size_t getTrackCount() const override { return tracks.size(); }
+    
+    // Get interpolated bone rotations at a specific time (allocates; prefer sample)
     std::map<int, Quaternion> getBoneRotationsAtTime(float time) const;
     
-    std::string name;
-    std::vector<Keyframe> keyframes;
-    float duration;  // Total animation length
+    std::vector<BoneTrack> tracks;  // One track per animated bone, sorted by bone ID
 
 private:
-    // SLERP implementation for quaternion interpolation
-    static Quaternion slerp(const Quaternion& q1, const Quaternion& q2, float t);
+    // Index of the key at or before time (time must lie inside the track)
+    static uint32_t findKey(const BoneTrack& track, float time);
+    
+    // Find the bracketing keys of every track and pass them to visit(bone, q1, q2, alpha)
+    template <typename Visitor>
+    void visitKeys(float time, Cursor* cursor, Visitor&& visit) const;
 };
 
 // AnimationPlayer to manage animation playback
@@ -45,10 +252,13 @@ public:
     // Event callback function type for animation events
     using AnimEventCallback = std::function<void(AnimationPlayer*, const std::string&)>;
     
+    // Edits the sampled pose before it reaches the target (e.g. look-at or IK)
+    using PoseModifier = std::function<void(AnimationPlayer*, AnimationPose&)>;
+    
     AnimationPlayer(GameObject* target);
     
     // Play animation from start
-    void play(Animation* animation, bool loop = false);
+    void play(AnimationClip* animation, bool loop = false);
     
     // Resume paused animation
     void resume();
@@ -66,7 +276,7 @@ public:
     float getPlaybackSpeed() const { return playbackSpeed; }
     
     // Get current animation
-    Animation* getCurrentAnimation() const;
+    AnimationClip* getCurrentAnimation() const;
     
     // Get current animation time
     float getCurrentTime() const;
@@ -80,39 +290,90 @@ public:
     // Set animation time directly (for seeking)
     void setTime(float time);
     
-    // Register event callback
+    // Set or clear (nullptr) the pose modifier
+    void setPoseModifier(PoseModifier modifier) { poseModifier = std::move(modifier); }
+    bool hasPoseModifier() const { return static_cast<bool>(poseModifier); }
+    
+    // Register event callback (the name is interned once here, not per event)
     void registerEventCallback(const std::string& eventName, AnimEventCallback callback);
+    void registerEventCallback(AnimationEventID eventID, AnimEventCallback callback);
     
     // Update animation state
     void update(float deltaTime);
     
+    // Batched update stages used by AnimationManager:
+    // advance the clock (queues events), apply the pose (thread-safe per player),
+    // then dispatch queued events on the main thread
+    bool advanceTime(float deltaTime);
+    void applyBatchedPose();
+    void dispatchPendingEvents();
+    
+    // Pose sharing used by AnimationManager: one player samples its clip into a shared
+    // buffer, then every player at the same clip time applies it. A player with a pose
+    // modifier copies the shared pose into its own buffer first (copy-on-write).
+    void sampleSharedPose(AnimationPose& shared);
+    void applySharedPose(const AnimationPose& shared);
+    
+    // Level of detail for the next applyBatchedPose; Distant evaluates bones up to maxBoneDepth
+    void setLOD(AnimationLOD level, int maxBoneDepth = 0);
+    AnimationLOD getLOD() const { return lod; }
+    
+    // World-space bounding sphere of the target, used for LOD selection.
+    // The extent is measured once per play() so the check costs O(1) per frame.
+    bool getLODSphere(glm::vec3& center, float& radius);
+
 private:
     GameObject* target;                // Target object with armature
-    Animation* currentAnimation;       // Current animation being played
+    AnimationClip* currentAnimation;   // Current animation being played
     float currentTime;                 // Current playback time
+    float prevTime;                    // Time before the last advance; events fire in (prevTime, currentTime]
     bool isPlaying;
     bool looping;
     float playbackSpeed;               // Speed multiplier for animation
     
-    std::map<std::string, AnimEventCallback> eventCallbacks;
+    std::vector<AnimEventCallback> eventCallbacks;  // Indexed by AnimationEventID
+    
+    AnimationPose pose;                // Sampled pose, reused every frame
+    AnimationClip::Cursor cursor;      // Key cursor for the current animation
+    PoseKeyBatch keyBatch;             // Key pairs for batched interpolation
+    std::vector<AnimationEventID> pendingEvents;    // Raised by advanceTime, in firing order
+    std::vector<AnimationEventID> dispatchingEvents; // Swapped in while callbacks run
+    PoseModifier poseModifier;
+    bool poseStale;                    // Last pose came from a shared buffer; pose holds older rotations
+    
+    AnimationLOD lod;
+    int lodBoneDepth;                  // Depth lodBoneMask was built for (-1 = not built)
+    std::vector<uint8_t> lodBoneMask;  // Bones evaluated at AnimationLOD::Distant
+    glm::vec3 lodCenterOffset;         // Bounds center relative to the target position
+    float lodRadius;                   // Bounding sphere radius (negative = not measured yet)
+    
+    void buildLODBoneMask(int maxBoneDepth);
     
     // Apply pose at current time
     void applyPoseAtCurrentTime();
     
+    // Run the modifier, then hand the pose to the target
+    void applyPose(AnimationPose& sampled);
+    
+    // Queue clip events crossed between two times of one pass through the clip
+    void queueClipEvents(float begin, float end, bool includeBegin);
+    
     // Trigger an event callback
-    void triggerEvent(const std::string& eventName);
+    void triggerEvent(AnimationEventID eventID);
 };
 
 // Animation Manager to handle multiple animations
 class AnimationManager {
 public:
+    // Players are updated in parallel when a job system is given
+    AnimationManager(JobSystem* jobSystem = nullptr);
     ~AnimationManager();
     
-    // Load animation from file
+    // Load animation from file (.anim text, or .canim compressed clip)
     bool loadAnimation(const std::string& name, const std::string& filename);
     
     // Get animation by name
-    Animation* getAnimation(const std::string& name);
+    AnimationClip* getAnimation(const std::string& name);
     
     // Get or create animation player for object
     AnimationPlayer* getPlayer(GameObject* object);
@@ -123,9 +384,58 @@ public:
     // Update all animation players
     void update(float deltaTime);
     
+    // Camera used to pick a level of detail per player (nullptr = every player at full detail)
+    void setLODCamera(const Camera* camera);
+    void setLODSettings(const AnimationLODSettings& settings) { lodSettings = settings; }
+    const AnimationLODSettings& getLODSettings() const { return lodSettings; }
+    
+    // How many skeletons the last update evaluated fully, partially or not at all
+    const AnimationLODStats& getLODStats() const { return lodStats; }
+    
+    // Players on the same clip whose times fall in the same step of this many seconds
+    // share one sampled pose per update (crowds in lockstep). 0 disables sharing.
+    void setPoseCacheQuantum(float seconds) { poseCacheQuantum = std::max(0.0f, seconds); }
+    float getPoseCacheQuantum() const { return poseCacheQuantum; }
+    const AnimationPoseCacheStats& getPoseCacheStats() const { return poseCacheStats; }
+
 private:
-    std::map<std::string, Animation> animations;
-    std::map<GameObject*, AnimationPlayer*> players;
+    std::map<std::string, std::unique_ptr<AnimationClip>> animations;
+    std::deque<AnimationPlayer> players;                       // Dense, stable addresses
+    std::unordered_map<GameObject*, AnimationPlayer*> playerLookup;
+    std::vector<AnimationPlayer*> activePlayers;               // Reused every update
+    JobSystem* jobSystem;
+    
+    const Camera* lodCamera;
+    Frustum lodFrustum;                                        // Rebuilt from lodCamera every update
+    AnimationLODSettings lodSettings;
+    AnimationLODStats lodStats;
+    uint32_t frameIndex;                                       // Drives throttled update phases
+    
+    // Pose cache: active players sorted by (clip, time step), then one buffer per duplicate group
+    struct PoseShareKey {
+        const AnimationClip* clip;
+        uint32_t timeStep;
+        AnimationPlayer* player;
+    };
+    struct SharedPose {
+        AnimationPose pose;
+        const AnimationClip* clip = nullptr;   // Clip the buffer was last sized for
+        AnimationPlayer* sampler = nullptr;    // Player that samples it this update
+    };
+    float poseCacheQuantum;
+    AnimationPoseCacheStats poseCacheStats;
+    std::vector<PoseShareKey> poseShareKeys;
+    std::vector<SharedPose> sharedPoses;                       // Grows only; first sharedPoseCount in use
+    size_t sharedPoseCount;
+    std::vector<std::pair<AnimationPlayer*, uint32_t>> sharedPoseUsers;  // Player, shared pose index
+    
+    // Pick a player's level of detail from its projected size
+    AnimationLOD selectLOD(AnimationPlayer& player);
+    
+    // Move duplicate (clip, time step) players out of activePlayers into shared groups
+    void buildPoseShares();
+    
+    static const size_t PLAYERS_PER_JOB = 16;
 };
 
 #endif // ANIMATIONS_HPP
\ No newline at end of file
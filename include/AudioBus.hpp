@@ -0,0 +1,144 @@
+#ifndef AUDIO_BUS_HPP
+#define AUDIO_BUS_HPP
+
+#include "AudioKernels.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mix bus a voice plays on
+enum class AudioBusID : uint8_t {
+    SFX,
+    Music,
+    UI
+};
+
+// Feed-forward compressor settings; an infinite ratio with no attack is a brick-wall limiter
+struct CompressorSettings {
+    float thresholdDb = -12.0f;
+    float ratio = 4.0f;
+    float attackMs = 5.0f;      // 0 = instant: the output never exceeds the threshold
+    float releaseMs = 120.0f;
+    float makeupDb = 0.0f;
+    
+    static CompressorSettings limiter(float ceilingDb);
+};
+
+// Stereo-linked compressor: one gain for both channels, from the louder one
+class Compressor {
+public:
+    Compressor(const CompressorSettings& settings, int sampleRate);
+    
+    void setSettings(const CompressorSettings& settings);
+    
+    // Compress interleaved stereo in place; levels and gains are scratch of at least frames floats
+    void process(float* buffer, size_t frames, float* levels, float* gains, unsigned maxLanes = 8);
+    
+    // Deepest gain reduction of the last process() call (dB, 0 or negative)
+    float getGainReductionDb() const { return gainReductionDb; }
+
+private:
+    int sampleRate;
+    float threshold;        // Linear
+    float slope;            // 1 - 1 / ratio
+    float makeup;
+    float attack;           // One-pole coefficients per frame
+    float release;
+    float envelope;
+    float gainReductionDb;
+};
+
+// Small Schroeder/Freeverb-style room: four damped combs and two allpasses per channel,
+// tuned at 44.1 kHz and scaled to the sample rate
+class Reverb {
+public:
+    explicit Reverb(int sampleRate);
+    
+    // Add the reverb of interleaved stereo input to output
+    void process(const float* input, float* output, size_t frames);
+
+private:
+    static const int COMBS = 4;
+    static const int ALLPASSES = 2;
+    
+    struct Comb {
+        std::vector<float> buffer;
+        size_t index = 0;
+        float damped = 0.0f;
+    };
+    struct Allpass {
+        std::vector<float> buffer;
+        size_t index = 0;
+    };
+    
+    Comb combs[2][COMBS];
+    Allpass allpasses[2][ALLPASSES];
+    float feedback;
+    float damping;
+};
+
+// The mixer's buses and effects. Voices are mixed into the input of their bus; render()
+// then runs, in fixed blocks, each bus's low-pass and compressor, its gain into the master
+// and its send into a shared reverb, and finally a master limiter, so overlapping voices are
+// levelled instead of clipped. Parameter changes take effect (and ramp) per block.
+// Audio thread only; nothing allocates after construction.
+class AudioBusGraph {
+public:
+    static constexpr int BUS_COUNT = 3;
+    static constexpr size_t BLOCK_FRAMES = 128;    // DSP block; parameters ramp per block
+    
+    AudioBusGraph(int sampleRate, size_t maxFrames);
+    
+    AudioBusGraph(const AudioBusGraph&) = delete;
+    AudioBusGraph& operator=(const AudioBusGraph&) = delete;
+    
+    // Zero every bus input for a render of frames (at most maxFrames)
+    void begin(size_t frames);
+    
+    // Interleaved stereo input of a bus for the current render
+    float* getInput(AudioBusID bus);
+    
+    // Process the buses and write the master mix of the current render to output
+    void render(float* output, unsigned maxLanes = 8);
+    
+    void setGain(AudioBusID bus, float gain);
+    void setLowPass(AudioBusID bus, float cutoff);      // Hz; 0 turns the filter off
+    void setReverbSend(AudioBusID bus, float send);
+    void setCompressor(AudioBusID bus, bool enabled, const CompressorSettings& settings = CompressorSettings());
+    
+    // Master limiter gain reduction in the last block (dB)
+    float getMasterGainReductionDb() const { return limiter.getGainReductionDb(); }
+
+private:
+    struct Bus {
+        std::vector<float> input;
+        bool used = false;              // A voice played on it in the current render
+        float gain = 1.0f;
+        float appliedGain = 1.0f;       // Reached at the end of the last block
+        float send = 0.0f;
+        float appliedSend = 0.0f;
+        float cutoff = 0.0f;
+        float filterCutoff = 0.0f;      // Cutoff of coefficients
+        AudioKernels::BiquadCoefficients coefficients = {};
+        AudioKernels::BiquadState filterState = {};
+        bool compress = false;
+        Compressor compressor;
+        
+        explicit Bus(int sampleRate) : compressor(CompressorSettings(), sampleRate) {}
+    };
+    
+    int sampleRate;
+    size_t maxFrames;
+    size_t frames;                      // Of the current render
+    std::vector<Bus> buses;
+    std::vector<float> reverbInput;
+    std::vector<float> levels;          // Compressor scratch
+    std::vector<float> gains;
+    Reverb reverb;
+    size_t reverbIdleFrames;            // Since the reverb last had input
+    Compressor limiter;
+    
+    Bus& bus(AudioBusID id) { return buses[static_cast<size_t>(id)]; }
+};
+
+#endif // AUDIO_BUS_HPP
@@ -0,0 +1,93 @@
+#ifndef AUDIO_COMMAND_QUEUE_HPP
+#define AUDIO_COMMAND_QUEUE_HPP
+
+#include "AudioBus.hpp"
+#include "SoundBank.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-capacity single-producer / single-consumer ring.
+// push and pop never block or allocate, so the audio callback can use it safely.
+// Exactly one thread may push and one (other) thread may pop.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0) {}
+    
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    // Producer: returns false (and drops the item) when the ring is full
+    bool push(const T& item) {
+        const size_t write = head.load(std::memory_order_relaxed);
+        if (write - tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[write & (Capacity - 1)] = item;
+        head.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer: returns false when the ring is empty
+    bool pop(T& item) {
+        const size_t read = tail.load(std::memory_order_relaxed);
+        if (read == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[read & (Capacity - 1)];
+        tail.store(read + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Approximate when called while the other side is active
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> head;   // Next slot to write (producer only)
+    alignas(64) std::atomic<size_t> tail;   // Next slot to read (consumer only)
+    T items[Capacity];
+};
+
+class AudioStream;
+
+// Identifies one playback of a sound (0 = none); assigned by the game thread
+using SoundHandle = uint32_t;
+
+// Game thread -> audio callback message
+struct AudioCommand {
+    enum class Type : uint8_t {
+        Play,               // Start sound or stream on a free voice as handle
+        Stop,               // Stop the voice playing handle
+        StopAll,
+        SetGain,            // Voice gain (0..1) for handle
+        SetPan,             // Voice pan (-1..1) for handle
+        SetSpatial,         // Attenuation, pan and pitch of a positional sound
+        SetBusGain,         // Gain of bus
+        SetBusLowPass,      // Low-pass cutoff of bus (Hz, 0 = off)
+        SetBusReverbSend    // Reverb send level (0..1) of bus
+    };
+    
+    Type type;
+    int priority;           // Play: higher priorities survive voice stealing
+    SoundHandle handle;
+    AudioBusID bus;         // Play, bus commands
+    SoundSamples samples;   // Play: decoded samples (must outlive playback)
+    AudioStream* stream;    // Play: or a stream, released when its voice ends
+    bool positional;        // Play: report the end of the voice back to the game thread
+    uint64_t queuedAt;      // Play: SoundSystem latency clock (ns) when queued
+    float gain;             // SetGain, SetBusGain, SetBusReverbSend
+    float cutoff;           // SetBusLowPass
+    float pan;              // Play, SetPan, SetSpatial
+    float attenuation;      // Play, SetSpatial
+    float pitch;            // Play, SetSpatial
+};
+
+#endif // AUDIO_COMMAND_QUEUE_HPP
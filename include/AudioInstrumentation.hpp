@@ -0,0 +1,67 @@
+#ifndef AUDIO_INSTRUMENTATION_HPP
+#define AUDIO_INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Log-scale histogram of durations. One thread records (the audio callback: no locks or
+// allocation, relaxed atomics only); any thread may read while it does.
+class TimingHistogram {
+public:
+    static const int BUCKETS = 24;  // [0, 1) us, [1, 2) us, [2, 4) us, ... [2^22 us, inf)
+    
+    TimingHistogram();
+    
+    void record(uint64_t nanoseconds);
+    
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    double getMeanMicros() const;
+    double getMaxMicros() const { return maxNanos.load(std::memory_order_relaxed) / 1000.0; }
+    
+    // Upper edge of the bucket that holds the given fraction (0..1) of the samples, at most the max
+    double getPercentileMicros(double fraction) const;
+    
+    // One line: count, mean, p50, p99 and max, then the non-empty buckets
+    void print(const std::string& label, std::ostream& out) const;
+
+private:
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalNanos;
+    std::atomic<uint64_t> maxNanos;
+};
+
+// What the audio callback has been doing: how long each callback took against its buffer's
+// duration, how often a stream had no data, and how long a play request waited in the
+// command ring before the callback that mixes its first sample
+class AudioInstrumentation {
+public:
+    AudioInstrumentation();
+    
+    // Audio thread, once per callback: a callback longer than its buffer plays is a
+    // deadline miss, which a device hears as an underrun
+    void recordCallback(uint64_t durationNanos, size_t frames, int sampleRate, uint64_t streamUnderrunTotal);
+    
+    // Audio thread: a Play command was applied latencyNanos after it was queued
+    void recordPlayLatency(uint64_t latencyNanos) { playLatency.record(latencyNanos); }
+    
+    const TimingHistogram& getCallbackTimes() const { return callbackTimes; }
+    const TimingHistogram& getPlayLatency() const { return playLatency; }
+    uint64_t getCallbackCount() const { return callbackTimes.getCount(); }
+    uint64_t getDeadlineMissCount() const { return deadlineMisses.load(std::memory_order_relaxed); }
+    uint64_t getStreamUnderrunCount() const { return streamUnderruns.load(std::memory_order_relaxed); }
+    
+    void print(std::ostream& out) const;
+
+private:
+    TimingHistogram callbackTimes;
+    TimingHistogram playLatency;
+    std::atomic<uint64_t> deadlineMisses;
+    std::atomic<uint64_t> streamUnderruns;
+    std::atomic<uint64_t> budgetNanos;     // Buffer duration of the last callback
+};
+
+#endif // AUDIO_INSTRUMENTATION_HPP
@@ -0,0 +1,111 @@
+#ifndef AUDIO_KERNELS_HPP
+#define AUDIO_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Sample conversion, panning and resampling kernels for the mixer.
+// Float samples are in [-1, 1]; stereo buffers are interleaved L/R.
+// Mixing kernels run 4 frames per step with AVX, 2 with SSE, and fall back to scalar
+// code otherwise; maxLanes limits the SIMD width (1, 4 or 8) for benchmarking.
+namespace AudioKernels {
+    struct StereoGain {
+        float left;
+        float right;
+    };
+    
+    // Equal-power pan (-1 = left, 0 = center at -3 dB per side, 1 = right) scaled by gain
+    StereoGain equalPowerPan(float pan, float gain);
+    
+    // out[i] = in[i] / 32768
+    void s16ToFloat(const int16_t* in, float* out, size_t count, unsigned maxLanes = 8);
+    
+    // Clip to [-1, 1] and round to S16
+    void floatToS16(const float* in, int16_t* out, size_t count, unsigned maxLanes = 8);
+    
+    // Add a mono source to interleaved stereo; the gain ramps linearly from start
+    // (first frame) towards end (reached at the frame after the last)
+    void mixMonoToStereo(const float* in, float* out, size_t frames,
+                         StereoGain start, StereoGain end, unsigned maxLanes = 8);
+    
+    // Add an interleaved stereo source to interleaved stereo with a per-side gain ramp
+    void mixStereo(const float* in, float* out, size_t frames,
+                   StereoGain start, StereoGain end, unsigned maxLanes = 8);
+    
+    // Linear interpolation at a fixed rate, for pitched voices: output frame i is the
+    // interleaved source (1 or 2 channels) read fraction + i * rate frames past in.
+    // Reads up to frame floor(fraction + (frames - 1) * rate) + 1. SIMD paths compute
+    // 8 (AVX) or 4 (SSE) read positions per step
+    void resampleLinear(const float* in, int channels, float fraction, float rate,
+                        float* out, size_t frames, unsigned maxLanes = 8);
+    
+    // Normalized biquad (a0 = 1), run in transposed direct form II
+    struct BiquadCoefficients {
+        float b0, b1, b2;
+        float a1, a2;
+    };
+    
+    // Filter memory of both channels of a stereo biquad
+    struct BiquadState {
+        float z1[2];
+        float z2[2];
+    };
+    
+    // Low-pass from the RBJ cookbook; q = 0.7071 is Butterworth
+    BiquadCoefficients lowPassCoefficients(float cutoff, float q, int sampleRate);
+    
+    // Filter interleaved stereo in place. The recursion is serial in time, so the SIMD
+    // path runs the left and right channels side by side in one register.
+    void biquadStereo(float* buffer, size_t frames, const BiquadCoefficients& coefficients,
+                      BiquadState& state, unsigned maxLanes = 8);
+    
+    // out[i] = max(|left|, |right|) of frame i
+    void stereoPeak(const float* in, float* out, size_t frames, unsigned maxLanes = 8);
+    
+    // Scale both samples of frame i by gains[i]
+    void applyFrameGains(float* buffer, const float* gains, size_t frames, unsigned maxLanes = 8);
+    
+    // PCM sample formats decodeToFloat reads (native endian)
+    enum class SampleFormat { U8, S8, S16, S32, F32 };
+    
+    // Decode raw sample data to float
+    void decodeToFloat(const uint8_t* data, size_t bytes, SampleFormat format, std::vector<float>& out);
+    
+    // Polyphase windowed-sinc resampling of interleaved frames. Downsampling lowers the
+    // cutoff to the output Nyquist so nothing aliases. Meant for load time, not the callback.
+    void resample(const std::vector<float>& in, int channels, int inRate, int outRate,
+                  std::vector<float>& out, unsigned maxLanes = 8);
+    
+    // Block-by-block form of resample() for streaming: the filter history carries over
+    // between calls, so the output matches a single resample() of the whole sound
+    class Resampler {
+    public:
+        Resampler(int channels, int inRate, int outRate);
+        
+        // Append the output for these interleaved input frames
+        void process(const float* in, size_t frames, std::vector<float>& out, unsigned maxLanes = 8);
+        
+        // Append the output held back by the filter delay; call once at the end of the sound
+        void flush(std::vector<float>& out, unsigned maxLanes = 8);
+    
+    private:
+        int channels;
+        bool passthrough;                         // Same rate: no filtering
+        double step;                              // Input frames per output frame
+        int taps;
+        int halfTaps;
+        std::vector<float> table;                 // taps per phase, phases + 1 rows
+        std::vector<std::vector<float>> history;  // Unconsumed input per channel
+        double position;                          // Next output; its taps start at history[floor + 1]
+    };
+    
+    // Widest mixing path compiled in ("AVX", "SSE" or "scalar")
+    const char* simdPathName();
+    
+    // Time every kernel at every width, plus resampling throughput and accuracy
+    void runBenchmark(size_t frames, int iterations, std::ostream& out);
+}
+
+#endif // AUDIO_KERNELS_HPP
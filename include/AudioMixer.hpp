@@ -0,0 +1,142 @@
+#ifndef AUDIO_MIXER_HPP
+#define AUDIO_MIXER_HPP
+
+#include "AudioBus.hpp"
+#include "AudioCommandQueue.hpp"
+#include "AudioKernels.hpp"
+#include "AudioStream.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Parameters of a voice to start
+struct VoiceDesc {
+    const float* samples = nullptr;   // Interleaved float frames at the output rate
+    uint32_t frameCount = 0;
+    AudioStream* stream = nullptr;    // Read from a stream instead of samples; released when the voice ends
+    int channels = 1;                 // 1 (panned) or 2 (balanced)
+    float gain = 1.0f;
+    float pan = 0.0f;                 // -1 = left, 1 = right
+    float attenuation = 1.0f;         // Distance gain of a positional sound
+    float pitch = 1.0f;               // Playback rate (Doppler); streams always play at 1
+    int priority = 0;                 // Higher priorities survive voice stealing
+    AudioBusID bus = AudioBusID::SFX;
+    bool looping = false;
+    bool notifyEnd = false;           // Report the handle to the end callback when the voice ends
+};
+
+// Real-time voice mixer for the audio callback.
+// Voices live in a pool allocated up front; when it is full, a new voice replaces the
+// lowest-priority voice (inaudible ones first, then the oldest) if that one does not outrank it.
+// Voices quieter than AUDIBLE_GAIN are virtual: they keep their place in time but are not mixed.
+// Voices accumulate in 32-bit float stereo on their bus; AudioBusGraph runs the bus effects
+// and the master limiter, and the result is clipped and converted to S16 once.
+// Gain and pan changes ramp over one mix() chunk so they never click.
+// play/stop/mix never allocate, lock or do I/O.
+class AudioMixer {
+public:
+    static const int CHANNELS = 2;
+    static constexpr float AUDIBLE_GAIN = 0.001f;   // -60 dB
+    static constexpr float PITCH_EPSILON = 0.001f;  // Closer to 1 plays unresampled (under 2 cents)
+    
+    // Called on the mixing thread with the handle of an ended voice that asked for it
+    using VoiceEndCallback = void (*)(void* userdata, SoundHandle handle);
+    
+    AudioMixer(size_t maxVoices, size_t maxFrames, int sampleRate);
+    
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+    
+    void setVoiceEndCallback(VoiceEndCallback callback, void* userdata);
+    
+    // Start a voice; returns false (releasing its stream) if no voice could be freed for it
+    bool play(SoundHandle handle, const VoiceDesc& desc);
+    void stop(SoundHandle handle);
+    void stopAll();
+    void setGain(SoundHandle handle, float gain);
+    void setPan(SoundHandle handle, float pan);
+    void setSpatial(SoundHandle handle, float attenuation, float pan, float pitch);
+    
+    // Mix every active voice into interleaved stereo S16 output
+    void mix(int16_t* output, size_t frames);
+    
+    // Same mix as float before conversion, for offline rendering without a device
+    void mix(float* output, size_t frames);
+    
+    // Bus gains and effects
+    AudioBusGraph& getBuses() { return buses; }
+    
+    size_t getActiveVoiceCount() const { return activeVoices; }
+    size_t getVirtualVoiceCount() const { return virtualVoices; }   // In the last mix() chunk
+    size_t getMaxVoices() const { return voices.size(); }
+    uint64_t getStolenVoiceCount() const { return stolenVoices; }
+    uint64_t getRejectedVoiceCount() const { return rejectedVoices; }
+    uint64_t getStreamUnderrunCount() const { return streamUnderruns; }
+    
+    // Offline stress test (no audio device): worst and average mix() time for N voices
+    static void runBenchmark(int callbacks, std::ostream& out);
+
+private:
+    struct Voice {
+        SoundHandle handle = 0;
+        const float* samples = nullptr;
+        uint32_t frameCount = 0;
+        AudioStream* stream = nullptr;
+        uint32_t position = 0;      // Next frame to mix (streams: frames mixed so far)
+        uint32_t startOrder = 0;    // Tie-break for stealing: older voices go first
+        int channels = 1;
+        float gain = 1.0f;
+        float pan = 0.0f;
+        float attenuation = 1.0f;
+        float pitch = 1.0f;
+        float fraction = 0.0f;      // Position between frames when pitched
+        AudioKernels::StereoGain applied = {};   // Gains reached at the end of the last chunk
+        int priority = 0;
+        AudioBusID bus = AudioBusID::SFX;
+        bool looping = false;
+        bool notifyEnd = false;
+        bool active = false;
+    };
+    
+    std::vector<Voice> voices;
+    AudioBusGraph buses;
+    std::vector<float> accumulator;   // Master mix before conversion, maxFrames * CHANNELS
+    std::vector<float> scratch;       // Pitched voice frames, maxFrames * CHANNELS
+    size_t maxFrames;
+    size_t activeVoices;
+    size_t virtualVoices;
+    uint32_t startCounter;
+    uint64_t stolenVoices;
+    uint64_t rejectedVoices;
+    uint64_t streamUnderruns;   // Chunks where a started stream had no block ready
+    VoiceEndCallback endCallback;
+    void* endUserdata;
+    
+    void release(Voice& voice);
+    
+    // Per-side gains for the voice's gain, attenuation and pan
+    static AudioKernels::StereoGain targetGain(const Voice& voice);
+    static bool isAudible(const AudioKernels::StereoGain& gain) {
+        return std::max(gain.left, gain.right) > AUDIBLE_GAIN;
+    }
+    
+    // Playback rate: the pitch, or exactly 1 within PITCH_EPSILON
+    static float playbackRate(const Voice& voice) {
+        return std::abs(voice.pitch - 1.0f) > PITCH_EPSILON ? voice.pitch : 1.0f;
+    }
+    
+    // Virtual voice: advance by frames without mixing
+    void skipVoice(Voice& voice, size_t frames);
+    
+    // Linearly interpolate up to frames frames at the voice's pitch into output; returns the count.
+    // Runs that stay clear of the loop point go through AudioKernels::resampleLinear
+    size_t resampleVoice(Voice& voice, float* output, size_t frames);
+    
+    // Add up to frames of the voice into its bus; ends the voice at its last frame
+    void mixVoice(Voice& voice, size_t frames);
+};
+
+#endif // AUDIO_MIXER_HPP
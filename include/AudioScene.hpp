@@ -0,0 +1,16 @@
+#ifndef AUDIO_SCENE_HPP
+#define AUDIO_SCENE_HPP
+
+#include <ostream>
+#include <string>
+
+// Scripted audio scene for headless regression runs (audio_render, Main --render-audio).
+// Needs SDL only for WAV loading: no window, GL context or audio device.
+namespace AudioScene {
+    // Play the scene through the offline backend into a WAV file and report callback timing.
+    // Sounds are read from assets/audio. Returns false if the scene could not be set up or
+    // any callback took longer than its buffer plays.
+    bool render(const std::string& assets, const std::string& outputPath, double seconds, std::ostream& out);
+}
+
+#endif // AUDIO_SCENE_HPP
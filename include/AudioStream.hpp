@@ -0,0 +1,129 @@
+#ifndef AUDIO_STREAM_HPP
+#define AUDIO_STREAM_HPP
+
+#include "AudioKernels.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A long sound (music, ambience) played from disk instead of being loaded whole.
+// The streaming thread opens the WAV file, decodes and resamples it into a double-buffered
+// ring of fixed blocks; the mixer reads the ring from the audio callback. Memory per stream
+// is constant whatever the file's length.
+class AudioStream {
+public:
+    static const size_t BLOCK_FRAMES = 8192;    // Output frames per block (~186 ms at 44.1 kHz)
+    static const int BLOCK_COUNT = 2;
+    
+    AudioStream(const std::string& filepath, int outputRate, bool looping);
+    
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+    
+    // Streaming thread: read the header; a file that fails to open ends the stream
+    void open();
+    bool isOpen() const { return opened; }
+    
+    // Streaming thread: decode into every free block
+    void fill();
+    
+    // Audio thread: frames ready in the current block, 0 while it is still being filled
+    size_t peek(const float*& samples);
+    void consume(size_t frames);
+    
+    // Audio thread: 1 or 2, valid once peek has returned frames
+    int getChannels() const { return channels; }
+    
+    // Audio thread: the last block has been played
+    bool isFinished() const { return finished; }
+    
+    // Any thread: nothing will read the stream again; the streaming thread deletes it
+    void release() { released.store(true, std::memory_order_release); }
+    bool isReleased() const { return released.load(std::memory_order_acquire); }
+
+private:
+    struct Block {
+        std::vector<float> samples;     // BLOCK_FRAMES interleaved frames
+        size_t frames = 0;
+        bool last = false;              // End of a non-looping stream
+        std::atomic<bool> ready{ false };   // Set by the streaming thread, cleared by the audio thread
+    };
+    
+    // Streaming thread only
+    std::string filepath;
+    int outputRate;
+    bool looping;
+    bool opened;
+    bool ended;                         // The last block has been written
+    std::ifstream file;
+    uint64_t dataStart;                 // File offset of the sample data
+    uint64_t dataSize;
+    uint64_t dataRead;
+    int fileChannels;
+    int bytesPerSample;
+    bool floatSamples;
+    int writeBlock;
+    std::unique_ptr<AudioKernels::Resampler> resampler;
+    bool flushed;
+    std::vector<char> raw;              // Scratch buffers, reused for every read
+    std::vector<float> decoded;
+    std::vector<float> converted;       // Resampled frames waiting for a free block
+    size_t convertedOffset;
+    
+    // Written once by open() before the first block is published
+    int channels;
+    
+    // Audio thread only
+    int readBlock;
+    size_t readOffset;
+    bool finished;
+    
+    std::atomic<bool> released;
+    Block blocks[BLOCK_COUNT];
+    
+    // Read, decode and resample the next piece of the file into converted; false at the end
+    bool decodeNext();
+    void publishEmpty();
+};
+
+// Owns every stream and the thread that opens and refills them.
+// Streams are deleted on that thread once released.
+class AudioStreamer {
+public:
+    AudioStreamer();
+    ~AudioStreamer();
+    
+    AudioStreamer(const AudioStreamer&) = delete;
+    AudioStreamer& operator=(const AudioStreamer&) = delete;
+    
+    // Game thread: take ownership; the stream is opened and prefilled on the streaming thread
+    void add(AudioStream* stream);
+    
+    // Wait for a full pass that starts after this call: every stream added so far is open
+    // and its free blocks are filled. The offline backend calls it before each callback
+    // so streams play without underruns however fast it renders.
+    void sync();
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable passCondition;
+    std::vector<std::unique_ptr<AudioStream>> incoming;    // Guarded by mutex
+    std::vector<std::unique_ptr<AudioStream>> streams;     // Streaming thread only
+    bool stopping;
+    bool syncRequested;                 // Guarded by mutex, as are the pass counters
+    uint64_t passesStarted;
+    uint64_t passesDone;
+    
+    void threadLoop();
+};
+
+#endif // AUDIO_STREAM_HPP
@@ -0,0 +1,74 @@
+#ifndef BENCHMARK_SUITE_HPP
+#define BENCHMARK_SUITE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Keep a value (and everything it depends on) from being optimized away
+template <typename T>
+inline void benchmarkKeep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Small in-tree benchmark runner. Each case is a function that runs its body a given
+// number of times; the runner grows that count until one run lasts minSeconds / repetitions,
+// then times repetitions runs and keeps per-iteration statistics across them.
+class BenchmarkSuite {
+public:
+    struct Settings {
+        double minSeconds = 0.25;       // Per case, over all repetitions
+        int repetitions = 5;
+        std::string filter;             // Run only cases whose name contains this
+    };
+    
+    struct Result {
+        std::string name;
+        size_t iterations = 0;          // Per repetition
+        size_t itemsPerIteration = 1;
+        double medianNs = 0.0;          // Per iteration
+        double meanNs = 0.0;
+        double minNs = 0.0;
+        double stddevNs = 0.0;
+        
+        double getItemsPerSecond() const { return medianNs > 0.0 ? itemsPerIteration * 1.0e9 / medianNs : 0.0; }
+    };
+    
+    using Body = std::function<void(size_t iterations)>;
+    
+    // Each case's median is written to progress as it finishes
+    BenchmarkSuite(const Settings& settings, std::ostream& progress);
+    
+    // Describe the run in the JSON context (build type, SIMD path...)
+    void addContext(const std::string& key, const std::string& value);
+    
+    // Whether a case would run (skip its setup otherwise)
+    bool isSelected(const std::string& name) const;
+    
+    // Time body; items is the work one iteration does (objects, pairs, frames...)
+    void run(const std::string& name, size_t items, const Body& body);
+    
+    const std::vector<Result>& getResults() const { return results; }
+    
+    // One line per case: median, min and mean time per iteration and throughput
+    void print(std::ostream& out) const;
+    
+    // Google Benchmark-style JSON ("context" plus a "benchmarks" array, times in ns)
+    bool writeJson(const std::string& path) const;
+
+private:
+    Settings settings;
+    std::ostream& progress;
+    std::vector<std::pair<std::string, std::string>> context;
+    std::vector<Result> results;
+};
+
+#endif // BENCHMARK_SUITE_HPP
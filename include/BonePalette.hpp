@@ -0,0 +1,44 @@
+#ifndef BONE_PALETTE_HPP
+#define BONE_PALETTE_HPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+// Per-frame bone matrix palette shared by every skinned instance.
+// Instances append their matrices during the frame and receive an offset;
+// the whole palette is then uploaded with a single buffer update and read
+// in the vertex shader through a texture buffer (samplerBuffer).
+class BonePalette {
+private:
+    GLuint buffer;                      // GL_TEXTURE_BUFFER storage
+    GLuint texture;                     // Buffer texture view (RGBA32F, 4 texels per matrix)
+    size_t capacity;                    // Matrices the GPU buffer can hold
+    std::vector<glm::mat4> matrices;    // CPU staging for the current frame
+    
+public:
+    BonePalette(size_t initialCapacity = 256);
+    ~BonePalette();
+    
+    // Owns GL objects, so copying is not allowed
+    BonePalette(const BonePalette&) = delete;
+    BonePalette& operator=(const BonePalette&) = delete;
+    
+    // Start a new frame (discards last frame's matrices)
+    void beginFrame();
+    
+    // Append an instance's bone matrices; returns its first matrix index in the palette
+    int allocate(const std::vector<glm::mat4>& boneMatrices);
+    
+    // Upload every matrix appended this frame in one range update
+    void upload();
+    
+    // Bind the palette texture to a texture unit
+    void bind(GLuint textureUnit) const;
+    
+    // Number of matrices appended this frame
+    size_t getMatrixCount() const { return matrices.size(); }
+};
+
+#endif // BONE_PALETTE_HPP
@@ -46,11 +46,15 @@ private:
     // Sound system reference
     SoundSystem& soundSystem;
     
-    // Sound indices
-    int paddleHitSound;
-    int brickHitSound;
-    int wallHitSound;
-    int loseLifeSound;
+    // Short sounds, from the sound bank when it has been built
+    static constexpr const char* SOUND_BANK = "../audio/sounds.sbank";
+    SoundID paddleHitSound = SoundID::fromName("paddle_hit");
+    SoundID brickHitSound = SoundID::fromName("brick_hit");
+    SoundID wallHitSound = SoundID::fromName("wall_hit");
+    
+    // Long sounds, streamed from disk when played
+    static constexpr const char* LOSE_LIFE_STREAM = "../audio/lose_life.wav";
+    static constexpr const char* WIN_GAME_STREAM = "../audio/win_game.wav";
     
     // Game boundaries
     float leftBoundary;
@@ -61,7 +65,7 @@ private:
     // Create game objects
     void createBricks(int rows, int cols, float width, float height, float spacing);
     void resetBall();
-    
+
 public:
     Breakout(SoundSystem& soundSystem, float left, float right, float top, float bottom);
     ~Breakout();
@@ -88,7 +92,7 @@ private:
     float width;
     float height;
     float speed;
-    
+
 public:
     Paddle(const glm::vec3& pos, float width, float height, const Shape& shape, int id);
     
@@ -118,7 +122,7 @@ private:
     float radius;
     glm::vec3 velocity;
     bool stuck;  // If true, ball follows paddle before launch
-    
+
 public:
     Ball(const glm::vec3& pos, float radius, const Shape& shape, int id);
     
@@ -152,7 +156,7 @@ private:
     bool destroyed;
     int hitPoints;
     int scoreValue;
-    
+
 public:
     Brick(const glm::vec3& pos, float width, float height, int hitPoints, int scoreValue, const Shape& shape, int id);
     
@@ -0,0 +1,83 @@
+#ifndef COMPRESSED_ANIMATION_HPP
+#define COMPRESSED_ANIMATION_HPP
+
+#include "Animations.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Quaternion packed into 48 bits with smallest-three encoding:
+// 2 bits for the index of the largest component, 15 bits for each of the other three.
+struct PackedQuaternion {
+    uint16_t bits[3];
+    
+    static PackedQuaternion pack(const Quaternion& q);
+    Quaternion unpack() const;
+};
+
+// Settings for Animation -> CompressedAnimation conversion
+struct AnimationCompressionSettings {
+    float maxErrorDegrees = 0.5f;   // Keys are dropped while reconstruction stays within this angle
+};
+
+// What the converter did and how much error it introduced
+struct AnimationCompressionStats {
+    size_t sourceKeys = 0;
+    size_t storedKeys = 0;
+    size_t constantTracks = 0;
+    size_t sourceBytes = 0;
+    size_t compressedBytes = 0;
+    float maxErrorDegrees = 0.0f;   // Worst angular error over a dense resample of the clip
+    float meanErrorDegrees = 0.0f;
+    
+    void print(std::ostream& out) const;
+};
+
+// Compressed clip: quantized rotations, 16-bit normalized key times,
+// constant tracks collapsed to one key, redundant keys removed.
+// All tracks share flat key arrays so sampling stays in a few cache lines.
+class CompressedAnimation : public AnimationClip {
+public:
+    struct Track {
+        int32_t boneID;
+        uint32_t firstKey;   // Index into keyTimes / keyRotations
+        uint32_t keyCount;   // 1 for constant tracks
+    };
+    
+    CompressedAnimation();
+    
+    // Build from a loaded animation
+    static CompressedAnimation compress(const Animation& source,
+                                        const AnimationCompressionSettings& settings = AnimationCompressionSettings(),
+                                        AnimationCompressionStats* stats = nullptr);
+    
+    // Binary .canim file
+    bool saveToFile(const std::string& filename) const;
+    static bool loadFromFile(const std::string& filename, CompressedAnimation& animation);
+    
+    // Sample every track into a prepared pose buffer; never touches the heap
+    void sample(float time, AnimationPose& pose, Cursor* cursor = nullptr) const override;
+    void gatherKeys(float time, Cursor* cursor, PoseKeyBatch& batch) const override;
+    
+    size_t getTrackCount() const override { return tracks.size(); }
+    
+    // Bytes used by tracks and keys
+    size_t getMemoryUsage() const;
+    
+    // Bytes used by the same data in an uncompressed Animation
+    static size_t getMemoryUsage(const Animation& animation);
+
+private:
+    std::vector<Track> tracks;                // Sorted by bone ID
+    std::vector<uint16_t> keyTimes;           // Time / duration * 65535
+    std::vector<PackedQuaternion> keyRotations;
+    
+    float keyTime(uint32_t key) const;
+    
+    // Find the bracketing keys of every track and pass them to visit(bone, q1, q2, alpha)
+    template <typename Visitor>
+    void visitKeys(float time, Cursor* cursor, Visitor&& visit) const;
+};
+
+#endif // COMPRESSED_ANIMATION_HPP
@@ -0,0 +1,95 @@
+#ifndef CPU_SKINNER_HPP
+#define CPU_SKINNER_HPP
+
+#include "Shape.hpp"
+#include "AABB.hpp"
+#include "JobSystem.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Linear-blend skinning on the CPU.
+// Used for headless runs, collision against deformed meshes and hardware
+// without shader skinning; needs no GL (ShapeGpu::uploadSkinned feeds the
+// result to a VBO). Bind-pose data is kept as SoA streams; the blend
+// kernel is SSE/AVX when the compiler targets them and scalar otherwise,
+// and large meshes are split into chunks across a JobSystem's workers.
+class CpuSkinner {
+public:
+    enum class Kernel {
+        Scalar,
+        SIMD
+    };
+
+private:
+    size_t vertexCount;
+    size_t boneCount;
+    JobSystem* jobSystem;
+    
+    // Bind-pose SoA streams
+    std::vector<float> bindPX, bindPY, bindPZ;
+    std::vector<float> bindNX, bindNY, bindNZ;
+    
+    // 4 influences per vertex; index boneCount is the fallback (model matrix) slot
+    std::vector<uint16_t> boneIndices;
+    std::vector<float> boneWeights;
+    
+    // Skinned SoA output (world space, like the GPU path)
+    std::vector<float> outPX, outPY, outPZ;
+    std::vector<float> outNX, outNY, outNZ;
+    AABB bounds;
+    
+    // Scratch reused between frames
+    std::vector<glm::mat4> palette;     // Bone matrices + fallback matrix
+    std::vector<AABB> chunkBounds;      // Bounds per worker chunk
+    std::vector<float> vertexData;      // AoS staging for the VBO upload
+    
+    void initStreams(const std::vector<glm::vec3>& positions,
+                     const std::vector<glm::vec3>& normals,
+                     const std::vector<VertexBoneData>& vertexBoneData);
+    
+    void skinRangeScalar(size_t begin, size_t end, AABB& rangeBounds);
+    void skinRangeSIMD(size_t begin, size_t end, AABB& rangeBounds);
+
+public:
+    // Build streams from an armature shape. Large meshes are skinned in parallel when a
+    // job system is given, serially otherwise
+    CpuSkinner(const Shape& shape, JobSystem* jobSystem = nullptr);
+    
+    // Build streams from raw vertex data (no GL needed)
+    CpuSkinner(const std::vector<glm::vec3>& positions,
+               const std::vector<glm::vec3>& normals,
+               const std::vector<VertexBoneData>& vertexBoneData,
+               size_t boneCount,
+               JobSystem* jobSystem = nullptr);
+    
+    // Skin every vertex; vertices without weights use modelMatrix
+    bool skin(const std::vector<glm::mat4>& boneMatrices, const glm::mat4& modelMatrix,
+              Kernel kernel = Kernel::SIMD);
+    
+    // Skinned positions and normals in the Shape VBO layout: all positions, then all
+    // normals (render with hasArmature off). Rebuilt on every call
+    const std::vector<float>& packVertexData();
+    
+    // World-space bounds of the last skin() call
+    const AABB& getBounds() const { return bounds; }
+    
+    size_t getVertexCount() const { return vertexCount; }
+    unsigned getThreadCount() const { return jobSystem ? jobSystem->getWorkerCount() + 1 : 1; }
+    glm::vec3 getPosition(size_t i) const { return glm::vec3(outPX[i], outPY[i], outPZ[i]); }
+    glm::vec3 getNormal(size_t i) const { return glm::vec3(outNX[i], outNY[i], outNZ[i]); }
+    
+    // Name of the compiled-in SIMD path ("AVX", "SSE" or "scalar")
+    static const char* simdPathName();
+    
+    // Time scalar vs SIMD, single vs multi-threaded, and print vertices/sec
+    static void runBenchmark(const std::vector<glm::vec3>& positions,
+                             const std::vector<glm::vec3>& normals,
+                             const std::vector<VertexBoneData>& vertexBoneData,
+                             const std::vector<glm::mat4>& boneMatrices,
+                             int iterations,
+                             std::ostream& out);
+};
+
+#endif // CPU_SKINNER_HPP
@@ -3,6 +3,7 @@
 
 #include "Framebuffer.hpp"
 #include "Shader.hpp"
+#include "BonePalette.hpp"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <string>
@@ -10,12 +11,15 @@
 
 class DeferredRenderer {
 private:
+    GBufferLayout layout;      // Attachment layout of the G-Buffer
     Framebuffer gBuffer;       // G-Buffer for deferred rendering
     GLuint quadVAO;            // VAO for screen-space quad
     Shader geometryShader;     // Shader for geometry pass
     Shader lightingShader;     // Shader for lighting pass - renamed from 'lightingPass'
     int screenWidth;           // Screen width
     int screenHeight;          // Screen height
+    glm::mat4 viewMatrix;      // Last view matrix (for position reconstruction)
+    glm::mat4 projMatrix;      // Last projection matrix (for position reconstruction)
     
     // Helper function to create a screen quad
     GLuint createScreenQuad();
@@ -24,7 +28,8 @@ public:
     // Constructor: Create deferred rendering system with shaders
     DeferredRenderer(int width, int height, 
                      const std::string& geoVertPath, const std::string& geoFragPath,
-                     const std::string& lightVertPath, const std::string& lightFragPath);
+                     const std::string& lightVertPath, const std::string& lightFragPath,
+                     GBufferLayout layout = GBufferLayout::Full);
     
     // Destructor
     ~DeferredRenderer();
@@ -44,6 +49,9 @@ public:
     // Set bone matrices for skeletal animation
     void setBoneMatrices(const std::vector<glm::mat4>& boneMatrices, bool hasArmature);
     
+    // Skin from a shared bone palette: boneCount matrices starting at boneOffset
+    void setBonePalette(const BonePalette& palette, int boneOffset, int boneCount);
+    
     // Render a specific G-Buffer texture to the screen
     void renderGBufferTexture(int textureIndex);
     
@@ -52,6 +60,9 @@ public:
     
     // Get the lighting pass shader
     Shader& getLightingShader();
+    
+    // Get the G-Buffer attachment layout
+    GBufferLayout getLayout() const { return layout; }
 };
 
 #endif // DEFERRED_RENDERER_HPP
\ No newline at end of file
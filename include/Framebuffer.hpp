@@ -1,58 +1,40 @@
 #ifndef FRAMEBUFFER_HPP
 #define FRAMEBUFFER_HPP
 
+#include "TextureProperties.hpp"
 #include <GL/glew.h>
 #include <vector>
 #include <stdexcept>
 #include <iostream>
 
-// Structure to define texture properties for FBO attachments
-struct TextureProperties {
-    // Format of the internal texture (e.g., GL_RGBA, GL_RGB16F, etc.)
-    GLenum internalFormat = GL_RGBA;
-    
-    // Format and type of the pixel data (used when creating the texture)
-    GLenum format = GL_RGBA;
-    GLenum type = GL_UNSIGNED_BYTE;
-    
-    // Texture filtering parameters
-    GLenum minFilter = GL_LINEAR;
-    GLenum magFilter = GL_LINEAR;
-    
-    // Texture wrapping parameters
-    GLenum wrapS = GL_CLAMP_TO_EDGE;
-    GLenum wrapT = GL_CLAMP_TO_EDGE;
-    
-    // Constructor with commonly used parameters
-    TextureProperties(
-        GLenum internalFormat = GL_RGBA,
-        GLenum format = GL_RGBA,
-        GLenum type = GL_UNSIGNED_BYTE,
-        GLenum minFilter = GL_LINEAR,
-        GLenum magFilter = GL_LINEAR
-    ) : internalFormat(internalFormat), 
-        format(format), 
-        type(type), 
-        minFilter(minFilter), 
-        magFilter(magFilter) {}
-};
+// TextureProperties spells its defaults as plain values so it builds without GL
+static_assert(TextureProperties::DEFAULT_FORMAT == GL_RGBA && TextureProperties::DEFAULT_TYPE == GL_UNSIGNED_BYTE &&
+              TextureProperties::DEFAULT_FILTER == GL_LINEAR && TextureProperties::DEFAULT_WRAP == GL_CLAMP_TO_EDGE,
+              "TextureProperties defaults must match the GL enums");
 
 class Framebuffer {
 private:
     GLuint fbo;                  // Framebuffer object ID
     std::vector<GLuint> tex;     // Texture attachments
     GLuint rbo;                  // Renderbuffer object for depth/stencil
+    GLuint depthTex;             // Depth/stencil texture (when depth must be sampled)
     int resX;                    // Width of the framebuffer
     int resY;                    // Height of the framebuffer
     bool hasDepthStencil;        // Whether this FBO has a depth/stencil attachment
 
 public:
     // Constructor - creates FBO with specified resolution and texture properties
-    Framebuffer(int width, int height, const std::vector<TextureProperties>& textureProps = {}, bool createDepthStencil = true);
+    // If sampleableDepth is set, depth/stencil is stored in a texture instead of a renderbuffer
+    Framebuffer(int width, int height, const std::vector<TextureProperties>& textureProps = {}, bool createDepthStencil = true,
+                bool sampleableDepth = false);
     
     // Destructor - cleans up OpenGL resources
     ~Framebuffer();
     
+    // Owns GL objects, so copying is not allowed
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+    
     // Get the FBO ID
     GLuint getFBO() const;
     
@@ -68,6 +50,9 @@ public:
     // Get number of texture attachments
     size_t getTextureCount() const;
     
+    // Get depth texture ID (0 if depth lives in a renderbuffer)
+    GLuint getDepthTexture() const { return depthTex; }
+    
     // Get resolution
     int getWidth() const { return resX; }
     int getHeight() const { return resY; }
@@ -3,12 +3,16 @@
 #include "Quaternion.hpp"
 #include "Shape.hpp"
 #include "AABB.hpp"
+#include "Skeleton.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <functional>
 #include <typeinfo>
 #include <string>
 #include <map>
+#include <vector>
+#include <cstdint>
+#include <memory>
 
 // Macro for derived classes to declare their type ID
 #define DECLARE_GAMEOBJECT_TYPE() \
@@ -88,8 +92,8 @@ public:
     }
     
     // Rendering methods
-    GLuint getVAO() const { return renderElementShape.getVAO(); }
-    GLuint getVBO() const { return renderElementShape.getVBO(); }
+    unsigned int getVAO() const { return renderElementShape.getVAO(); }
+    unsigned int getVBO() const { return renderElementShape.getVBO(); }
     int getVertexCount() const { return renderElementShape.getVertexCount(); }
     const glm::mat4& getModelMatrix() const { return modelMatrix; }
     
@@ -107,6 +111,7 @@ public:
     void markBoundsDirty() { boundsDirty = true; }
     const AABB& getBoundingBox();
     void updateBoundingBox();
+    void setSkinnedBounds(const AABB& skinnedBounds);  // Bounds from a skinned pose (e.g. CpuSkinner)
     
     // Type identification for collision detection
     virtual int getTypeId() const { return -1; }
@@ -116,31 +121,34 @@ public:
     }
 
     // Animation-related methods
-    void initBoneData();
+    void initBoneData();  // Use the shape's skeleton, if it has one, at bind pose
+    void setSkeleton(std::shared_ptr<const Skeleton> skeleton);
+    const Skeleton* getSkeleton() const { return skeleton.get(); }
     void updateBoneRotations(const std::map<int, Quaternion>& rotations);
-    void updateBoneTransforms();
+    void updateBoneRotations(const std::vector<Quaternion>& rotations, const std::vector<uint8_t>& animated);  // Dense pose, indexed by bone
+    void updateBoneTransforms();  // Re-pose the hierarchy, then rebuild world matrices
     const std::vector<glm::mat4>& getBoneMatrices() const { return boneMatrices; }
-    bool hasAnimatableSkeleton() const { return hasArmature && !boneTransforms.empty(); }
-
-    // Bone data structure
-    struct BoneTransform {
-        Quaternion initialRotation;   // Initial bind pose rotation
-        Quaternion currentRotation;   // Current animation rotation
-        glm::vec3 localPosition;      // Position in local space
-        int parentIndex;              // Index of parent bone (-1 for root)
-        glm::mat4 offsetMatrix;       // Transform from bind pose
-        glm::mat4 finalTransform;     // Final world space transform
-    };
+    const std::vector<Quaternion>& getBoneRotations() const { return boneRotations; }
+    const std::vector<Skeleton::Affine>& getBoneModelSpace() const { return boneModelSpace; }
+    bool hasAnimatableSkeleton() const { return hasArmature && skeleton && !boneRotations.empty(); }
+    size_t getBoneCount() const { return boneRotations.size(); }
+    int getBoneParent(size_t bone) const { return skeleton ? skeleton->getParent(bone) : -1; }
 
 protected:
     // Animation-related members
-    std::vector<BoneTransform> boneTransforms;
-    std::vector<glm::mat4> boneMatrices;  // Final matrices sent to shader
+    std::shared_ptr<const Skeleton> skeleton;
+    std::vector<Quaternion> boneRotations;         // Local rotation per bone
+    std::vector<Skeleton::Affine> boneModelSpace;  // Bone transforms in model space
+    std::vector<Skeleton::Affine> boneSkinning;    // Model-space skinning transforms (modelSpace * inverseBind)
+    std::vector<glm::mat4> boneMatrices;           // World-space skinning matrices sent to the shader
     bool hasArmature;
     
 private:
     // Helper to update the model matrix when position, rotation, or scale changes
     void updateModelMatrix();
+    
+    // Rebuild world-space bone matrices only (the pose is unchanged)
+    void updateBoneWorldMatrices();
 };
 
 // Helper function for type identification
@@ -0,0 +1,51 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads for data-parallel loops.
+// parallelFor blocks until every chunk has run; the calling thread helps.
+class JobSystem {
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;   // Workers wait here for a new job
+    std::condition_variable doneCondition;   // parallelFor waits here for workers
+    
+    // Current job (valid while busyWorkers > 0 or the caller is running chunks)
+    const RangeFunction* job;
+    size_t jobCount;
+    size_t jobGrain;
+    std::atomic<size_t> nextIndex;
+    size_t busyWorkers;
+    uint64_t generation;
+    bool stopping;
+    
+    void workerLoop();
+    void runChunks();
+
+public:
+    // threadCount 0 = one worker per hardware thread, minus the caller
+    explicit JobSystem(unsigned threadCount = 0);
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // Run func over [0, count) in chunks of at most grain items
+    void parallelFor(size_t count, size_t grain, const RangeFunction& func);
+    
+    unsigned getWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+};
+
+#endif // JOB_SYSTEM_HPP
@@ -0,0 +1,104 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Build with ENGINE_PROFILER=0 to compile every zone out
+#ifndef ENGINE_PROFILER
+#define ENGINE_PROFILER 1
+#endif
+
+// Hierarchical CPU profiler. Each thread records the zones it closes into its own ring
+// (no locks; the ring is allocated the first time the thread records), so recent frames can
+// be inspected or exported while the engine keeps running. Zones nest by scope; the frame
+// thread marks frame boundaries with beginFrame(). Real-time threads claim a ring reserved
+// for them up front instead, so they never lock or allocate.
+namespace Profiler {
+    // Nanoseconds on the profiler clock (steady, since the first call)
+    uint64_t now();
+    
+    // Zones are recorded only while enabled (the default); disabled zones cost one load
+    void setEnabled(bool enabled);
+    bool isEnabled();
+    
+    // Name the calling thread in traces ("Main", "Audio", ...); the first name given sticks
+    void setThreadName(const char* name);
+    
+    // Allocate rings for threads that must not lock or allocate (the audio device's thread).
+    // Call before starting them; at most MAX_REALTIME_THREADS are ever reserved.
+    static constexpr size_t MAX_REALTIME_THREADS = 8;
+    void reserveRealtimeThreads(size_t count);
+    
+    // From a real-time thread, instead of setThreadName: take a reserved ring without locking.
+    // If none is left the thread's zones are dropped. Threads that already have a ring keep it.
+    void claimRealtimeThread(const char* name);
+    
+    // Frame thread: start a new frame. The last FRAME_HISTORY frames are kept.
+    static constexpr size_t FRAME_HISTORY = 240;
+    void beginFrame();
+    
+    // Called by ProfileZone; name must outlive the profiler (a literal or __func__)
+    void recordZone(const char* name, uint64_t startNanos, uint64_t endNanos, uint32_t depth);
+    
+    // Write the retained frames as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev).
+    // Call from the frame thread.
+    bool exportChromeTrace(const std::string& path);
+    
+    // Print the zones of the last complete frame, indented by nesting, per thread.
+    // Call from the frame thread.
+    void printLastFrame(std::ostream& out);
+    
+    // Nesting depth of the calling thread's open zones
+    uint32_t& threadDepth();
+}
+
+// Times its scope as a zone of the calling thread
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(Profiler::isEnabled() ? name : nullptr) {
+        if (this->name) {
+            depth = Profiler::threadDepth()++;
+            start = Profiler::now();
+        }
+    }
+    
+    ~ProfileZone() {
+        if (name) {
+            const uint64_t end = Profiler::now();
+            Profiler::threadDepth()--;
+            Profiler::recordZone(name, start, end, depth);
+        }
+    }
+    
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t start = 0;
+    uint32_t depth = 0;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENGINE_PROFILER
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_FRAME() Profiler::beginFrame()
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_RESERVE_REALTIME_THREADS(count) Profiler::reserveRealtimeThreads(count)
+#define PROFILE_REALTIME_THREAD(name) Profiler::claimRealtimeThread(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_RESERVE_REALTIME_THREADS(count) ((void)0)
+#define PROFILE_REALTIME_THREAD(name) ((void)0)
+#endif
+
+#endif // PROFILER_HPP
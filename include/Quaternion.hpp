@@ -18,6 +18,10 @@ public:
     // Constructor from w, x, y, z components
     Quaternion(float w, float x, float y, float z);
     
+    // Fast path for components that are already unit length (no normalize)
+    struct Unnormalized {};
+    Quaternion(float w, float x, float y, float z, Unnormalized) : w(w), x(x), y(y), z(z) {}
+    
     // Constructor from angle (in degrees) and axis
     Quaternion(float angle, glm::vec3 axis);
     
@@ -44,6 +48,7 @@ public:
     
     // Convert to matrix
     glm::mat4 toMatrix() const;
+    glm::mat3 toMatrix3() const;  // Rotation part only, same convention as toMatrix
     
     // Get angle and axis
     float getAngle() const;
@@ -0,0 +1,57 @@
+#ifndef QUATERNION_MATH_HPP
+#define QUATERNION_MATH_HPP
+
+#include "Quaternion.hpp"
+#include <cstddef>
+#include <ostream>
+
+// Quaternion interpolation kernels.
+// All functions expect unit-length inputs and skip the renormalization of inputs
+// that Quaternion's constructor would do. Batch variants work on SoA streams and
+// run 8 lanes with AVX, 4 with SSE, and fall back to scalar code otherwise.
+namespace QuaternionMath {
+    enum class InterpolationMode {
+        Slerp,          // Exact: acos + sin per call
+        Nlerp,          // Normalized lerp: fastest, angular error grows with the key distance
+        ApproxSlerp     // Nlerp with a polynomial correction of t: within ~0.04 degrees of slerp
+    };
+    
+    // SoA quaternion streams (count elements each)
+    struct ConstStream {
+        const float* w;
+        const float* x;
+        const float* y;
+        const float* z;
+    };
+    
+    struct Stream {
+        float* w;
+        float* x;
+        float* y;
+        float* z;
+    };
+    
+    const char* modeName(InterpolationMode mode);
+    
+    float dot(const Quaternion& a, const Quaternion& b);
+    
+    // Shortest-path interpolation between unit quaternions
+    Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
+    Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t);
+    Quaternion approxSlerp(const Quaternion& a, const Quaternion& b, float t);
+    Quaternion interpolate(InterpolationMode mode, const Quaternion& a, const Quaternion& b, float t);
+    
+    // out[i] = interpolate(a[i], b[i], t[i]); out may alias a or b.
+    // maxLanes limits the SIMD width (1, 4 or 8) for benchmarking; Slerp is always scalar.
+    void interpolateBatch(InterpolationMode mode, size_t count,
+                          const ConstStream& a, const ConstStream& b, const float* t,
+                          const Stream& out, unsigned maxLanes = 8);
+    
+    // Widest batch path compiled in ("AVX", "SSE" or "scalar")
+    const char* simdPathName();
+    
+    // Time every mode at every batch width and print throughput and max angular error vs slerp
+    void runBenchmark(size_t count, int iterations, std::ostream& out);
+}
+
+#endif // QUATERNION_MATH_HPP
@@ -0,0 +1,133 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include "RenderTargetDesc.hpp"
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Framebuffer;
+class RenderTargetPool;
+
+// Small frame graph: passes declare which named resources they read and
+// write, compile() orders them, culls passes whose output is never used and
+// works out resource lifetimes/aliasing. compile() needs neither GL nor a
+// context (engine_bench checks schedules headlessly); execute(), defined with
+// the renderer in RenderGraphExecute.cpp, runs the passes with transient
+// targets taken from a RenderTargetPool.
+class RenderGraph {
+public:
+    using ExecuteFunction = std::function<void(RenderGraph&)>;
+    
+    // Per-pass declaration, returned from addPass for chaining
+    class PassBuilder {
+    private:
+        RenderGraph& graph;
+        int passIndex;
+        
+    public:
+        PassBuilder(RenderGraph& graph, int passIndex) : graph(graph), passIndex(passIndex) {}
+        
+        // Declare a resource read by this pass
+        PassBuilder& read(const std::string& resourceName);
+        
+        // Declare a resource written by this pass
+        PassBuilder& write(const std::string& resourceName);
+        
+        // Keep this pass even if nothing reads its outputs
+        PassBuilder& sideEffects();
+    };
+    
+    RenderGraph();
+    
+    // Declare a transient render target owned by the graph
+    void createResource(const std::string& name, const RenderTargetDesc& desc);
+    
+    // Declare an external resource (e.g. the default framebuffer); writes to it are graph outputs
+    void importResource(const std::string& name, Framebuffer* framebuffer = nullptr);
+    
+    // Add a pass; passes are executed in dependency order, not declaration order
+    PassBuilder addPass(const std::string& name, ExecuteFunction execute);
+    
+    // Enable or disable a pass (disabled passes are culled with everything only they need)
+    void setPassEnabled(const std::string& name, bool enabled);
+    
+    // Sort, cull and compute resource lifetimes. Returns false on errors (cycles, unknown resources)
+    bool compile();
+    
+    // Run the compiled passes, acquiring and releasing transient targets from the pool
+    void execute(RenderTargetPool& pool);
+    
+    // Framebuffer bound to a resource during execute (nullptr for the default framebuffer)
+    Framebuffer* getFramebuffer(const std::string& resourceName) const;
+    
+    // Compiled schedule, as pass names in execution order
+    std::vector<std::string> getExecutionOrder() const;
+    
+    // Whether a pass survived culling in the last compile
+    bool isPassActive(const std::string& name) const;
+    
+    // Physical target slot assigned to a transient resource (-1 if unused or imported).
+    // Resources sharing a slot alias the same memory.
+    int getPhysicalSlot(const std::string& resourceName) const;
+    
+    // Number of distinct physical targets the compiled graph needs
+    int getPhysicalTargetCount() const { return physicalTargetCount; }
+    
+    // Print the compiled schedule and lifetimes
+    void dumpSchedule(std::ostream& out) const;
+    
+private:
+    struct Resource {
+        std::string name;
+        RenderTargetDesc desc;
+        bool imported;
+        Framebuffer* external;       // Imported framebuffer (nullptr = default framebuffer)
+        std::vector<int> writers;    // Passes writing this resource, in declaration order
+        std::vector<int> readers;    // Passes reading this resource
+        int firstUse;                // Position in execution order of first use (-1 = unused)
+        int lastUse;                 // Position in execution order of last use
+        int physicalSlot;            // Aliasing slot (-1 for imported or unused)
+    };
+    
+    struct Pass {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<std::string> readNames;   // As declared (resources may be added later)
+        std::vector<std::string> writeNames;
+        std::vector<int> reads;               // Resolved by compile()
+        std::vector<int> writes;
+        bool enabled;
+        bool hasSideEffects;
+        bool active;                 // Survived culling
+    };
+    
+    struct PhysicalTarget {
+        RenderTargetDesc desc;
+        int firstUse;
+        int lastUse;
+        Framebuffer* framebuffer;    // Valid only during execute
+    };
+    
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::unordered_map<std::string, int> resourceLookup;
+    std::unordered_map<std::string, int> passLookup;
+    
+    // Compiled state
+    std::vector<int> executionOrder;
+    std::vector<PhysicalTarget> physicalTargets;
+    int physicalTargetCount;
+    bool compiled;
+    
+    int findResource(const std::string& name) const;
+    bool resolvePasses();
+    bool cullPasses();
+    bool sortPasses();
+    void computeLifetimes();
+    void assignPhysicalTargets();
+};
+
+#endif // RENDER_GRAPH_HPP
@@ -0,0 +1,41 @@
+#ifndef RENDER_TARGET_DESC_HPP
+#define RENDER_TARGET_DESC_HPP
+
+#include "TextureProperties.hpp"
+#include <vector>
+
+// Description of a render target; also the key used to match pooled framebuffers
+struct RenderTargetDesc {
+    // Explicit size in pixels; 0 means "follow the screen size" (times scale)
+    int width = 0;
+    int height = 0;
+    float scale = 1.0f;
+    
+    // Colour attachments, in shader output order
+    std::vector<TextureProperties> attachments;
+    
+    // Depth/stencil attachment, optionally sampleable
+    bool depthStencil = true;
+    bool sampleableDepth = false;
+    
+    RenderTargetDesc() = default;
+    RenderTargetDesc(const std::vector<TextureProperties>& attachments, bool depthStencil = true,
+                     bool sampleableDepth = false, float scale = 1.0f)
+        : scale(scale), attachments(attachments), depthStencil(depthStencil), sampleableDepth(sampleableDepth) {}
+    
+    // Whether the size is derived from the screen (and must follow resizes)
+    bool isScreenRelative() const { return width <= 0 || height <= 0; }
+    
+    // Descriptions are equal if they resolve to interchangeable targets
+    bool operator==(const RenderTargetDesc& other) const {
+        return width == other.width && height == other.height && scale == other.scale &&
+               depthStencil == other.depthStencil && sampleableDepth == other.sampleableDepth &&
+               attachments == other.attachments;
+    }
+    
+    bool operator!=(const RenderTargetDesc& other) const {
+        return !(*this == other);
+    }
+};
+
+#endif // RENDER_TARGET_DESC_HPP
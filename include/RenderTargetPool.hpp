@@ -0,0 +1,79 @@
+#ifndef RENDER_TARGET_POOL_HPP
+#define RENDER_TARGET_POOL_HPP
+
+#include "Framebuffer.hpp"
+#include "RenderTargetDesc.hpp"
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Pool of transient framebuffers keyed on (size, attachment formats, depth).
+// Targets are handed out per frame; a target released by one pass can be
+// handed to a later pass with the same key, so passes that don't overlap
+// share the same GPU memory.
+class RenderTargetPool {
+private:
+    struct PooledTarget {
+        std::unique_ptr<Framebuffer> framebuffer;
+        RenderTargetDesc desc;       // Requested description
+        int width;                   // Resolved width in pixels
+        int height;                  // Resolved height in pixels
+        bool inUse;                  // Currently handed out
+        std::uint64_t lastUsedFrame; // Frame this target was last acquired in
+        size_t bytes;                // Approximate VRAM footprint
+    };
+    
+    std::vector<PooledTarget> targets;
+    int screenWidth;
+    int screenHeight;
+    bool screenResized;              // Resize happened since the last beginFrame
+    std::uint64_t frameIndex;
+    std::uint64_t maxIdleFrames;     // Free targets unused for this long are destroyed
+    
+    // Statistics for the current frame
+    size_t acquiresThisFrame;
+    size_t createdThisFrame;
+    
+    // Resolve the pixel size of a description against the current screen size
+    void resolveSize(const RenderTargetDesc& desc, int& width, int& height) const;
+    
+    // Whether a pooled target can satisfy a request
+    static bool matches(const PooledTarget& target, const RenderTargetDesc& desc, int width, int height);
+    
+public:
+    RenderTargetPool(int screenWidth, int screenHeight, std::uint64_t maxIdleFrames = 3);
+    
+    // Disable copying (owns framebuffers)
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+    
+    // Start a new frame: every transient target goes back to the pool and
+    // stale or wrongly sized targets are destroyed
+    void beginFrame();
+    
+    // Get a framebuffer matching the description (reused if possible)
+    Framebuffer* acquire(const RenderTargetDesc& desc);
+    
+    // Return a framebuffer early so a later pass can alias it
+    void release(Framebuffer* framebuffer);
+    
+    // Record a new screen size; screen-relative targets are recreated lazily
+    void resize(int width, int height);
+    
+    // Destroy every pooled target
+    void clear();
+    
+    // Pool statistics
+    size_t getTargetCount() const { return targets.size(); }
+    size_t getAllocatedBytes() const;
+    size_t getAcquiresThisFrame() const { return acquiresThisFrame; }
+    size_t getCreatedThisFrame() const { return createdThisFrame; }
+    int getScreenWidth() const { return screenWidth; }
+    int getScreenHeight() const { return screenHeight; }
+    
+    // Approximate size of one texel for a sized internal format
+    static size_t bytesPerPixel(GLenum internalFormat);
+};
+
+#endif // RENDER_TARGET_POOL_HPP
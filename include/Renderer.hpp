@@ -9,11 +9,14 @@
 
 #include "Shader.hpp"
 #include "GameObject.hpp"
+#include "BonePalette.hpp"
 
 class Renderer {
 private:
     GLuint defaultTexture;  // A default white texture
     std::vector<GameObject*> renderQueue; // Queue of objects to render
+    BonePalette bonePalette;   // Bone matrices of every skinned object in the queue
+    std::vector<int> boneOffsets; // Palette offset per queued object (-1 if not skinned)
 
     void initializeDefaultTexture(); // Creates a simple white texture
 public:
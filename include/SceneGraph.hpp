@@ -65,7 +65,7 @@ public:
     void detachObject(GameObject* obj);
     const std::vector<GameObject*>& getObjects() const;
     
-    // Rendering functions
+    // Rendering functions (render is defined with the Renderer, in Renderer.cpp)
     void render(Renderer& renderer, const Frustum& frustum);
     void update(float deltaTime);
     void collectVisibleObjects(std::vector<GameObject*>& visibleObjects, const Frustum& frustum);
@@ -140,6 +140,7 @@ public:
     // Update a specific object in the scene
     void updateObject(GameObject* obj);
     
+    // Submit the visible objects (defined with the Renderer, in Renderer.cpp)
     void render(Renderer& renderer, const Camera& camera);
     
     SceneNode* createNode(SceneNode* parent = nullptr);
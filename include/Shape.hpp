@@ -3,9 +3,11 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include <GL/glew.h>
 #include <vector>
 #include <string>
+#include <memory>
+
+class Skeleton;
 
 // Bone structure to store information about each bone
 struct Bone {
@@ -22,9 +24,23 @@ struct VertexBoneData {
 };
 
 class Shape {
+public:
+    // Vertex buffers are created through these hooks, which ShapeGpu installs once a GL
+    // context exists. Without them (headless tools such as engine_bench) shapes keep their
+    // CPU-side data only and have no VAO or VBO.
+    struct GpuHooks {
+        void (*uploadTriangles)(Shape& shape, size_t triangleCount, const std::vector<float>& vertexData);
+        void (*uploadMesh)(Shape& shape, const std::vector<float>& positionData,
+                           const std::vector<float>& normalData, const std::vector<float>& uvData);
+        void (*release)(Shape& shape);
+    };
+    
 private:
-    GLuint vao;
-    GLuint vbo;
+    friend class ShapeGpu;
+    static GpuHooks gpuHooks;
+    
+    unsigned int vao = 0;       // GL object names, 0 until uploaded
+    unsigned int vbo = 0;
     std::vector<glm::vec3> pos;
     std::vector<glm::vec3> norm;
     std::vector<glm::vec2> uv;  // Added UV support
@@ -34,6 +50,7 @@ private:
     std::vector<Bone> bones;
     std::vector<VertexBoneData> vertexBoneData;
     std::vector<glm::mat4> boneMatrices;  // Current bone transformation matrices
+    std::shared_ptr<const Skeleton> skeleton;  // Hierarchy and bind pose, shared by copies of the shape
 
 public:
     // Constructors and destructor
@@ -50,6 +67,9 @@ public:
           
     ~Shape();
     
+    // Install the vertex buffer hooks (shapes created earlier keep CPU-side data only)
+    static void setGpuHooks(const GpuHooks& hooks);
+    
     // Get vertex data accessors
     const std::vector<glm::vec3>& getPositions() const { return pos; }
     const std::vector<glm::vec3>& getNormals() const { return norm; }
@@ -62,6 +82,7 @@ public:
     const std::vector<Bone>& getBones() const { return bones; }
     size_t getBoneCount() const { return bones.size(); }
     const std::vector<VertexBoneData>& getVertexBoneData() const { return vertexBoneData; }
+    const std::shared_ptr<const Skeleton>& getSkeleton() const { return skeleton; }
     
     // Update bone transformations for animation
     void updateBoneTransforms(const std::vector<glm::quat>& boneRotations);
@@ -70,8 +91,8 @@ public:
     const std::vector<glm::mat4>& getBoneMatrices() const { return boneMatrices; }
     
     // OpenGL buffer accessors
-    GLuint getVAO() const { return vao; }
-    GLuint getVBO() const { return vbo; }
+    unsigned int getVAO() const { return vao; }
+    unsigned int getVBO() const { return vbo; }
 };
 
 // Load mesh data from file (old format)
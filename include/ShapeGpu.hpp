@@ -0,0 +1,31 @@
+#ifndef SHAPE_GPU_HPP
+#define SHAPE_GPU_HPP
+
+#include "Shape.hpp"
+#include <vector>
+
+class CpuSkinner;
+
+// OpenGL side of Shape: uploads its vertex data into a VAO/VBO and deletes them again.
+// Kept apart from Shape.cpp so geometry, collision and animation build without GL.
+class ShapeGpu {
+public:
+    // Upload the shapes created from now on; needs a current GL context
+    // (SDL_Manager calls this once GLEW is initialized)
+    static void install();
+    
+    // Overwrite a shape's VBO with the skinner's last result (the CPU skinning fallback)
+    static void uploadSkinned(unsigned int vbo, CpuSkinner& skinner);
+
+private:
+    // Old format: vertexData holds position and normal per vertex
+    static void uploadTriangles(Shape& shape, size_t triangleCount, const std::vector<float>& vertexData);
+    
+    // Armature format: separate position, normal and UV arrays, plus the shape's bone weights
+    static void uploadMesh(Shape& shape, const std::vector<float>& positionData,
+                           const std::vector<float>& normalData, const std::vector<float>& uvData);
+    
+    static void release(Shape& shape);
+};
+
+#endif // SHAPE_GPU_HPP
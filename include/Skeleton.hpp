@@ -0,0 +1,78 @@
+#ifndef SKELETON_HPP
+#define SKELETON_HPP
+
+#include "Quaternion.hpp"
+#include "AABB.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Bone;
+struct VertexBoneData;
+
+// Immutable bone hierarchy shared by every instance of an armature mesh.
+// Bones are evaluated in a verified parent-before-child order, bind-pose inverses
+// are precomputed, and all hierarchy math uses 3x4 affine matrices.
+// Posing is split into two stages so moving an object only redoes the second:
+//   1. computeModelSpace: local rotations -> model space (only when the pose changes)
+//   2. computeWorldMatrices: model space -> world skinning matrices (pose or object moved)
+class Skeleton {
+public:
+    // 3x4 affine transform: columns 0-2 are the linear part, column 3 the translation
+    using Affine = glm::mat4x3;
+    
+    explicit Skeleton(const std::vector<Bone>& bones);
+    
+    // Also builds a bind-pose box per bone from the vertices it influences
+    Skeleton(const std::vector<Bone>& bones, const std::vector<glm::vec3>& positions,
+             const std::vector<VertexBoneData>& vertexBoneData);
+    
+    size_t getBoneCount() const { return parents.size(); }
+    int getParent(size_t bone) const { return bone < parents.size() ? parents[bone] : -1; }
+    const std::string& getName(size_t bone) const { return names[bone]; }
+    int findBone(const std::string& name) const;
+    
+    // Bone indices with every parent before its children
+    const std::vector<uint16_t>& getEvaluationOrder() const { return evaluationOrder; }
+    
+    // True when the file order was already parent-before-child
+    bool isFileOrderTopological() const { return fileOrderTopological; }
+    
+    // Stage 1: bone-local rotations -> model-space bone transforms and model-space
+    // skinning transforms (modelSpace * inverseBind). Missing rotations count as identity.
+    void computeModelSpace(const std::vector<Quaternion>& localRotations,
+                           std::vector<Affine>& modelSpace,
+                           std::vector<Affine>& skinning) const;
+    
+    // Stage 2: model-space skinning transforms -> world-space 4x4 matrices for the GPU
+    void computeWorldMatrices(const std::vector<Affine>& skinning, const glm::mat4& modelMatrix,
+                              std::vector<glm::mat4>& worldMatrices) const;
+    
+    // World bounds of the skinned mesh: the union of every bone's box transformed by its
+    // world matrix, plus unweighted vertices under the model matrix. O(bones), and it
+    // contains the skinned mesh because each vertex is a weighted average of its bones.
+    // Returns false when the skeleton was built without vertex data.
+    bool computeSkinnedBounds(const std::vector<glm::mat4>& worldMatrices, const glm::mat4& modelMatrix,
+                              AABB& bounds) const;
+    bool hasBoneBounds() const { return !boundedBones.empty() || hasUnskinnedBounds; }
+    
+    // Affine helpers
+    static Affine multiply(const Affine& a, const Affine& b);
+    static Affine fromMatrix(const glm::mat4& m);
+    static glm::mat4 toMatrix(const Affine& a);
+
+private:
+    std::vector<std::string> names;
+    std::vector<int> parents;
+    std::vector<uint16_t> evaluationOrder;
+    std::vector<glm::vec3> bindTranslations;   // Head relative to the parent's head
+    std::vector<Affine> inverseBind;           // Model space -> bone space at bind pose
+    std::vector<uint16_t> boundedBones;        // Bones with at least one weighted vertex
+    std::vector<AABB> boneBounds;              // Bind-pose model-space box per bounded bone
+    AABB unskinnedBounds;                      // Vertices without bone weights
+    bool hasUnskinnedBounds;
+    bool fileOrderTopological;
+};
+
+#endif // SKELETON_HPP
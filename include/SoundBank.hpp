@@ -0,0 +1,99 @@
+#ifndef SOUND_BANK_HPP
+#define SOUND_BANK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Stable, typed sound identifier: a hash of the sound's name (its WAV file name without
+// the extension), so a name maps to the same ID in every bank build and for loose sounds
+struct SoundID {
+    uint32_t value = 0;     // 0 = none
+    
+    static SoundID fromName(const std::string& name);
+    
+    bool isValid() const { return value != 0; }
+    bool operator==(const SoundID& other) const { return value == other.value; }
+    bool operator!=(const SoundID& other) const { return value != other.value; }
+};
+
+// Decoded samples of one sound in the mixer's format: float at the output rate,
+// mono or interleaved stereo
+struct SoundSamples {
+    const float* samples = nullptr;
+    uint32_t frameCount = 0;
+    int channels = 1;
+    
+    bool isValid() const { return samples && frameCount > 0; }
+};
+
+// What the bank builder did
+struct SoundBankBuildStats {
+    size_t sounds = 0;
+    size_t sharedSounds = 0;    // Sounds whose samples duplicate another's and share its storage
+    size_t sourceBytes = 0;     // WAV files
+    size_t bankBytes = 0;
+    
+    void print(std::ostream& out) const;
+};
+
+// Every sound of a game in one file: a name -> ID table and one contiguous arena of
+// pre-converted samples, each sound 64-byte aligned. Built offline from a directory of
+// WAV files and loaded with a single mmap, so startup reads one file and playback reads
+// samples straight from the mapping. Identical sounds are stored once.
+class SoundBank {
+public:
+    ~SoundBank();
+    
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+    
+    // Offline: convert every .wav in directory to sampleRate and write a bank
+    static bool build(const std::string& directory, const std::string& outputPath, int sampleRate,
+                      SoundBankBuildStats* stats = nullptr);
+    
+    // Map a bank file; nullptr if it is missing or invalid
+    static std::unique_ptr<SoundBank> load(const std::string& path);
+    
+    // Samples of a sound; invalid if the bank does not have it
+    SoundSamples find(SoundID id) const;
+    bool contains(SoundID id) const { return findEntry(id) != nullptr; }
+    
+    // Name of a sound, or an empty string
+    std::string getName(SoundID id) const;
+    
+    size_t getSoundCount() const { return soundCount; }
+    int getSampleRate() const { return sampleRate; }
+    size_t getFileSize() const { return size; }
+
+private:
+    // Table row, sorted by ID
+    struct Entry {
+        uint32_t id;
+        uint32_t nameOffset;    // Into the name blob
+        uint32_t nameLength;
+        uint32_t frameCount;
+        uint64_t firstSample;   // Float index into the arena
+        uint32_t channels;
+        uint32_t reserved;
+    };
+    
+    const uint8_t* data;
+    size_t size;
+    bool mapped;                        // data is an mmap, else it points into fallback
+    std::vector<uint8_t> fallback;      // Whole-file read where mmap is unavailable
+    const Entry* entries;
+    size_t soundCount;
+    const char* names;
+    const float* arena;
+    int sampleRate;
+    
+    SoundBank();
+    
+    const Entry* findEntry(SoundID id) const;
+};
+
+#endif // SOUND_BANK_HPP
@@ -2,93 +2,219 @@
 #define SOUNDSYSTEM_HPP
 
 #include <SDL.h>
+#include "AudioCommandQueue.hpp"
+#include "AudioInstrumentation.hpp"
+#include "AudioMixer.hpp"
+#include "AudioStream.hpp"
+#include "SoundBank.hpp"
+#include "WavWriter.hpp"
+#include <glm/glm.hpp>
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <iostream>
 
-// Represents a preloaded sound with RAII management
+// A sound decoded once at load time into the mixer's format: float samples at the
+// output rate, mono or interleaved stereo
 class Sound {
 private:
-    Uint8* buffer;
-    Uint32 length;
-    
+    std::vector<float> samples;
+    int channels;
+
 public:
-    Sound(Uint8* b, Uint32 l) : buffer(b), length(l) {}
-    ~Sound() {
-        if (buffer) {
-            SDL_FreeWAV(buffer);
-        }
-    }
-    
-    // Prevent copying to maintain RAII semantics
+    Sound(std::vector<float>&& s, int c) : samples(std::move(s)), channels(c) {}
+    
+    // Prevent copying; voices point into the samples
     Sound(const Sound&) = delete;
     Sound& operator=(const Sound&) = delete;
     
-    // Allow moving
-    Sound(Sound&& other) noexcept : buffer(other.buffer), length(other.length) {
-        other.buffer = nullptr;
-        other.length = 0;
-    }
-    
-    Sound& operator=(Sound&& other) noexcept {
-        if (this != &other) {
-            if (buffer) {
-                SDL_FreeWAV(buffer);
-            }
-            buffer = other.buffer;
-            length = other.length;
-            other.buffer = nullptr;
-            other.length = 0;
-        }
-        return *this;
-    }
-    
-    Uint8* getBuffer() const { return buffer; }
-    Uint32 getLength() const { return length; }
+    const float* getSamples() const { return samples.data(); }
+    Uint32 getFrameCount() const { return static_cast<Uint32>(samples.size() / channels); }
+    int getChannels() const { return channels; }
+    SoundSamples getView() const { return SoundSamples{ samples.data(), getFrameCount(), channels }; }
 };
 
-// Represents an actively playing sound
-struct SoundState {
-    Uint8* buffer;    // Raw audio buffer
-    Uint32 length;    // Total buffer length
-    Uint32 position;  // Current playback position
-    bool playing;     // Playback flag
-    bool autoFree;    // Whether to free the buffer when finished
-    
-    SoundState() : buffer(nullptr), length(0), position(0), playing(false), autoFree(false) {}
+class Camera;
+class GameObject;
+
+// Distance model of a positional sound (world units)
+struct SpatialSettings {
+    float minDistance = 1.0f;       // Full volume inside this radius, 1/distance outside
+    float maxDistance = 50.0f;      // Fades out over the last 20% of the range; silent beyond
+    float dopplerFactor = 1.0f;     // 0 disables the Doppler pitch shift
 };
 
-// Core Sound System
+// Where the mix goes
+enum class AudioBackend {
+    Device,     // An SDL audio device pulls the callback on its own thread
+    Offline     // No device: advanceOffline() runs the callback on a simulated clock
+};
+
+// Core Sound System.
+// The game thread never locks the audio device: play/stop/gain requests go through a
+// lock-free command ring that the callback drains first, then AudioMixer mixes a fixed
+// voice pool. WAV files of any rate, sample format and channel count are converted to
+// float at OUTPUT_RATE when loaded, so the callback only mixes. Long sounds stream from
+// disk through AudioStreamer's thread instead, so starting one never reads a file here.
+// Sounds are addressed by SoundID and come from mapped sound banks or loose WAV files.
+// Positional sounds are spatialized on the game thread in update(); out-of-range voices
+// go virtual in the mixer and cost no mixing. Every voice plays on a mix bus with its own
+// effects (AudioBusGraph); positional sounds use the SFX bus. The offline backend renders
+// the same callback headless (optionally into a WAV file), and every callback is timed.
 class SoundSystem {
+public:
+    static const int MAX_VOICES = 32;
+    static const int OUTPUT_RATE = 44100;
+    static const int OUTPUT_CHANNELS = AudioMixer::CHANNELS;
+    static const int OUTPUT_FRAMES = 1024;      // Frames per callback
+    static constexpr float SPEED_OF_SOUND = 343.0f;     // World units per second
+
 private:
+    AudioBackend backend;
     SDL_AudioDeviceID deviceID;
     SDL_AudioSpec audioSpec;
-    std::vector<std::unique_ptr<Sound>> sounds;  // Preloaded sounds using RAII
-    std::vector<SoundState> activeSounds;        // Playing sounds
-    Uint8* mixBuffer;                            // Mixing buffer
-    int mixBufferSize;                           // Buffer size
+    std::vector<std::unique_ptr<SoundBank>> banks;     // Searched before the loose sounds
+    std::unordered_map<uint32_t, std::unique_ptr<Sound>> sounds;   // Loose sounds by SoundID
+    
+    // Audio thread only (after the device starts)
+    AudioMixer mixer;
+    
+    // Game thread -> callback commands
+    SpscRing<AudioCommand, 256> commands;
+    
+    // Opens, refills and deletes streams on its own thread
+    AudioStreamer streamer;
+    
+    // Callback timing, underruns and play latency
+    AudioInstrumentation instrumentation;
+    uint64_t callbackTime;      // Audio thread: latency clock (ns) at the start of the callback
+    
+    // Offline backend, game thread
+    uint64_t offlineFrames;     // Rendered so far: the simulated clock of the callback
+    double offlineTime;         // Simulated game time (seconds) reached by advanceOffline
+    std::vector<Sint16> offlineBuffer;
+    WavWriter capture;
+    
+    // Callback -> game thread: positional voices that ended
+    SpscRing<SoundHandle, 512> endedVoices;
+    
+    // Game thread: a playing positional sound
+    struct Emitter {
+        SoundHandle handle;
+        const GameObject* object;   // Followed every update; nullptr for a fixed position
+        glm::vec3 position;
+        glm::vec3 velocity;
+        SpatialSettings settings;
+    };
+    
+    // Game thread only
+    SoundHandle nextHandle;
+    size_t droppedCommands;
+    std::vector<Emitter> emitters;
+    glm::vec3 listenerPosition;
+    glm::vec3 listenerVelocity;
+    glm::vec3 listenerRight;
+    bool listenerPlaced;
     
     static void audioCallback(void* userdata, Uint8* stream, int len);
+    
+    // Latency clock (ns): steady_clock with a device, the simulated game time offline
+    uint64_t now() const;
+    
+    // Audio thread: apply queued commands at the top of the callback
+    void processCommands();
+    static void voiceEnded(void* userdata, SoundHandle handle);
+    
+    // Game thread: queue a command without blocking (dropped if the ring is full)
+    bool sendCommand(const AudioCommand& command);
+    SoundHandle queuePlay(const SoundSamples& samples, AudioStream* stream, int priority, AudioBusID bus,
+                          const Emitter* emitter = nullptr);
+    SoundHandle playPositional(SoundID id, const glm::vec3& position, const GameObject* object,
+                               int priority, const SpatialSettings& settings);
+    
+    // Attenuation, pan and Doppler pitch of an emitter for the current listener
+    void spatialize(const Emitter& emitter, float& attenuation, float& pan, float& pitch) const;
+    
+    // Samples of a loaded sound; invalid (and reported) if no bank or loose sound has it
+    SoundSamples findSound(SoundID id) const;
 
 public:
-    SoundSystem();
+    explicit SoundSystem(AudioBackend backend = AudioBackend::Device);
     ~SoundSystem();
     
     // Disable copying
     SoundSystem(const SoundSystem&) = delete;
     SoundSystem& operator=(const SoundSystem&) = delete;
     
-    // Load a sound into the sounds library for repeated use
-    bool loadSound(const std::string& filepath);
+    // Load a WAV file and convert it to the output format (at sampleRate); nullptr on failure
+    static std::unique_ptr<Sound> decodeWAV(const std::string& filepath, int sampleRate = OUTPUT_RATE);
     
-    // Play a sound from the library (by index)
-    void playSound(int soundIndex);
+    // Map a sound bank (see SoundBank::build); its sounds take precedence over loose ones
+    bool loadBank(const std::string& filepath);
     
-    // Play a sound directly from file (one-time use)
-    void playSound(const std::string& filepath);
-
-    void cleanup();
+    // Load a loose sound for repeated use; its ID comes from the file name
+    // (SoundID::fromName("paddle_hit") for .../paddle_hit.wav). Invalid on failure.
+    SoundID loadSound(const std::string& filepath);
+    
+    // Play a loaded sound; returns 0 if it could not be queued.
+    // When every voice is busy, the new sound replaces the oldest voice of the lowest
+    // priority, unless all playing voices have a higher priority.
+    SoundHandle playSound(SoundID id, int priority = 0, AudioBusID bus = AudioBusID::SFX);
+    
+    // Play a sound directly from file (one-time use); it is streamed, see playStream
+    SoundHandle playSound(const std::string& filepath, int priority = 0);
+    
+    // Stream a long sound (music, ambience) from disk with constant memory. The file is
+    // opened and read on the streaming thread, so playback starts a few milliseconds later.
+    SoundHandle playStream(const std::string& filepath, bool looping = false, int priority = 0,
+                           AudioBusID bus = AudioBusID::Music);
+    
+    // Play a loaded sound at a fixed position, or following an object (its position and
+    // velocity are read in every update), relative to the listener of the last update
+    SoundHandle playSoundAt(SoundID id, const glm::vec3& position, int priority = 0,
+                            const SpatialSettings& settings = SpatialSettings());
+    SoundHandle playSoundAt(SoundID id, const GameObject* object, int priority = 0,
+                            const SpatialSettings& settings = SpatialSettings());
+    
+    // Bus mixing (SFX, music, UI): gain, a low-pass filter (cutoff in Hz, 0 = off) and the
+    // level sent to the shared reverb. The SFX bus is compressed and the master limited.
+    void setBusGain(AudioBusID bus, float gain);
+    void setBusLowPass(AudioBusID bus, float cutoff);
+    void setBusReverbSend(AudioBusID bus, float send);
+    
+    // Move a positional sound (it stops following its object)
+    void setSoundPosition(SoundHandle handle, const glm::vec3& position);
+    
+    // Stop following an object before it is destroyed; its sounds stay where it was
+    void detachEmitters(const GameObject* object);
+    
+    // Once per frame: put the listener at the camera and respatialize every positional sound
+    void update(const Camera& listener, float deltaTime);
+    size_t getEmitterCount() const { return emitters.size(); }
+    
+    // Control a playing sound; unknown or finished handles are ignored
+    void stopSound(SoundHandle handle);
+    void stopAllSounds();
+    void setSoundGain(SoundHandle handle, float gain);
+    void setSoundPan(SoundHandle handle, float pan);
+    
+    // Commands dropped because the ring was full
+    size_t getDroppedCommandCount() const { return droppedCommands; }
+    
+    // Callback durations, deadline misses, stream underruns and the latency from a play
+    // call to the callback that mixes its first sample
+    const AudioInstrumentation& getInstrumentation() const { return instrumentation; }
+    
+    AudioBackend getBackend() const { return backend; }
+    
+    // Offline backend: advance simulated time, running every callback due in it (one per
+    // OUTPUT_FRAMES frames) and appending its output to the capture file if one is open.
+    // Streams are filled before each callback, so the output does not depend on timing.
+    void advanceOffline(double seconds);
+    double getOfflineTime() const { return offlineTime; }
+    bool startCapture(const std::string& filepath);
+    void stopCapture() { capture.close(); }
 };
 
 #endif // SOUNDSYSTEM_HPP
\ No newline at end of file
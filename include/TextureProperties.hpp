@@ -0,0 +1,73 @@
+#ifndef TEXTURE_PROPERTIES_HPP
+#define TEXTURE_PROPERTIES_HPP
+
+#include <vector>
+
+// G-Buffer attachment layouts selectable through TextureProperties::gBufferPreset
+enum class GBufferLayout {
+    Full,       // RGB32F diffuse, normal and world position (36 bytes per pixel)
+    Compact     // RGBA8 albedo + octahedral RG16 normal, position rebuilt from depth (8 bytes per pixel)
+};
+
+// Structure to define texture properties for FBO attachments. The fields hold GLenum
+// values as plain unsigned ints, so descriptions (and the render graph built on them)
+// compile without GL headers.
+struct TextureProperties {
+    // GL_RGBA, GL_UNSIGNED_BYTE, GL_LINEAR and GL_CLAMP_TO_EDGE (checked in Framebuffer.hpp)
+    static constexpr unsigned int DEFAULT_FORMAT = 0x1908;
+    static constexpr unsigned int DEFAULT_TYPE = 0x1401;
+    static constexpr unsigned int DEFAULT_FILTER = 0x2601;
+    static constexpr unsigned int DEFAULT_WRAP = 0x812F;
+    
+    // Format of the internal texture (e.g., GL_RGBA, GL_RGB16F, etc.)
+    unsigned int internalFormat = DEFAULT_FORMAT;
+    
+    // Format and type of the pixel data (used when creating the texture)
+    unsigned int format = DEFAULT_FORMAT;
+    unsigned int type = DEFAULT_TYPE;
+    
+    // Texture filtering parameters
+    unsigned int minFilter = DEFAULT_FILTER;
+    unsigned int magFilter = DEFAULT_FILTER;
+    
+    // Texture wrapping parameters
+    unsigned int wrapS = DEFAULT_WRAP;
+    unsigned int wrapT = DEFAULT_WRAP;
+    
+    // Constructor with commonly used parameters
+    TextureProperties(
+        unsigned int internalFormat = DEFAULT_FORMAT,
+        unsigned int format = DEFAULT_FORMAT,
+        unsigned int type = DEFAULT_TYPE,
+        unsigned int minFilter = DEFAULT_FILTER,
+        unsigned int magFilter = DEFAULT_FILTER
+    ) : internalFormat(internalFormat), 
+        format(format), 
+        type(type), 
+        minFilter(minFilter), 
+        magFilter(magFilter) {}
+    
+    // Two attachments are interchangeable if every property matches
+    bool operator==(const TextureProperties& other) const {
+        return internalFormat == other.internalFormat && format == other.format && type == other.type &&
+               minFilter == other.minFilter && magFilter == other.magFilter &&
+               wrapS == other.wrapS && wrapT == other.wrapT;
+    }
+    
+    bool operator!=(const TextureProperties& other) const {
+        return !(*this == other);
+    }
+    
+    // Presets for individual G-Buffer attachments
+    static TextureProperties rgb32f();          // Full precision vec3 (diffuse, normal or position)
+    static TextureProperties albedoRGBA8();     // 8-bit albedo, alpha free for material flags
+    static TextureProperties octNormalRG16();   // Octahedron-encoded normal in two 16-bit channels
+    
+    // Full attachment list for a G-Buffer layout (in shader output order)
+    static std::vector<TextureProperties> gBufferPreset(GBufferLayout layout);
+    
+    // Whether the layout needs a sampleable depth texture to rebuild positions
+    static bool gBufferNeedsDepthTexture(GBufferLayout layout);
+};
+
+#endif // TEXTURE_PROPERTIES_HPP
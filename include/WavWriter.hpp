@@ -0,0 +1,33 @@
+#ifndef WAV_WRITER_HPP
+#define WAV_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Writes interleaved 16-bit PCM to a WAV file as it arrives; the chunk sizes in the
+// header are filled in by close()
+class WavWriter {
+public:
+    WavWriter();
+    ~WavWriter();
+    
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+    
+    bool open(const std::string& filepath, int sampleRate, int channels);
+    void write(const int16_t* samples, size_t frames);
+    void close();
+    
+    bool isOpen() const { return file.is_open(); }
+    uint64_t getFrameCount() const { return frames; }
+
+private:
+    std::ofstream file;
+    std::string filepath;
+    int channels;
+    uint64_t frames;
+};
+
+#endif // WAV_WRITER_HPP
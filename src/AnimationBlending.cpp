@@ -0,0 +1,357 @@
+#include "AnimationBlending.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ANIMATION_BLENDING_SSE 1
+#endif
+
+// Pose rotations are read and written as packed (w, x, y, z) floats
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be four packed floats");
+static_assert(std::is_standard_layout<Quaternion>::value, "Quaternion must be standard layout");
+
+static inline const float* components(const AnimationPose& pose) {
+    return reinterpret_cast<const float*>(pose.rotations.data());
+}
+
+static inline float* components(AnimationPose& pose) {
+    return reinterpret_cast<float*>(pose.rotations.data());
+}
+
+// Shortest-path normalized lerp of one quaternion pair
+static inline void nlerp(const float* a, const float* b, float t, float* out) {
+#if defined(ANIMATION_BLENDING_SSE)
+    __m128 va = _mm_loadu_ps(a);
+    __m128 vb = _mm_loadu_ps(b);
+    
+    // Horizontal dot product, broadcast to all lanes
+    __m128 prod = _mm_mul_ps(va, vb);
+    __m128 shuf = _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(prod, shuf);
+    __m128 dot = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+    dot = _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(0, 0, 0, 0));
+    
+    // Flip the second weight when the quaternions are in opposite hemispheres
+    __m128 tb = _mm_xor_ps(_mm_set1_ps(t), _mm_and_ps(dot, _mm_set1_ps(-0.0f)));
+    __m128 r = _mm_add_ps(_mm_mul_ps(va, _mm_set1_ps(1.0f - t)), _mm_mul_ps(vb, tb));
+    
+    __m128 sq = _mm_mul_ps(r, r);
+    shuf = _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1));
+    sums = _mm_add_ps(sq, shuf);
+    __m128 lengthSq = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+    lengthSq = _mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(0, 0, 0, 0));
+    _mm_storeu_ps(out, _mm_div_ps(r, _mm_sqrt_ps(lengthSq)));
+#else
+    float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    float tb = dot < 0.0f ? -t : t;
+    float ta = 1.0f - t;
+    float r[4];
+    float lengthSq = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] * ta + b[i] * tb;
+        lengthSq += r[i] * r[i];
+    }
+    float invLength = 1.0f / std::sqrt(lengthSq);
+    for (int i = 0; i < 4; i++) {
+        out[i] = r[i] * invLength;
+    }
+#endif
+}
+
+static inline void copyQuaternion(const float* source, float* out) {
+    if (source != out) {
+        std::copy(source, source + 4, out);
+    }
+}
+
+BoneMask BoneMask::all(size_t boneCount, float weight) {
+    BoneMask mask;
+    mask.weights.assign(boneCount, weight);
+    return mask;
+}
+
+BoneMask BoneMask::subtree(const std::vector<Bone>& bones, int rootBone, float weight) {
+    BoneMask mask;
+    mask.weights.assign(bones.size(), 0.0f);
+    
+    for (size_t i = 0; i < bones.size(); i++) {
+        // Walk up the hierarchy looking for the root (bounded in case of bad parent data)
+        int bone = static_cast<int>(i);
+        for (size_t depth = 0; bone >= 0 && depth <= bones.size(); depth++) {
+            if (bone == rootBone) {
+                mask.weights[i] = weight;
+                break;
+            }
+            bone = bones[bone].parentIndex;
+        }
+    }
+    
+    return mask;
+}
+
+namespace PoseBlend {
+    void blend(const AnimationPose& a, const AnimationPose& b, float weight,
+               const BoneMask* mask, AnimationPose& out) {
+        const size_t count = std::min(out.size(), std::min(a.size(), b.size()));
+        const float* qa = components(a);
+        const float* qb = components(b);
+        float* qo = components(out);
+        
+        for (size_t i = 0; i < count; i++) {
+            float t = mask ? weight * mask->get(i) : weight;
+            
+            // A bone only one side animates comes entirely from that side
+            if (!b.animated[i]) t = 0.0f;
+            else if (!a.animated[i]) t = 1.0f;
+            out.animated[i] = a.animated[i] | b.animated[i];
+            
+            if (t <= 0.0f) {
+                copyQuaternion(qa + i * 4, qo + i * 4);
+            } else if (t >= 1.0f) {
+                copyQuaternion(qb + i * 4, qo + i * 4);
+            } else {
+                nlerp(qa + i * 4, qb + i * 4, t, qo + i * 4);
+            }
+        }
+    }
+    
+    void applyAdditive(const AnimationPose& base, const AnimationPose& delta, float weight,
+                       const BoneMask* mask, AnimationPose& out) {
+        const size_t count = std::min(out.size(), std::min(base.size(), delta.size()));
+        const float identity[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        const float* qd = components(delta);
+        
+        for (size_t i = 0; i < count; i++) {
+            float t = mask ? weight * mask->get(i) : weight;
+            if (!delta.animated[i] || t <= 0.0f) {
+                if (&base != &out) {
+                    out.rotations[i] = base.rotations[i];
+                    out.animated[i] = base.animated[i];
+                }
+                continue;
+            }
+            
+            // Scale the delta rotation by the weight, then stack it on the base
+            float scaled[4];
+            if (t >= 1.0f) {
+                copyQuaternion(qd + i * 4, scaled);
+            } else {
+                nlerp(identity, qd + i * 4, t, scaled);
+            }
+            out.rotations[i] = base.rotations[i] * Quaternion(scaled[0], scaled[1], scaled[2], scaled[3], Quaternion::Unnormalized());
+            out.animated[i] = 1;
+        }
+    }
+    
+    void makeAdditiveDelta(const AnimationPose& pose, const AnimationPose& reference, AnimationPose& out) {
+        const size_t count = std::min(out.size(), std::min(pose.size(), reference.size()));
+        for (size_t i = 0; i < count; i++) {
+            out.rotations[i] = reference.rotations[i].conjugate() * pose.rotations[i];
+            out.animated[i] = pose.animated[i];
+        }
+    }
+    
+    void copy(const AnimationPose& source, AnimationPose& out) {
+        const size_t count = std::min(out.size(), source.size());
+        std::copy(source.rotations.begin(), source.rotations.begin() + count, out.rotations.begin());
+        std::copy(source.animated.begin(), source.animated.begin() + count, out.animated.begin());
+    }
+}
+
+AnimationBlender::AnimationBlender(GameObject* target, size_t boneCount)
+    : target(target), boneCount(boneCount) {
+    finalPose.resize(boneCount);
+}
+
+int AnimationBlender::addLayer(LayerMode mode, float weight) {
+    Layer layer;
+    layer.mode = mode;
+    layer.weight = weight;
+    layer.masked = false;
+    layer.pose.resize(boneCount);
+    layers.push_back(std::move(layer));
+    return static_cast<int>(layers.size() - 1);
+}
+
+void AnimationBlender::setLayerWeight(int layer, float weight) {
+    if (layer >= 0 && layer < static_cast<int>(layers.size())) {
+        layers[layer].weight = weight;
+    }
+}
+
+void AnimationBlender::setLayerMask(int layer, const BoneMask& mask) {
+    if (layer >= 0 && layer < static_cast<int>(layers.size())) {
+        layers[layer].mask = mask;
+        layers[layer].masked = true;
+    }
+}
+
+void AnimationBlender::clearLayerMask(int layer) {
+    if (layer >= 0 && layer < static_cast<int>(layers.size())) {
+        layers[layer].masked = false;
+    }
+}
+
+AnimationBlender::ClipState AnimationBlender::makeClipState(const Layer& layer, AnimationClip* clip,
+                                                            float weight, bool loop) const {
+    ClipState state;
+    state.clip = clip;
+    state.time = 0.0f;
+    state.speed = 1.0f;
+    state.loop = loop;
+    state.weight = weight;
+    state.targetWeight = weight;
+    state.fadeRate = 0.0f;
+    
+    // Size every buffer up front so update() never allocates
+    state.pose.resize(std::max(boneCount, clip->getPoseSize()));
+    clip->prepareCursor(state.cursor);
+    clip->prepareKeyBatch(state.keyBatch);
+    
+    // Additive clips are expressed relative to their first frame
+    if (layer.mode == LayerMode::Additive) {
+        state.reference.resize(state.pose.size());
+        clip->sample(0.0f, state.reference);
+    }
+    
+    return state;
+}
+
+int AnimationBlender::addClip(int layer, AnimationClip* clip, float weight, bool loop) {
+    if (layer < 0 || layer >= static_cast<int>(layers.size()) || !clip) {
+        std::cerr << "AnimationBlender: invalid layer or clip" << std::endl;
+        return -1;
+    }
+    
+    Layer& target = layers[layer];
+    target.clips.push_back(makeClipState(target, clip, weight, loop));
+    return static_cast<int>(target.clips.size() - 1);
+}
+
+void AnimationBlender::setClipWeight(int layer, int slot, float weight) {
+    if (layer >= 0 && layer < static_cast<int>(layers.size()) &&
+        slot >= 0 && slot < static_cast<int>(layers[layer].clips.size())) {
+        ClipState& state = layers[layer].clips[slot];
+        state.weight = weight;
+        state.targetWeight = weight;
+        state.fadeRate = 0.0f;
+    }
+}
+
+void AnimationBlender::setClipSpeed(int layer, int slot, float speed) {
+    if (layer >= 0 && layer < static_cast<int>(layers.size()) &&
+        slot >= 0 && slot < static_cast<int>(layers[layer].clips.size())) {
+        layers[layer].clips[slot].speed = speed;
+    }
+}
+
+void AnimationBlender::crossFade(int layer, AnimationClip* clip, float duration, bool loop) {
+    if (layer < 0 || layer >= static_cast<int>(layers.size()) || !clip) {
+        std::cerr << "AnimationBlender: invalid layer or clip" << std::endl;
+        return;
+    }
+    
+    Layer& target = layers[layer];
+    const bool instant = duration <= 0.0f;
+    
+    // Everything currently playing fades out from its present weight
+    for (ClipState& state : target.clips) {
+        state.targetWeight = 0.0f;
+        state.fadeRate = instant ? std::numeric_limits<float>::max() : state.weight / duration;
+    }
+    
+    // The new clip fades in from zero
+    ClipState incoming = makeClipState(target, clip, instant ? 1.0f : 0.0f, loop);
+    incoming.targetWeight = 1.0f;
+    incoming.fadeRate = instant ? 0.0f : 1.0f / duration;
+    target.clips.push_back(std::move(incoming));
+}
+
+size_t AnimationBlender::getClipCount(int layer) const {
+    if (layer < 0 || layer >= static_cast<int>(layers.size())) {
+        return 0;
+    }
+    return layers[layer].clips.size();
+}
+
+void AnimationBlender::sampleClip(ClipState& state) const {
+    state.clip->sampleBatched(state.time, state.pose, &state.cursor, state.keyBatch);
+}
+
+bool AnimationBlender::evaluateLayer(Layer& layer) {
+    // Running weighted average: each clip is one nlerp pass over the bones
+    float totalWeight = 0.0f;
+    for (ClipState& state : layer.clips) {
+        if (state.weight <= 0.0f) {
+            continue;
+        }
+        
+        if (layer.mode == LayerMode::Additive) {
+            PoseBlend::makeAdditiveDelta(state.pose, state.reference, state.pose);
+        }
+        
+        if (totalWeight <= 0.0f) {
+            PoseBlend::copy(state.pose, layer.pose);
+        } else {
+            PoseBlend::blend(layer.pose, state.pose, state.weight / (totalWeight + state.weight), nullptr, layer.pose);
+        }
+        totalWeight += state.weight;
+    }
+    
+    return totalWeight > 0.0f;
+}
+
+void AnimationBlender::update(float deltaTime) {
+    for (Layer& layer : layers) {
+        for (ClipState& state : layer.clips) {
+            // Move fading weights toward their targets
+            if (state.weight != state.targetWeight) {
+                float step = state.fadeRate * deltaTime;
+                state.weight = state.weight < state.targetWeight
+                    ? std::min(state.targetWeight, state.weight + step)
+                    : std::max(state.targetWeight, state.weight - step);
+            }
+            
+            // Advance clip time
+            float duration = state.clip->duration;
+            state.time += deltaTime * state.speed;
+            if (duration > 0.0f) {
+                state.time = state.loop ? std::fmod(state.time, duration) : std::min(state.time, duration);
+            }
+            
+            if (state.weight > 0.0f) {
+                sampleClip(state);
+            }
+        }
+        
+        // Drop clips that have fully faded out
+        layer.clips.erase(std::remove_if(layer.clips.begin(), layer.clips.end(),
+                                         [](const ClipState& state) {
+                                             return state.weight <= 0.0f && state.targetWeight <= 0.0f;
+                                         }),
+                          layer.clips.end());
+    }
+    
+    // Stack layers bottom to top
+    std::fill(finalPose.animated.begin(), finalPose.animated.end(), 0);
+    for (Layer& layer : layers) {
+        if (layer.weight <= 0.0f || !evaluateLayer(layer)) {
+            continue;
+        }
+        
+        const BoneMask* mask = layer.masked ? &layer.mask : nullptr;
+        if (layer.mode == LayerMode::Additive) {
+            PoseBlend::applyAdditive(finalPose, layer.pose, layer.weight, mask, finalPose);
+        } else {
+            PoseBlend::blend(finalPose, layer.pose, layer.weight, mask, finalPose);
+        }
+    }
+    
+    if (target) {
+        target->updateBoneRotations(finalPose.rotations, finalPose.animated);
+    }
+}
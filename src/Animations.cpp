@@ -1,12 +1,60 @@
 #include "Animations.hpp"
+#include "CompressedAnimation.hpp"
+#include "Profiler.hpp"
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <mutex>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+// Event name registry; the deque keeps names at stable addresses for getName
+namespace {
+    struct EventRegistry {
+        std::mutex mutex;
+        std::deque<std::string> names;
+        std::unordered_map<std::string, AnimationEventID> ids;
+        
+        EventRegistry() {
+            // Same order as the AnimationEvents built-in IDs
+            for (const char* name : {"onAnimationStart", "onAnimationStop",
+                                     "onAnimationComplete", "onAnimationLoop"}) {
+                ids.emplace(name, static_cast<AnimationEventID>(names.size()));
+                names.emplace_back(name);
+            }
+        }
+    };
+    
+    EventRegistry& eventRegistry() {
+        static EventRegistry registry;
+        return registry;
+    }
+}
+
+AnimationEventID AnimationEvents::intern(const std::string& name) {
+    EventRegistry& registry = eventRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    
+    auto it = registry.ids.find(name);
+    if (it != registry.ids.end()) {
+        return it->second;
+    }
+    
+    AnimationEventID id = static_cast<AnimationEventID>(registry.names.size());
+    registry.names.push_back(name);
+    registry.ids.emplace(name, id);
+    return id;
+}
+
+const std::string& AnimationEvents::getName(AnimationEventID id) {
+    static const std::string unknown;
+    EventRegistry& registry = eventRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return id < registry.names.size() ? registry.names[id] : unknown;
+}
+
 // Animation Class Implementation
-Animation::Animation() : duration(0.0f) {}
+Animation::Animation() {}
 
 Animation Animation::loadFromFile(const std::string& filename) {
     Animation animation;
@@ -24,12 +72,14 @@ Animation Animation::loadFromFile(const std::string& filename) {
     int keyframeCount;
     file >> keyframeCount;
     
-    // Read each keyframe
+    // Map from bone ID to its track (tracks are created on first use)
+    std::map<int, size_t> trackIndex;
+    
+    // Read each keyframe and append its rotations to the per-bone tracks
     for (int i = 0; i < keyframeCount; i++) {
-        Keyframe keyframe;
-        
         // Read timestamp
-        file >> keyframe.timestamp;
+        float timestamp;
+        file >> timestamp;
         
         // Read number of bones
         int boneCount;
@@ -41,156 +91,204 @@ Animation Animation::loadFromFile(const std::string& filename) {
             float w, x, y, z;
             
             file >> boneID >> w >> x >> y >> z;
+            if (boneID < 0) {
+                continue;
+            }
+            
+            auto it = trackIndex.find(boneID);
+            if (it == trackIndex.end()) {
+                it = trackIndex.emplace(boneID, animation.tracks.size()).first;
+                animation.tracks.push_back(BoneTrack{boneID, {}, {}});
+            }
             
-            keyframe.boneIDs.push_back(boneID);
-            keyframe.rotations.push_back(Quaternion(w, x, y, z));
+            BoneTrack& track = animation.tracks[it->second];
+            track.times.push_back(timestamp);
+            track.rotations.push_back(Quaternion(w, x, y, z));
         }
         
-        animation.keyframes.push_back(keyframe);
+        // Duration is the last keyframe's timestamp
+        animation.duration = timestamp;
     }
     
-    // Set animation duration
-    if (!animation.keyframes.empty()) {
-        animation.duration = animation.keyframes.back().timestamp;
+    // Optional event track after the keyframes: "event <time> <name>" per line
+    std::string keyword;
+    while (file >> keyword) {
+        float time;
+        std::string eventName;
+        if (keyword != "event" || !(file >> time >> eventName)) {
+            std::cerr << "Unexpected data after keyframes in " << filename << ": " << keyword << std::endl;
+            break;
+        }
+        animation.addEvent(time, eventName);
+    }
+    
+    // Keep tracks in bone order so sampling walks the pose buffer forward
+    std::sort(animation.tracks.begin(), animation.tracks.end(),
+              [](const BoneTrack& a, const BoneTrack& b) { return a.boneID < b.boneID; });
+    if (!animation.tracks.empty()) {
+        animation.poseSize = static_cast<size_t>(animation.tracks.back().boneID) + 1;
     }
     
     file.close();
     std::cout << "Loaded animation: " << animation.name << " with " << keyframeCount 
-              << " keyframes, duration: " << animation.duration << "s" << std::endl;
+              << " keyframes, " << animation.tracks.size() << " bone tracks, "
+              << animation.events.size() << " events, duration: " 
+              << animation.duration << "s" << std::endl;
     
     return animation;
 }
 
-std::map<int, Quaternion> Animation::getBoneRotationsAtTime(float time) const {
-    std::map<int, Quaternion> result;
-    
-    if (keyframes.empty()) {
-        return result;
+void AnimationClip::addEvent(float time, AnimationEventID id) {
+    // Insert after events at the same time so they fire in the order they were added
+    auto it = std::upper_bound(events.begin(), events.end(), time,
+                               [](float t, const EventKey& key) { return t < key.time; });
+    events.insert(it, EventKey{time, id});
+}
+
+void AnimationClip::addEvent(float time, const std::string& eventName) {
+    addEvent(time, AnimationEvents::intern(eventName));
+}
+
+void AnimationClip::preparePose(AnimationPose& pose) const {
+    if (pose.size() < poseSize) {
+        pose.resize(poseSize);
     }
-    
+}
+
+void AnimationClip::prepareCursor(Cursor& cursor) const {
+    cursor.keys.assign(getTrackCount(), 0);
+    cursor.lastTime = -1.0f;
+}
+
+uint32_t Animation::findKey(const BoneTrack& track, float time) {
+    // Last key with times[k] <= time
+    auto it = std::upper_bound(track.times.begin(), track.times.end(), time);
+    return static_cast<uint32_t>(std::distance(track.times.begin(), it) - 1);
+}
+
+template <typename Visitor>
+void Animation::visitKeys(float time, Cursor* cursor, Visitor&& visit) const {
     // Clamp time to animation duration
     time = std::max(0.0f, std::min(time, duration));
     
-    // Handle special cases: time at start or beyond end
-    if (time <= keyframes.front().timestamp) {
-        // Before or at first keyframe - use first keyframe rotations
-        for (size_t i = 0; i < keyframes.front().boneIDs.size(); i++) {
-            result[keyframes.front().boneIDs[i]] = keyframes.front().rotations[i];
-        }
-        return result;
-    }
-    
-    if (time >= keyframes.back().timestamp) {
-        // At or beyond last keyframe - use last keyframe rotations
-        for (size_t i = 0; i < keyframes.back().boneIDs.size(); i++) {
-            result[keyframes.back().boneIDs[i]] = keyframes.back().rotations[i];
-        }
-        return result;
-    }
-    
-    // Find the two keyframes to interpolate between
-    const Keyframe* keyframe1 = nullptr;
-    const Keyframe* keyframe2 = nullptr;
+    // A cursor only helps when time moved forward since the last sample
+    bool validCursor = cursor && cursor->keys.size() == tracks.size();
+    bool useCursor = validCursor && time >= cursor->lastTime;
     
-    for (size_t i = 0; i < keyframes.size() - 1; i++) {
-        if (keyframes[i].timestamp <= time && time < keyframes[i + 1].timestamp) {
-            keyframe1 = &keyframes[i];
-            keyframe2 = &keyframes[i + 1];
-            break;
+    for (size_t t = 0; t < tracks.size(); t++) {
+        const BoneTrack& track = tracks[t];
+        size_t bone = static_cast<size_t>(track.boneID);
+        if (track.times.empty()) {
+            continue;
         }
-    }
-    
-    if (!keyframe1 || !keyframe2) {
-        std::cerr << "Error: Could not find valid keyframes for time: " << time << std::endl;
-        return result;
-    }
-    
-    // Calculate interpolation factor (t) between 0 and 1
-    float t = (time - keyframe1->timestamp) / (keyframe2->timestamp - keyframe1->timestamp);
-    
-    // Collect all unique bone IDs from both keyframes
-    std::set<int> allBoneIDs;
-    for (int id : keyframe1->boneIDs) allBoneIDs.insert(id);
-    for (int id : keyframe2->boneIDs) allBoneIDs.insert(id);
-    
-    // Process each bone
-    for (int boneID : allBoneIDs) {
-        // Find bone in keyframe1
-        auto it1 = std::find(keyframe1->boneIDs.begin(), keyframe1->boneIDs.end(), boneID);
-        
-        // Find bone in keyframe2
-        auto it2 = std::find(keyframe2->boneIDs.begin(), keyframe2->boneIDs.end(), boneID);
         
-        // If bone exists in both keyframes, interpolate between them
-        if (it1 != keyframe1->boneIDs.end() && it2 != keyframe2->boneIDs.end()) {
-            size_t index1 = std::distance(keyframe1->boneIDs.begin(), it1);
-            size_t index2 = std::distance(keyframe2->boneIDs.begin(), it2);
-            
-            Quaternion q1 = keyframe1->rotations[index1];
-            Quaternion q2 = keyframe2->rotations[index2];
-            
-            // Perform SLERP interpolation
-            result[boneID] = slerp(q1, q2, t);
+        // Before the first key or after the last key: hold the end rotation
+        if (time <= track.times.front()) {
+            visit(bone, track.rotations.front(), track.rotations.front(), 0.0f);
+            if (validCursor) cursor->keys[t] = 0;
+            continue;
         }
-        // If bone only exists in keyframe1, use its rotation
-        else if (it1 != keyframe1->boneIDs.end()) {
-            size_t index1 = std::distance(keyframe1->boneIDs.begin(), it1);
-            result[boneID] = keyframe1->rotations[index1];
+        const uint32_t lastKey = static_cast<uint32_t>(track.times.size() - 1);
+        if (time >= track.times.back()) {
+            visit(bone, track.rotations.back(), track.rotations.back(), 0.0f);
+            if (validCursor) cursor->keys[t] = lastKey;
+            continue;
         }
-        // If bone only exists in keyframe2, use its rotation
-        else if (it2 != keyframe2->boneIDs.end()) {
-            size_t index2 = std::distance(keyframe2->boneIDs.begin(), it2);
-            result[boneID] = keyframe2->rotations[index2];
+        
+        // Find the bracketing keys: step forward from the cursor, or binary search
+        uint32_t key;
+        if (useCursor) {
+            key = std::min(cursor->keys[t], lastKey - 1);
+            while (key + 1 < lastKey && track.times[key + 1] <= time) {
+                key++;
+            }
+        } else {
+            key = findKey(track, time);
+        }
+        if (validCursor) {
+            cursor->keys[t] = key;
         }
+        
+        // Calculate interpolation factor (t) between 0 and 1
+        float t0 = track.times[key];
+        float t1 = track.times[key + 1];
+        float alpha = (time - t0) / (t1 - t0);
+        
+        visit(bone, track.rotations[key], track.rotations[key + 1], alpha);
     }
     
-    return result;
+    if (cursor) {
+        cursor->lastTime = time;
+    }
 }
 
-Quaternion Animation::slerp(const Quaternion& q1, const Quaternion& q2, float t) {
-    // Normalize quaternions
-    Quaternion q1n = q1;
-    Quaternion q2n = q2;
-    q1n.normalize();
-    q2n.normalize();
+void Animation::sample(float time, AnimationPose& pose, Cursor* cursor) const {
+    visitKeys(time, cursor, [&](size_t bone, const Quaternion& q1, const Quaternion& q2, float alpha) {
+        if (bone >= pose.size()) {
+            return;
+        }
+        pose.animated[bone] = 1;
+        
+        // Interpolate in the clip's mode (held keys are copied as-is)
+        pose.rotations[bone] = alpha > 0.0f ? QuaternionMath::interpolate(interpolationMode, q1, q2, alpha) : q1;
+    });
+}
+
+void Animation::gatherKeys(float time, Cursor* cursor, PoseKeyBatch& batch) const {
+    batch.count = 0;
+    visitKeys(time, cursor, [&](size_t bone, const Quaternion& q1, const Quaternion& q2, float alpha) {
+        batch.push(bone, q1, q2, alpha);
+    });
+}
+
+std::map<int, Quaternion> Animation::getBoneRotationsAtTime(float time) const {
+    std::map<int, Quaternion> result;
     
-    // Calculate cosine of angle between quaternions
-    float dot = q1n.getW() * q2n.getW() + q1n.getX() * q2n.getX() + q1n.getY() * q2n.getY() + q1n.getZ() * q2n.getZ();
+    AnimationPose pose;
+    preparePose(pose);
+    sample(time, pose);
     
-    // If dot negative, adjust one quaternion to take shortest path
-    if (dot < 0.0f) {
-        q2n = Quaternion(-q2n.getW(), -q2n.getX(), -q2n.getY(), -q2n.getZ());
-        dot = -dot;
+    for (const BoneTrack& track : tracks) {
+        result[track.boneID] = pose.rotations[track.boneID];
     }
     
-    // Clamp dot product to valid range to avoid NaN
-    dot = glm::clamp(dot, -1.0f, 1.0f);
-    
-    // Set default values for limiting case
-    float theta = acos(dot);
-    float sinTheta = sin(theta);
-    
-    // If angle is small, use linear interpolation
-    if (sinTheta < 0.001f) {
-        return Quaternion(
-            q1n.getW() * (1.0f - t) + q2n.getW() * t,
-            q1n.getX() * (1.0f - t) + q2n.getX() * t,
-            q1n.getY() * (1.0f - t) + q2n.getY() * t,
-            q1n.getZ() * (1.0f - t) + q2n.getZ() * t
-        );
+    return result;
+}
+
+void AnimationClip::prepareKeyBatch(PoseKeyBatch& batch) const {
+    batch.reserve(getTrackCount());
+}
+
+void AnimationClip::sampleBatched(float time, AnimationPose& pose, Cursor* cursor, PoseKeyBatch& batch) const {
+    gatherKeys(time, cursor, batch);
+    interpolateBatch(batch, pose, interpolationMode);
+}
+
+void AnimationClip::interpolateBatch(const PoseKeyBatch& batch, AnimationPose& pose, QuaternionMath::InterpolationMode mode) {
+    // Interpolate in fixed blocks on the stack, then scatter into the pose by bone
+    const size_t BLOCK = 64;
+    alignas(32) float w[BLOCK], x[BLOCK], y[BLOCK], z[BLOCK];
+    QuaternionMath::Stream out = { w, x, y, z };
+    
+    for (size_t first = 0; first < batch.count; first += BLOCK) {
+        size_t count = std::min(BLOCK, batch.count - first);
+        QuaternionMath::ConstStream a = { &batch.aw[first], &batch.ax[first], &batch.ay[first], &batch.az[first] };
+        QuaternionMath::ConstStream b = { &batch.bw[first], &batch.bx[first], &batch.by[first], &batch.bz[first] };
+        QuaternionMath::interpolateBatch(mode, count, a, b, &batch.alpha[first], out);
+        
+        for (size_t i = 0; i < count; i++) {
+            size_t bone = batch.bones[first + i];
+            if (bone < pose.size()) {
+                // Kernel output is unit length already
+                pose.rotations[bone] = Quaternion(w[i], x[i], y[i], z[i], Quaternion::Unnormalized());
+                pose.animated[bone] = 1;
+            }
+        }
     }
-    
-    // Calculate interpolation coefficients
-    float s1 = sin((1.0f - t) * theta) / sinTheta;
-    float s2 = sin(t * theta) / sinTheta;
-    
-    // Return interpolated quaternion
-    return Quaternion(
-        q1n.getW() * s1 + q2n.getW() * s2,
-        q1n.getX() * s1 + q2n.getX() * s2,
-        q1n.getY() * s1 + q2n.getY() * s2,
-        q1n.getZ() * s1 + q2n.getZ() * s2
-    );
+}
+
+Quaternion AnimationClip::slerp(const Quaternion& q1, const Quaternion& q2, float t) {
+    return QuaternionMath::slerp(q1, q2, t);
 }
 
 // AnimationPlayer Implementation
@@ -198,23 +296,47 @@ AnimationPlayer::AnimationPlayer(GameObject* target)
     : target(target), 
       currentAnimation(nullptr), 
       currentTime(0.0f), 
+      prevTime(0.0f),
       isPlaying(false), 
       looping(false),
-      playbackSpeed(1.0f) {}
+      playbackSpeed(1.0f),
+      poseStale(false),
+      lod(AnimationLOD::Full),
+      lodBoneDepth(-1),
+      lodCenterOffset(0.0f),
+      lodRadius(-1.0f) {
+    // Room for a few events per frame; the queues keep their capacity after that
+    pendingEvents.reserve(8);
+    dispatchingEvents.reserve(8);
+}
 
-void AnimationPlayer::play(Animation* animation, bool loop) {
+void AnimationPlayer::play(AnimationClip* animation, bool loop) {
     currentAnimation = animation;
     currentTime = 0.0f;
+    prevTime = 0.0f;
+    pendingEvents.clear();
     isPlaying = true;
+    lodRadius = -1.0f;
     looping = loop;
     
+    // Size the pose buffer and cursor once so per-frame sampling never allocates
+    if (currentAnimation) {
+        currentAnimation->preparePose(pose);
+        currentAnimation->prepareCursor(cursor);
+        currentAnimation->prepareKeyBatch(keyBatch);
+    }
+    
     // Apply initial pose immediately
     if (currentAnimation) {
         applyPoseAtCurrentTime();
     }
     
-    // Trigger animation start event
-    triggerEvent("onAnimationStart");
+    // Trigger animation start event, then clip events keyed at time 0
+    triggerEvent(AnimationEvents::START);
+    if (currentAnimation) {
+        currentAnimation->forEachEvent(0.0f, 0.0f, true,
+                                       [this](AnimationEventID id) { triggerEvent(id); });
+    }
 }
 
 void AnimationPlayer::resume() {
@@ -230,16 +352,18 @@ void AnimationPlayer::pause() {
 void AnimationPlayer::stop() {
     isPlaying = false;
     currentTime = 0.0f;
+    prevTime = 0.0f;
+    pendingEvents.clear();
     
     // Trigger animation stop event
-    triggerEvent("onAnimationStop");
+    triggerEvent(AnimationEvents::STOP);
 }
 
 void AnimationPlayer::setPlaybackSpeed(float speed) {
     playbackSpeed = std::max(0.01f, speed);  // Prevent negative or zero speed
 }
 
-Animation* AnimationPlayer::getCurrentAnimation() const {
+AnimationClip* AnimationPlayer::getCurrentAnimation() const {
     return currentAnimation;
 }
 
@@ -263,41 +387,73 @@ void AnimationPlayer::setTime(float time) {
         return;
     }
     
+    // Seeking jumps without firing the events in between
     currentTime = std::max(0.0f, std::min(time, currentAnimation->duration));
+    prevTime = currentTime;
     applyPoseAtCurrentTime();
 }
 
 void AnimationPlayer::registerEventCallback(const std::string& eventName, AnimEventCallback callback) {
-    eventCallbacks[eventName] = callback;
+    registerEventCallback(AnimationEvents::intern(eventName), std::move(callback));
+}
+
+void AnimationPlayer::registerEventCallback(AnimationEventID eventID, AnimEventCallback callback) {
+    if (eventID >= eventCallbacks.size()) {
+        eventCallbacks.resize(eventID + 1);
+    }
+    eventCallbacks[eventID] = std::move(callback);
 }
 
 void AnimationPlayer::update(float deltaTime) {
-    if (!isPlaying || !currentAnimation) return;
+    if (!advanceTime(deltaTime)) return;
     
-    // Store previous time for event triggers
-    float prevTime = currentTime;
+    // Trigger crossed clip events and completion/loop before the new pose is applied
+    dispatchPendingEvents();
+    
+    // Apply current pose
+    applyPoseAtCurrentTime();
+}
+
+bool AnimationPlayer::advanceTime(float deltaTime) {
+    if (!isPlaying || !currentAnimation) return false;
     
     // Update time with speed factor
+    const float duration = currentAnimation->duration;
+    prevTime = currentTime;
     currentTime += deltaTime * playbackSpeed;
     
-    // Handle animation completion
-    if (currentTime >= currentAnimation->duration) {
-        // Trigger completion event before looping or stopping
-        triggerEvent("onAnimationComplete");
-        
-        if (looping) {
-            // For looping, wrap around to beginning
-            currentTime = fmod(currentTime, currentAnimation->duration);
-            triggerEvent("onAnimationLoop");
-        } else {
-            // For non-looping, clamp to end and stop
-            currentTime = currentAnimation->duration;
-            isPlaying = false;
+    if (currentTime < duration) {
+        queueClipEvents(prevTime, currentTime, false);
+        return true;
+    }
+    
+    // Handle animation completion: events up to the end fire before completion
+    queueClipEvents(prevTime, duration, false);
+    pendingEvents.push_back(AnimationEvents::COMPLETE);
+    
+    if (looping && duration > 0.0f) {
+        // For looping, wrap around to beginning. A long frame can skip whole loops;
+        // each one still fires its events and completion (capped so a stall cannot flood)
+        pendingEvents.push_back(AnimationEvents::LOOP);
+        float wrappedTime = fmod(currentTime, duration);
+        int skippedLoops = std::min(static_cast<int>(currentTime / duration) - 1, 4);
+        for (int i = 0; i < skippedLoops; i++) {
+            queueClipEvents(0.0f, duration, true);
+            pendingEvents.push_back(AnimationEvents::COMPLETE);
+            pendingEvents.push_back(AnimationEvents::LOOP);
         }
+        
+        // The new pass starts at time 0, so events keyed at 0 fire too
+        queueClipEvents(0.0f, wrappedTime, true);
+        prevTime = 0.0f;
+        currentTime = wrappedTime;
+    } else {
+        // For non-looping, clamp to end and stop
+        currentTime = duration;
+        isPlaying = false;
     }
     
-    // Apply current pose
-    applyPoseAtCurrentTime();
+    return true;
 }
 
 void AnimationPlayer::applyPoseAtCurrentTime() {
@@ -305,63 +461,186 @@ void AnimationPlayer::applyPoseAtCurrentTime() {
         return;
     }
     
-    // Get interpolated bone rotations
-    std::map<int, Quaternion> boneRotations = 
-        currentAnimation->getBoneRotationsAtTime(currentTime);
+    // Sample interpolated bone rotations into the reusable pose buffer
+    currentAnimation->sample(currentTime, pose, &cursor);
+    poseStale = false;
     
     // Apply rotations to bones in target object
-    target->updateBoneRotations(boneRotations);
+    applyPose(pose);
 }
 
-void AnimationPlayer::triggerEvent(const std::string& eventName) {
-    auto it = eventCallbacks.find(eventName);
-    if (it != eventCallbacks.end() && it->second) {
-        it->second(this, eventName);
+void AnimationPlayer::applyPose(AnimationPose& sampled) {
+    if (poseModifier) {
+        poseModifier(this, sampled);
     }
+    target->updateBoneRotations(sampled.rotations, sampled.animated);
 }
 
-// AnimationManager Implementation
-AnimationManager::~AnimationManager() {
-    // Clean up animation players
-    for (auto& pair : players) {
-        delete pair.second;
+void AnimationPlayer::applyBatchedPose() {
+    if (!currentAnimation || !target) {
+        return;
+    }
+    
+    // Touches only this player and its target, so players can run on different threads
+    currentAnimation->gatherKeys(currentTime, &cursor, keyBatch);
+    
+    // Distant skeletons skip the outer bones; they keep their last sampled rotation.
+    // After a shared pose the buffer is out of date, so every bone is sampled once.
+    if (lod == AnimationLOD::Distant && !poseStale) {
+        keyBatch.retain(lodBoneMask);
+    }
+    
+    AnimationClip::interpolateBatch(keyBatch, pose, currentAnimation->interpolationMode);
+    poseStale = false;
+    applyPose(pose);
+}
+
+void AnimationPlayer::sampleSharedPose(AnimationPose& shared) {
+    // The key batch and cursor are this player's scratch; the pose belongs to the group
+    currentAnimation->sampleBatched(currentTime, shared, &cursor, keyBatch);
+}
+
+void AnimationPlayer::applySharedPose(const AnimationPose& shared) {
+    if (!target) {
+        return;
+    }
+    
+    if (poseModifier) {
+        // Copy-on-write: the modifier edits a private copy, never the shared buffer.
+        // Same-size vector assignment reuses the existing storage.
+        pose.rotations = shared.rotations;
+        pose.animated = shared.animated;
+        applyPose(pose);
+        poseStale = false;
+        return;
+    }
+    
+    target->updateBoneRotations(shared.rotations, shared.animated);
+    poseStale = true;
+}
+
+void AnimationPlayer::setLOD(AnimationLOD level, int maxBoneDepth) {
+    lod = level;
+    if (level == AnimationLOD::Distant && maxBoneDepth != lodBoneDepth) {
+        buildLODBoneMask(maxBoneDepth);
     }
-    players.clear();
 }
 
+void AnimationPlayer::buildLODBoneMask(int maxBoneDepth) {
+    lodBoneDepth = maxBoneDepth;
+    size_t boneCount = target ? target->getBoneCount() : 0;
+    lodBoneMask.assign(boneCount, 0);
+    
+    for (size_t i = 0; i < boneCount; i++) {
+        // Count hierarchy levels up to a root (bounded in case of bad parent data)
+        int depth = 0;
+        int parent = target->getBoneParent(i);
+        while (parent >= 0 && depth <= maxBoneDepth) {
+            parent = target->getBoneParent(static_cast<size_t>(parent));
+            depth++;
+        }
+        lodBoneMask[i] = depth <= maxBoneDepth ? 1 : 0;
+    }
+}
+
+bool AnimationPlayer::getLODSphere(glm::vec3& center, float& radius) {
+    if (!target) {
+        return false;
+    }
+    
+    // Measure the bounds once; animation moves bones, not the overall extent
+    if (lodRadius < 0.0f) {
+        const AABB& bounds = target->getBoundingBox();
+        lodCenterOffset = bounds.getCenter() - target->getPosition();
+        lodRadius = glm::length(bounds.getExtents());
+    }
+    
+    center = target->getPosition() + lodCenterOffset;
+    radius = lodRadius;
+    return true;
+}
+
+void AnimationPlayer::queueClipEvents(float begin, float end, bool includeBegin) {
+    currentAnimation->forEachEvent(begin, end, includeBegin,
+                                   [this](AnimationEventID id) { pendingEvents.push_back(id); });
+}
+
+void AnimationPlayer::dispatchPendingEvents() {
+    // Nothing queued, or already dispatching further up the stack
+    if (pendingEvents.empty() || !dispatchingEvents.empty()) {
+        return;
+    }
+    
+    // Callbacks may play or stop this player, which touches pendingEvents; dispatch from a swapped copy
+    dispatchingEvents.swap(pendingEvents);
+    for (AnimationEventID id : dispatchingEvents) {
+        triggerEvent(id);
+    }
+    dispatchingEvents.clear();
+}
+
+void AnimationPlayer::triggerEvent(AnimationEventID eventID) {
+    // Flat table lookup; the name is only resolved when a callback is registered
+    if (eventID < eventCallbacks.size() && eventCallbacks[eventID]) {
+        eventCallbacks[eventID](this, AnimationEvents::getName(eventID));
+    }
+}
+
+// AnimationManager Implementation
+AnimationManager::AnimationManager(JobSystem* jobSystem)
+    : jobSystem(jobSystem), lodCamera(nullptr), frameIndex(0),
+      poseCacheQuantum(1.0f / 240.0f), sharedPoseCount(0) {}
+
+AnimationManager::~AnimationManager() {}
+
 bool AnimationManager::loadAnimation(const std::string& name, const std::string& filename) {
-    Animation animation = Animation::loadFromFile(filename);
-    if (animation.duration <= 0.0f) {
+    std::unique_ptr<AnimationClip> clip;
+    
+    // Compressed clips are recognised by extension
+    const std::string compressedExtension = ".canim";
+    if (filename.size() >= compressedExtension.size() &&
+        filename.compare(filename.size() - compressedExtension.size(), compressedExtension.size(), compressedExtension) == 0) {
+        std::unique_ptr<CompressedAnimation> compressed(new CompressedAnimation());
+        if (!CompressedAnimation::loadFromFile(filename, *compressed)) {
+            compressed.reset();
+        }
+        clip = std::move(compressed);
+    } else {
+        clip.reset(new Animation(Animation::loadFromFile(filename)));
+    }
+    
+    if (!clip || clip->duration <= 0.0f) {
         std::cerr << "Failed to load animation: " << filename << std::endl;
         return false;
     }
     
-    animations[name] = animation;
+    animations[name] = std::move(clip);
     return true;
 }
 
-Animation* AnimationManager::getAnimation(const std::string& name) {
+AnimationClip* AnimationManager::getAnimation(const std::string& name) {
     auto it = animations.find(name);
     if (it != animations.end()) {
-        return &it->second;
+        return it->second.get();
     }
     return nullptr;
 }
 
 AnimationPlayer* AnimationManager::getPlayer(GameObject* object) {
-    auto it = players.find(object);
-    if (it != players.end()) {
+    auto it = playerLookup.find(object);
+    if (it != playerLookup.end()) {
         return it->second;
     }
     
-    // Create new player if none exists
-    AnimationPlayer* player = new AnimationPlayer(object);
-    players[object] = player;
+    // Create new player if none exists (deque keeps existing players in place)
+    players.emplace_back(object);
+    AnimationPlayer* player = &players.back();
+    playerLookup[object] = player;
     return player;
 }
 
 void AnimationManager::playAnimation(GameObject* object, const std::string& animName, bool loop) {
-    Animation* anim = getAnimation(animName);
+    AnimationClip* anim = getAnimation(animName);
     if (!anim) {
         std::cerr << "Animation not found: " << animName << std::endl;
         return;
@@ -371,8 +650,192 @@ void AnimationManager::playAnimation(GameObject* object, const std::string& anim
     player->play(anim, loop);
 }
 
+void AnimationManager::setLODCamera(const Camera* camera) {
+    lodCamera = camera;
+}
+
+AnimationLOD AnimationManager::selectLOD(AnimationPlayer& player) {
+    glm::vec3 center;
+    float radius;
+    if (!lodCamera || !player.getLODSphere(center, radius)) {
+        return AnimationLOD::Full;
+    }
+    
+    if (!lodFrustum.containsSphere(center, radius)) {
+        return AnimationLOD::Culled;
+    }
+    
+    float distance = glm::length(center - lodCamera->getPosition());
+    if (distance <= radius) {
+        return AnimationLOD::Full;
+    }
+    
+    // Fraction of the viewport height covered by the bounding sphere
+    float halfHeight = distance * std::tan(glm::radians(lodCamera->getFOV()) * 0.5f);
+    float screenSize = radius / halfHeight;
+    
+    if (screenSize >= lodSettings.reducedScreenSize) {
+        return AnimationLOD::Full;
+    }
+    if (screenSize >= lodSettings.distantScreenSize) {
+        return AnimationLOD::Reduced;
+    }
+    return AnimationLOD::Distant;
+}
+
 void AnimationManager::update(float deltaTime) {
-    for (auto& pair : players) {
-        pair.second->update(deltaTime);
+    PROFILE_ZONE("AnimationManager::update");
+    lodStats = AnimationLODStats();
+    if (lodCamera) {
+        lodFrustum.updateFromCamera(*lodCamera);
+    }
+    
+    // Advance clocks and collect the players that need a new pose this frame
+    activePlayers.clear();
+    uint32_t playerIndex = 0;
+    for (AnimationPlayer& player : players) {
+        uint32_t phase = playerIndex++;
+        if (!player.advanceTime(deltaTime)) {
+            continue;
+        }
+        
+        AnimationLOD level = selectLOD(player);
+        player.setLOD(level, lodSettings.distantBoneDepth);
+        
+        bool evaluate = true;
+        if (level == AnimationLOD::Culled) {
+            evaluate = false;
+        } else if (level != AnimationLOD::Full) {
+            // Throttled players are spread over frames by their index so the cost stays even
+            uint32_t interval = level == AnimationLOD::Reduced ? lodSettings.reducedInterval : lodSettings.distantInterval;
+            evaluate = interval <= 1 || (frameIndex + phase) % interval == 0;
+        }
+        
+        if (!evaluate) {
+            lodStats.notEvaluated++;
+            continue;
+        }
+        
+        if (level == AnimationLOD::Distant) {
+            lodStats.partiallyEvaluated++;
+        } else {
+            lodStats.fullyEvaluated++;
+        }
+        activePlayers.push_back(&player);
+    }
+    frameIndex++;
+    
+    buildPoseShares();
+    
+    // Sample unshared players and shared poses; each job only touches its own player and buffer
+    const size_t ownPoses = activePlayers.size();
+    auto sampleRange = [this, ownPoses](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (i < ownPoses) {
+                activePlayers[i]->applyBatchedPose();
+            } else {
+                SharedPose& shared = sharedPoses[i - ownPoses];
+                shared.sampler->sampleSharedPose(shared.pose);
+            }
+        }
+    };
+    
+    // Then hand the shared poses to their players
+    auto shareRange = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sharedPoseUsers[i].first->applySharedPose(sharedPoses[sharedPoseUsers[i].second].pose);
+        }
+    };
+    
+    if (jobSystem) {
+        jobSystem->parallelFor(ownPoses + sharedPoseCount, PLAYERS_PER_JOB, sampleRange);
+        jobSystem->parallelFor(sharedPoseUsers.size(), PLAYERS_PER_JOB, shareRange);
+    } else {
+        sampleRange(0, ownPoses + sharedPoseCount);
+        shareRange(0, sharedPoseUsers.size());
     }
-}
\ No newline at end of file
+    
+    // Callbacks run on the calling thread once every pose is in place.
+    // Skipped players still advanced their clocks, so every player is checked.
+    for (AnimationPlayer& player : players) {
+        player.dispatchPendingEvents();
+    }
+}
+
+void AnimationManager::buildPoseShares() {
+    poseCacheStats = AnimationPoseCacheStats();
+    sharedPoseCount = 0;
+    sharedPoseUsers.clear();
+    
+    if (poseCacheQuantum <= 0.0f || activePlayers.size() < 2) {
+        poseCacheStats.misses = activePlayers.size();
+        return;
+    }
+    
+    // Distant players sample a bone subset, so only full poses are shared
+    poseShareKeys.clear();
+    size_t ownPoses = 0;
+    for (AnimationPlayer* player : activePlayers) {
+        if (player->getLOD() == AnimationLOD::Distant) {
+            activePlayers[ownPoses++] = player;
+        } else {
+            uint32_t timeStep = static_cast<uint32_t>(player->getCurrentTime() / poseCacheQuantum);
+            poseShareKeys.push_back(PoseShareKey{player->getCurrentAnimation(), timeStep, player});
+        }
+    }
+    
+    std::sort(poseShareKeys.begin(), poseShareKeys.end(), [](const PoseShareKey& a, const PoseShareKey& b) {
+        if (a.clip != b.clip) return std::less<const AnimationClip*>()(a.clip, b.clip);
+        return a.timeStep < b.timeStep;
+    });
+    
+    // Runs of equal keys become one shared pose; single players keep sampling their own
+    for (size_t first = 0; first < poseShareKeys.size();) {
+        size_t last = first + 1;
+        while (last < poseShareKeys.size() && poseShareKeys[last].clip == poseShareKeys[first].clip &&
+               poseShareKeys[last].timeStep == poseShareKeys[first].timeStep) {
+            last++;
+        }
+        
+        if (last - first == 1) {
+            activePlayers[ownPoses++] = poseShareKeys[first].player;
+        } else {
+            if (sharedPoseCount == sharedPoses.size()) {
+                sharedPoses.emplace_back();
+            }
+            SharedPose& shared = sharedPoses[sharedPoseCount];
+            
+            // A buffer last used by another clip may flag bones this clip does not animate
+            const AnimationClip* clip = poseShareKeys[first].clip;
+            if (shared.clip != clip) {
+                shared.pose.resize(clip->getPoseSize());
+                shared.clip = clip;
+            }
+            shared.sampler = poseShareKeys[first].player;
+            
+            for (size_t i = first; i < last; i++) {
+                sharedPoseUsers.emplace_back(poseShareKeys[i].player, static_cast<uint32_t>(sharedPoseCount));
+                if (poseShareKeys[i].player->hasPoseModifier()) {
+                    poseCacheStats.copies++;
+                }
+            }
+            poseCacheStats.hits += last - first - 1;
+            sharedPoseCount++;
+        }
+        first = last;
+    }
+    
+    activePlayers.resize(ownPoses);
+    poseCacheStats.misses = ownPoses + sharedPoseCount;
+}
+
+void AnimationPoseCacheStats::print(std::ostream& out) const {
+    out << "Animation pose cache: " << hits << " hits, " << misses << " misses, "
+        << copies << " copies" << std::endl;
+}
+
+void AnimationLODStats::print(std::ostream& out) const {
+    out << "Animation LOD: " << fullyEvaluated << " full, "
+        << partiallyEvaluated << " partial, "
+        << notEvaluated << " skipped" << std::endl;
+}
@@ -0,0 +1,229 @@
+#include "AudioBus.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define AUDIO_BUS_SSE 1
+#endif
+
+// Reverb tunings at 44.1 kHz (Freeverb's first four combs); the right channel is spread wider
+static const int REVERB_COMB_TUNING[] = { 1116, 1188, 1277, 1356 };
+static const int REVERB_ALLPASS_TUNING[] = { 556, 441 };
+static const int REVERB_STEREO_SPREAD = 23;
+static const float REVERB_INPUT_GAIN = 0.03f;
+static const float REVERB_TAIL_SECONDS = 4.0f;     // Keep running this long after the last send
+
+// Default dynamics: the SFX bus evens out stacked one-shots, the master never clips
+static const CompressorSettings SFX_COMPRESSOR = { -10.0f, 4.0f, 2.0f, 150.0f, 0.0f };
+static const float MASTER_CEILING_DB = -1.0f;
+
+CompressorSettings CompressorSettings::limiter(float ceilingDb) {
+    CompressorSettings settings;
+    settings.thresholdDb = ceilingDb;
+    settings.ratio = std::numeric_limits<float>::infinity();
+    settings.attackMs = 0.0f;
+    settings.releaseMs = 80.0f;
+    return settings;
+}
+
+Compressor::Compressor(const CompressorSettings& settings, int sampleRate)
+    : sampleRate(std::max(1, sampleRate)), envelope(0.0f), gainReductionDb(0.0f) {
+    setSettings(settings);
+}
+
+void Compressor::setSettings(const CompressorSettings& settings) {
+    auto coefficient = [&](float milliseconds) {
+        return milliseconds > 0.0f ? std::exp(-1.0f / (milliseconds * 0.001f * sampleRate)) : 0.0f;
+    };
+    threshold = std::pow(10.0f, settings.thresholdDb / 20.0f);
+    slope = settings.ratio > 1.0f ? 1.0f - 1.0f / settings.ratio : 0.0f;
+    makeup = std::pow(10.0f, settings.makeupDb / 20.0f);
+    attack = coefficient(settings.attackMs);
+    release = coefficient(settings.releaseMs);
+}
+
+void Compressor::process(float* buffer, size_t frames, float* levels, float* gains, unsigned maxLanes) {
+    AudioKernels::stereoPeak(buffer, levels, frames, maxLanes);
+    
+    // The envelope is serial; level detection and gain application around it are SIMD
+    float deepest = 1.0f;
+    bool changed = makeup != 1.0f;
+    for (size_t i = 0; i < frames; i++) {
+        const float level = levels[i];
+        envelope = level + (level > envelope ? attack : release) * (envelope - level);
+        float gain = 1.0f;
+        if (envelope > threshold) {
+            gain = std::exp2(slope * std::log2(threshold / envelope));
+            deepest = std::min(deepest, gain);
+            changed = true;
+        }
+        gains[i] = gain * makeup;
+    }
+    gainReductionDb = 20.0f * std::log10(deepest);
+    
+    if (changed) {
+        AudioKernels::applyFrameGains(buffer, gains, frames, maxLanes);
+    }
+}
+
+Reverb::Reverb(int sampleRate) : feedback(0.84f), damping(0.2f) {
+    const double scale = sampleRate / 44100.0;
+    for (int channel = 0; channel < 2; channel++) {
+        const int spread = channel * REVERB_STEREO_SPREAD;
+        for (int i = 0; i < COMBS; i++) {
+            combs[channel][i].buffer.assign(static_cast<size_t>((REVERB_COMB_TUNING[i] + spread) * scale) + 1, 0.0f);
+        }
+        for (int i = 0; i < ALLPASSES; i++) {
+            allpasses[channel][i].buffer.assign(static_cast<size_t>((REVERB_ALLPASS_TUNING[i] + spread) * scale) + 1, 0.0f);
+        }
+    }
+}
+
+void Reverb::process(const float* input, float* output, size_t frames) {
+    for (size_t frame = 0; frame < frames; frame++) {
+        const float in = (input[2 * frame] + input[2 * frame + 1]) * REVERB_INPUT_GAIN;
+        for (int channel = 0; channel < 2; channel++) {
+            // Parallel damped combs
+            float sum = 0.0f;
+            for (Comb& comb : combs[channel]) {
+                const float delayed = comb.buffer[comb.index];
+                comb.damped = delayed * (1.0f - damping) + comb.damped * damping;
+                comb.buffer[comb.index] = in + comb.damped * feedback;
+                comb.index = comb.index + 1 == comb.buffer.size() ? 0 : comb.index + 1;
+                sum += delayed;
+            }
+            
+            // Serial allpasses diffuse the echoes
+            for (Allpass& allpass : allpasses[channel]) {
+                const float delayed = allpass.buffer[allpass.index];
+                allpass.buffer[allpass.index] = sum + delayed * 0.5f;
+                allpass.index = allpass.index + 1 == allpass.buffer.size() ? 0 : allpass.index + 1;
+                sum = delayed - sum;
+            }
+            output[2 * frame + channel] += sum;
+        }
+    }
+}
+
+AudioBusGraph::AudioBusGraph(int sampleRate, size_t maxFrames)
+    : sampleRate(std::max(1, sampleRate)),
+      maxFrames(std::max<size_t>(1, maxFrames)),
+      frames(0),
+      buses(BUS_COUNT, Bus(sampleRate)),
+      reverbInput(BLOCK_FRAMES * 2),
+      levels(BLOCK_FRAMES),
+      gains(BLOCK_FRAMES),
+      reverb(sampleRate),
+      reverbIdleFrames(std::numeric_limits<size_t>::max() / 2),
+      limiter(CompressorSettings::limiter(MASTER_CEILING_DB), sampleRate) {
+    for (Bus& each : buses) {
+        each.input.resize(this->maxFrames * 2);
+    }
+    setCompressor(AudioBusID::SFX, true, SFX_COMPRESSOR);
+}
+
+void AudioBusGraph::begin(size_t frames) {
+    this->frames = std::min(frames, maxFrames);
+    for (Bus& each : buses) {
+        each.used = false;
+    }
+}
+
+float* AudioBusGraph::getInput(AudioBusID id) {
+    // Cleared on first use so buses nothing plays on cost nothing
+    Bus& target = bus(id);
+    if (!target.used) {
+        std::fill(target.input.begin(), target.input.begin() + frames * 2, 0.0f);
+        target.used = true;
+    }
+    return target.input.data();
+}
+
+void AudioBusGraph::render(float* output, unsigned maxLanes) {
+    PROFILE_ZONE("AudioBusGraph::render");
+
+#if defined(AUDIO_BUS_SSE)
+    // Decaying filter and reverb state must not fall into slow denormals
+    const unsigned int savedCsr = _mm_getcsr();
+    _mm_setcsr(savedCsr | 0x8040);     // Flush-to-zero and denormals-are-zero
+#endif
+
+    const size_t reverbTailFrames = static_cast<size_t>(REVERB_TAIL_SECONDS * sampleRate);
+    for (size_t start = 0; start < frames; start += BLOCK_FRAMES) {
+        const size_t count = std::min(BLOCK_FRAMES, frames - start);
+        float* master = output + start * 2;
+        std::fill(master, master + count * 2, 0.0f);
+        std::fill(reverbInput.begin(), reverbInput.begin() + count * 2, 0.0f);
+        bool reverbFed = false;
+        
+        for (Bus& each : buses) {
+            // Gain and send move to their targets over one block
+            const float gainFrom = each.appliedGain;
+            const float sendFrom = each.appliedSend;
+            each.appliedGain = each.gain;
+            each.appliedSend = each.send;
+            if (!each.used) {
+                // Silent bus: nothing to filter, and its filter restarts from silence
+                each.filterState = AudioKernels::BiquadState();
+                continue;
+            }
+            
+            float* block = each.input.data() + start * 2;
+            if (each.cutoff > 0.0f) {
+                if (each.cutoff != each.filterCutoff) {
+                    each.coefficients = AudioKernels::lowPassCoefficients(each.cutoff, 0.7071f, sampleRate);
+                    each.filterCutoff = each.cutoff;
+                }
+                AudioKernels::biquadStereo(block, count, each.coefficients, each.filterState, maxLanes);
+            } else {
+                each.filterState = AudioKernels::BiquadState();
+            }
+            if (each.compress) {
+                each.compressor.process(block, count, levels.data(), gains.data(), maxLanes);
+            }
+            
+            if (gainFrom > 0.0f || each.appliedGain > 0.0f) {
+                AudioKernels::mixStereo(block, master, count, AudioKernels::StereoGain{ gainFrom, gainFrom },
+                                        AudioKernels::StereoGain{ each.appliedGain, each.appliedGain }, maxLanes);
+            }
+            if (sendFrom > 0.0f || each.appliedSend > 0.0f) {
+                AudioKernels::mixStereo(block, reverbInput.data(), count, AudioKernels::StereoGain{ sendFrom, sendFrom },
+                                        AudioKernels::StereoGain{ each.appliedSend, each.appliedSend }, maxLanes);
+                reverbFed = true;
+            }
+        }
+        
+        // The reverb stops once its tail has died away
+        reverbIdleFrames = reverbFed ? 0 : reverbIdleFrames + count;
+        if (reverbIdleFrames < reverbTailFrames) {
+            reverb.process(reverbInput.data(), master, count);
+        }
+        
+        limiter.process(master, count, levels.data(), gains.data(), maxLanes);
+    }
+
+#if defined(AUDIO_BUS_SSE)
+    _mm_setcsr(savedCsr);
+#endif
+}
+
+void AudioBusGraph::setGain(AudioBusID id, float gain) {
+    bus(id).gain = std::max(0.0f, gain);
+}
+
+void AudioBusGraph::setLowPass(AudioBusID id, float cutoff) {
+    bus(id).cutoff = std::max(0.0f, cutoff);
+}
+
+void AudioBusGraph::setReverbSend(AudioBusID id, float send) {
+    bus(id).send = std::max(0.0f, std::min(send, 1.0f));
+}
+
+void AudioBusGraph::setCompressor(AudioBusID id, bool enabled, const CompressorSettings& settings) {
+    Bus& target = bus(id);
+    target.compress = enabled;
+    target.compressor.setSettings(settings);
+}
@@ -0,0 +1,109 @@
+#include "AudioInstrumentation.hpp"
+#include <algorithm>
+#include <iomanip>
+
+// Single writer: plain load + store instead of a locked read-modify-write
+static inline void increment(std::atomic<uint64_t>& value, uint64_t amount = 1) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+static double bucketUpperMicros(int bucket) {
+    return static_cast<double>(uint64_t(1) << bucket);
+}
+
+TimingHistogram::TimingHistogram() : count(0), totalNanos(0), maxNanos(0) {
+    for (std::atomic<uint64_t>& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TimingHistogram::record(uint64_t nanoseconds) {
+    // Bucket b holds [2^(b-1), 2^b) microseconds; bucket 0 everything under 1 us
+    uint64_t micros = nanoseconds / 1000;
+    int bucket = 0;
+    while (micros > 0 && bucket < BUCKETS - 1) {
+        micros >>= 1;
+        bucket++;
+    }
+    increment(buckets[bucket]);
+    increment(count);
+    increment(totalNanos, nanoseconds);
+    if (nanoseconds > maxNanos.load(std::memory_order_relaxed)) {
+        maxNanos.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+double TimingHistogram::getMeanMicros() const {
+    const uint64_t samples = getCount();
+    return samples > 0 ? totalNanos.load(std::memory_order_relaxed) / 1000.0 / samples : 0.0;
+}
+
+double TimingHistogram::getPercentileMicros(double fraction) const {
+    const uint64_t samples = getCount();
+    if (samples == 0) return 0.0;
+    
+    const double wanted = fraction * samples;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS - 1; bucket++) {
+        seen += buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= wanted) {
+            return std::min(bucketUpperMicros(bucket), getMaxMicros());
+        }
+    }
+    return getMaxMicros();
+}
+
+void TimingHistogram::print(const std::string& label, std::ostream& out) const {
+    std::ios::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+    
+    out << std::left << std::setw(16) << label << std::setw(10) << getCount() << std::fixed << std::setprecision(1)
+        << std::setw(12) << getMeanMicros() << std::setw(12) << getPercentileMicros(0.5)
+        << std::setw(12) << getPercentileMicros(0.99) << getMaxMicros() << std::endl;
+    
+    // Non-empty buckets as "<upper edge us: count"
+    out << std::setw(16) << "";
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        const uint64_t samples = buckets[bucket].load(std::memory_order_relaxed);
+        if (samples == 0) continue;
+        if (bucket == BUCKETS - 1) {
+            out << " >=" << std::setprecision(0) << bucketUpperMicros(bucket - 1) << ":" << samples;
+        } else {
+            out << " <" << std::setprecision(0) << bucketUpperMicros(bucket) << ":" << samples;
+        }
+    }
+    out << std::endl;
+    
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
+
+AudioInstrumentation::AudioInstrumentation() : deadlineMisses(0), streamUnderruns(0), budgetNanos(0) {}
+
+void AudioInstrumentation::recordCallback(uint64_t durationNanos, size_t frames, int sampleRate,
+                                          uint64_t streamUnderrunTotal) {
+    const uint64_t budget = static_cast<uint64_t>(frames) * 1000000000ull / static_cast<uint64_t>(sampleRate);
+    callbackTimes.record(durationNanos);
+    if (durationNanos > budget) {
+        increment(deadlineMisses);
+    }
+    streamUnderruns.store(streamUnderrunTotal, std::memory_order_relaxed);
+    budgetNanos.store(budget, std::memory_order_relaxed);
+}
+
+void AudioInstrumentation::print(std::ostream& out) const {
+    std::ios::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+    
+    out << "Audio callback instrumentation (histogram buckets in us)" << std::endl;
+    out << std::left << std::setw(16) << "" << std::setw(10) << "count" << std::setw(12) << "mean us"
+        << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << "max us" << std::endl;
+    callbackTimes.print("callback", out);
+    playLatency.print("play latency", out);
+    out << "Deadline misses: " << getDeadlineMissCount() << " of " << getCallbackCount() << " callbacks (budget "
+        << std::fixed << std::setprecision(1) << budgetNanos.load(std::memory_order_relaxed) / 1000.0 << " us)" << std::endl;
+    out << "Stream underruns: " << getStreamUnderrunCount() << std::endl;
+    
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
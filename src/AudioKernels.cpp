@@ -0,0 +1,662 @@
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <random>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define AUDIO_KERNELS_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AUDIO_KERNELS_SSE 1
+#endif
+
+namespace AudioKernels {
+    static const double PI = 3.14159265358979323846;
+    
+    // Resampler kernel: phases per input sample and sinc zero crossings per side
+    static const int RESAMPLE_PHASES = 256;
+    static const int RESAMPLE_ZERO_CROSSINGS = 16;
+    
+    StereoGain equalPowerPan(float pan, float gain) {
+        float angle = (std::max(-1.0f, std::min(pan, 1.0f)) + 1.0f) * static_cast<float>(PI * 0.25);
+        return StereoGain{ std::cos(angle) * gain, std::sin(angle) * gain };
+    }
+    
+    void s16ToFloat(const int16_t* in, float* out, size_t count, unsigned maxLanes) {
+        const float scale = 1.0f / 32768.0f;
+        size_t i = 0;
+        
+        // Integer widening needs AVX2 for 8 lanes, so SSE2 covers both SIMD widths
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            const __m128 scaleVector = _mm_set1_ps(scale);
+            for (; i + 8 <= count; i += 8) {
+                __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                // Sign-extend by placing each sample in the top half of a 32-bit lane
+                __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+                __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scaleVector));
+                _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scaleVector));
+            }
+        }
+#endif
+
+        for (; i < count; i++) {
+            out[i] = in[i] * scale;
+        }
+    }
+    
+    void floatToS16(const float* in, int16_t* out, size_t count, unsigned maxLanes) {
+        size_t i = 0;
+
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8) {
+            const __m256 low = _mm256_set1_ps(-1.0f);
+            const __m256 high = _mm256_set1_ps(1.0f);
+            const __m256 scale = _mm256_set1_ps(32767.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m256 samples = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), low), high);
+                __m256i rounded = _mm256_cvtps_epi32(_mm256_mul_ps(samples, scale));
+                __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extractf128_si256(rounded, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+            }
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            const __m128 low = _mm_set1_ps(-1.0f);
+            const __m128 high = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(32767.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), low), high);
+                __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), low), high);
+                __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)),
+                                                 _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+            }
+        }
+#endif
+
+        for (; i < count; i++) {
+            float sample = std::max(-1.0f, std::min(in[i], 1.0f));
+            out[i] = static_cast<int16_t>(std::lrint(sample * 32767.0f));
+        }
+    }
+    
+    void mixMonoToStereo(const float* in, float* out, size_t frames,
+                         StereoGain start, StereoGain end, unsigned maxLanes) {
+        if (frames == 0) return;
+        const float stepLeft = (end.left - start.left) / frames;
+        const float stepRight = (end.right - start.right) / frames;
+        size_t i = 0;
+
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8) {
+            // Four frames per step: gains are [L0 R0 L1 R1 L2 R2 L3 R3]
+            __m256 gain = _mm256_setr_ps(start.left, start.right,
+                                         start.left + stepLeft, start.right + stepRight,
+                                         start.left + 2.0f * stepLeft, start.right + 2.0f * stepRight,
+                                         start.left + 3.0f * stepLeft, start.right + 3.0f * stepRight);
+            const __m256 gainStep = _mm256_setr_ps(4.0f * stepLeft, 4.0f * stepRight, 4.0f * stepLeft, 4.0f * stepRight,
+                                                   4.0f * stepLeft, 4.0f * stepRight, 4.0f * stepLeft, 4.0f * stepRight);
+            for (; i + 4 <= frames; i += 4) {
+                __m128 mono = _mm_loadu_ps(in + i);
+                __m256 samples = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(mono, mono)),
+                                                      _mm_unpackhi_ps(mono, mono), 1);
+                __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(out + 2 * i), _mm256_mul_ps(samples, gain));
+                _mm256_storeu_ps(out + 2 * i, mixed);
+                gain = _mm256_add_ps(gain, gainStep);
+            }
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            // Two frames per step: gains are [L0 R0 L1 R1]
+            __m128 gain = _mm_setr_ps(start.left + i * stepLeft, start.right + i * stepRight,
+                                      start.left + (i + 1) * stepLeft, start.right + (i + 1) * stepRight);
+            const __m128 gainStep = _mm_setr_ps(2.0f * stepLeft, 2.0f * stepRight, 2.0f * stepLeft, 2.0f * stepRight);
+            for (; i + 2 <= frames; i += 2) {
+                __m128 mono = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in + i)));
+                __m128 samples = _mm_unpacklo_ps(mono, mono);
+                _mm_storeu_ps(out + 2 * i, _mm_add_ps(_mm_loadu_ps(out + 2 * i), _mm_mul_ps(samples, gain)));
+                gain = _mm_add_ps(gain, gainStep);
+            }
+        }
+#endif
+
+        for (; i < frames; i++) {
+            out[2 * i] += in[i] * (start.left + i * stepLeft);
+            out[2 * i + 1] += in[i] * (start.right + i * stepRight);
+        }
+    }
+    
+    void mixStereo(const float* in, float* out, size_t frames,
+                   StereoGain start, StereoGain end, unsigned maxLanes) {
+        if (frames == 0) return;
+        const float stepLeft = (end.left - start.left) / frames;
+        const float stepRight = (end.right - start.right) / frames;
+        size_t i = 0;
+
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8) {
+            __m256 gain = _mm256_setr_ps(start.left, start.right,
+                                         start.left + stepLeft, start.right + stepRight,
+                                         start.left + 2.0f * stepLeft, start.right + 2.0f * stepRight,
+                                         start.left + 3.0f * stepLeft, start.right + 3.0f * stepRight);
+            const __m256 gainStep = _mm256_setr_ps(4.0f * stepLeft, 4.0f * stepRight, 4.0f * stepLeft, 4.0f * stepRight,
+                                                   4.0f * stepLeft, 4.0f * stepRight, 4.0f * stepLeft, 4.0f * stepRight);
+            for (; i + 4 <= frames; i += 4) {
+                __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(out + 2 * i), _mm256_mul_ps(_mm256_loadu_ps(in + 2 * i), gain));
+                _mm256_storeu_ps(out + 2 * i, mixed);
+                gain = _mm256_add_ps(gain, gainStep);
+            }
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            __m128 gain = _mm_setr_ps(start.left + i * stepLeft, start.right + i * stepRight,
+                                      start.left + (i + 1) * stepLeft, start.right + (i + 1) * stepRight);
+            const __m128 gainStep = _mm_setr_ps(2.0f * stepLeft, 2.0f * stepRight, 2.0f * stepLeft, 2.0f * stepRight);
+            for (; i + 2 <= frames; i += 2) {
+                _mm_storeu_ps(out + 2 * i, _mm_add_ps(_mm_loadu_ps(out + 2 * i), _mm_mul_ps(_mm_loadu_ps(in + 2 * i), gain)));
+                gain = _mm_add_ps(gain, gainStep);
+            }
+        }
+#endif
+
+        for (; i < frames; i++) {
+            out[2 * i] += in[2 * i] * (start.left + i * stepLeft);
+            out[2 * i + 1] += in[2 * i + 1] * (start.right + i * stepRight);
+        }
+    }
+    
+    void resampleLinear(const float* in, int channels, float fraction, float rate,
+                        float* out, size_t frames, unsigned maxLanes) {
+        size_t i = 0;
+        
+        // Read positions come from i, not a running sum, so every width reads the same points.
+        // There is no gather before AVX2: the neighbours are loaded one by one, and the
+        // position math and interpolation run on whole registers.
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8 && (channels == 1 || channels == 2)) {
+            const __m256 start = _mm256_set1_ps(fraction);
+            const __m256 rateVector = _mm256_set1_ps(rate);
+            alignas(32) int32_t index[8];
+            if (channels == 1) {
+                const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+                for (; i + 8 <= frames; i += 8) {
+                    __m256 position = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lanes), rateVector));
+                    __m256i whole = _mm256_cvttps_epi32(position);
+                    __m256 t = _mm256_sub_ps(position, _mm256_cvtepi32_ps(whole));
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(index), whole);
+                    __m256 a = _mm256_setr_ps(in[index[0]], in[index[1]], in[index[2]], in[index[3]],
+                                              in[index[4]], in[index[5]], in[index[6]], in[index[7]]);
+                    __m256 b = _mm256_setr_ps(in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1],
+                                              in[index[4] + 1], in[index[5] + 1], in[index[6] + 1], in[index[7] + 1]);
+                    _mm256_storeu_ps(out + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t)));
+                }
+            } else {
+                // Four frames per step: positions are [p0 p0 p1 p1 p2 p2 p3 p3]
+                const __m256 lanes = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+                for (; i + 4 <= frames; i += 4) {
+                    __m256 position = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lanes), rateVector));
+                    __m256i whole = _mm256_cvttps_epi32(position);
+                    __m256 t = _mm256_sub_ps(position, _mm256_cvtepi32_ps(whole));
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(index), whole);
+                    const float* f0 = in + 2 * index[0];
+                    const float* f1 = in + 2 * index[2];
+                    const float* f2 = in + 2 * index[4];
+                    const float* f3 = in + 2 * index[6];
+                    __m256 a = _mm256_setr_ps(f0[0], f0[1], f1[0], f1[1], f2[0], f2[1], f3[0], f3[1]);
+                    __m256 b = _mm256_setr_ps(f0[2], f0[3], f1[2], f1[3], f2[2], f2[3], f3[2], f3[3]);
+                    _mm256_storeu_ps(out + 2 * i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t)));
+                }
+            }
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4 && (channels == 1 || channels == 2)) {
+            const __m128 start = _mm_set1_ps(fraction);
+            const __m128 rateVector = _mm_set1_ps(rate);
+            const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            alignas(16) int32_t index[4];
+            for (; i + 4 <= frames; i += 4) {
+                __m128 position = _mm_add_ps(start, _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lanes), rateVector));
+                __m128i whole = _mm_cvttps_epi32(position);
+                __m128 t = _mm_sub_ps(position, _mm_cvtepi32_ps(whole));
+                _mm_store_si128(reinterpret_cast<__m128i*>(index), whole);
+                if (channels == 1) {
+                    __m128 a = _mm_setr_ps(in[index[0]], in[index[1]], in[index[2]], in[index[3]]);
+                    __m128 b = _mm_setr_ps(in[index[0] + 1], in[index[1] + 1], in[index[2] + 1], in[index[3] + 1]);
+                    _mm_storeu_ps(out + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+                } else {
+                    // Two frames per register: [L0 R0 L1 R1] then [L2 R2 L3 R3]
+                    const float* f0 = in + 2 * index[0];
+                    const float* f1 = in + 2 * index[1];
+                    const float* f2 = in + 2 * index[2];
+                    const float* f3 = in + 2 * index[3];
+                    __m128 a = _mm_setr_ps(f0[0], f0[1], f1[0], f1[1]);
+                    __m128 b = _mm_setr_ps(f0[2], f0[3], f1[2], f1[3]);
+                    _mm_storeu_ps(out + 2 * i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_unpacklo_ps(t, t))));
+                    a = _mm_setr_ps(f2[0], f2[1], f3[0], f3[1]);
+                    b = _mm_setr_ps(f2[2], f2[3], f3[2], f3[3]);
+                    _mm_storeu_ps(out + 2 * i + 4, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_unpackhi_ps(t, t))));
+                }
+            }
+        }
+#endif
+
+        for (; i < frames; i++) {
+            const float position = fraction + static_cast<float>(i) * rate;
+            const size_t whole = static_cast<size_t>(position);
+            const float t = position - static_cast<float>(whole);
+            const float* a = in + whole * channels;
+            for (int c = 0; c < channels; c++) {
+                out[i * channels + c] = a[c] + (a[channels + c] - a[c]) * t;
+            }
+        }
+    }
+    
+    BiquadCoefficients lowPassCoefficients(float cutoff, float q, int sampleRate) {
+        // Keep the cutoff clear of DC and Nyquist, where the design degenerates
+        const double frequency = std::max(10.0, std::min(static_cast<double>(cutoff), 0.45 * sampleRate));
+        const double w0 = 2.0 * PI * frequency / sampleRate;
+        const double alpha = std::sin(w0) / (2.0 * std::max(q, 0.1f));
+        const double cosW0 = std::cos(w0);
+        const double a0 = 1.0 + alpha;
+        BiquadCoefficients coefficients;
+        coefficients.b0 = static_cast<float>((1.0 - cosW0) * 0.5 / a0);
+        coefficients.b1 = static_cast<float>((1.0 - cosW0) / a0);
+        coefficients.b2 = coefficients.b0;
+        coefficients.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+        coefficients.a2 = static_cast<float>((1.0 - alpha) / a0);
+        return coefficients;
+    }
+    
+    void biquadStereo(float* buffer, size_t frames, const BiquadCoefficients& coefficients,
+                      BiquadState& state, unsigned maxLanes) {
+        const BiquadCoefficients& c = coefficients;
+
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            // Lanes are [left right - -]; same operations in the same order as the scalar path
+            const __m128 b0 = _mm_set1_ps(c.b0), b1 = _mm_set1_ps(c.b1), b2 = _mm_set1_ps(c.b2);
+            const __m128 a1 = _mm_set1_ps(c.a1), a2 = _mm_set1_ps(c.a2);
+            __m128 z1 = _mm_setr_ps(state.z1[0], state.z1[1], 0.0f, 0.0f);
+            __m128 z2 = _mm_setr_ps(state.z2[0], state.z2[1], 0.0f, 0.0f);
+            for (size_t i = 0; i < frames; i++) {
+                double* frame = reinterpret_cast<double*>(buffer + 2 * i);
+                __m128 x = _mm_castpd_ps(_mm_load_sd(frame));
+                __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+                z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+                z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+                _mm_store_sd(frame, _mm_castps_pd(y));
+            }
+            float saved[4];
+            _mm_storeu_ps(saved, z1);
+            state.z1[0] = saved[0];
+            state.z1[1] = saved[1];
+            _mm_storeu_ps(saved, z2);
+            state.z2[0] = saved[0];
+            state.z2[1] = saved[1];
+            return;
+        }
+#endif
+
+        for (int channel = 0; channel < 2; channel++) {
+            float z1 = state.z1[channel];
+            float z2 = state.z2[channel];
+            for (size_t i = 0; i < frames; i++) {
+                const float x = buffer[2 * i + channel];
+                const float y = c.b0 * x + z1;
+                z1 = c.b1 * x - c.a1 * y + z2;
+                z2 = c.b2 * x - c.a2 * y;
+                buffer[2 * i + channel] = y;
+            }
+            state.z1[channel] = z1;
+            state.z2[channel] = z2;
+        }
+    }
+    
+    void stereoPeak(const float* in, float* out, size_t frames, unsigned maxLanes) {
+        size_t i = 0;
+        
+        // Deinterleaving across the two AVX halves costs more than it saves, so SSE covers both widths
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            for (; i + 4 <= frames; i += 4) {
+                __m128 a = _mm_and_ps(_mm_loadu_ps(in + 2 * i), absMask);
+                __m128 b = _mm_and_ps(_mm_loadu_ps(in + 2 * i + 4), absMask);
+                __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm_storeu_ps(out + i, _mm_max_ps(left, right));
+            }
+        }
+#endif
+
+        for (; i < frames; i++) {
+            out[i] = std::max(std::fabs(in[2 * i]), std::fabs(in[2 * i + 1]));
+        }
+    }
+    
+    void applyFrameGains(float* buffer, const float* gains, size_t frames, unsigned maxLanes) {
+        size_t i = 0;
+
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8) {
+            for (; i + 4 <= frames; i += 4) {
+                __m128 gain = _mm_loadu_ps(gains + i);
+                __m256 pairs = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(gain, gain)),
+                                                    _mm_unpackhi_ps(gain, gain), 1);
+                _mm256_storeu_ps(buffer + 2 * i, _mm256_mul_ps(_mm256_loadu_ps(buffer + 2 * i), pairs));
+            }
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            for (; i + 2 <= frames; i += 2) {
+                __m128 gain = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(gains + i)));
+                _mm_storeu_ps(buffer + 2 * i, _mm_mul_ps(_mm_loadu_ps(buffer + 2 * i), _mm_unpacklo_ps(gain, gain)));
+            }
+        }
+#endif
+
+        for (; i < frames; i++) {
+            buffer[2 * i] *= gains[i];
+            buffer[2 * i + 1] *= gains[i];
+        }
+    }
+    
+    void decodeToFloat(const uint8_t* data, size_t bytes, SampleFormat format, std::vector<float>& out) {
+        switch (format) {
+            case SampleFormat::U8:
+                out.resize(bytes);
+                for (size_t i = 0; i < bytes; i++) {
+                    out[i] = (static_cast<int>(data[i]) - 128) * (1.0f / 128.0f);
+                }
+                return;
+            case SampleFormat::S8:
+                out.resize(bytes);
+                for (size_t i = 0; i < bytes; i++) {
+                    out[i] = static_cast<int8_t>(data[i]) * (1.0f / 128.0f);
+                }
+                return;
+            case SampleFormat::S16: {
+                // Copy first: WAV data is not guaranteed to be 2-byte aligned
+                std::vector<int16_t> samples(bytes / sizeof(int16_t));
+                std::memcpy(samples.data(), data, samples.size() * sizeof(int16_t));
+                out.resize(samples.size());
+                s16ToFloat(samples.data(), out.data(), samples.size());
+                return;
+            }
+            case SampleFormat::S32:
+                out.resize(bytes / sizeof(int32_t));
+                for (size_t i = 0; i < out.size(); i++) {
+                    int32_t sample;
+                    std::memcpy(&sample, data + i * sizeof(int32_t), sizeof(int32_t));
+                    out[i] = static_cast<float>(sample * (1.0 / 2147483648.0));
+                }
+                return;
+            case SampleFormat::F32:
+                out.resize(bytes / sizeof(float));
+                std::memcpy(out.data(), data, out.size() * sizeof(float));
+                return;
+        }
+    }
+    
+    // Sum of a[i] * b[i]; count is a multiple of 8
+    static inline float dot(const float* a, const float* b, size_t count, unsigned maxLanes) {
+        size_t i = 0;
+        float sum = 0.0f;
+
+#if defined(AUDIO_KERNELS_AVX)
+        if (maxLanes >= 8) {
+            __m256 acc = _mm256_setzero_ps();
+            for (; i + 8 <= count; i += 8) {
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            }
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+            half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+            half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+            sum += _mm_cvtss_f32(half);
+        }
+#endif
+#if defined(AUDIO_KERNELS_SSE)
+        if (maxLanes >= 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            }
+            acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+            acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+            sum += _mm_cvtss_f32(acc);
+        }
+#endif
+
+        for (; i < count; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+    
+    Resampler::Resampler(int channels, int inRate, int outRate)
+        : channels(std::max(1, channels)),
+          passthrough(inRate <= 0 || outRate <= 0 || inRate == outRate),
+          step(passthrough ? 1.0 : static_cast<double>(inRate) / outRate),
+          taps(0),
+          halfTaps(0),
+          position(0.0) {
+        if (passthrough) return;
+        const double cutoff = std::min(1.0, static_cast<double>(outRate) / inRate);
+        
+        // The kernel widens as the cutoff drops so the transition band keeps its shape.
+        // Tap j of a phase reads input frame floor(x) - halfTaps + 1 + j.
+        taps = static_cast<int>(std::ceil(2.0 * RESAMPLE_ZERO_CROSSINGS / cutoff));
+        taps = (taps + 7) & ~7;
+        halfTaps = taps / 2;
+        
+        // One row of taps per phase (plus the end point), each normalized to unity DC gain
+        table.resize(static_cast<size_t>(RESAMPLE_PHASES + 1) * taps);
+        for (int phase = 0; phase <= RESAMPLE_PHASES; phase++) {
+            const double fraction = static_cast<double>(phase) / RESAMPLE_PHASES;
+            float* row = &table[static_cast<size_t>(phase) * taps];
+            double sum = 0.0;
+            for (int j = 0; j < taps; j++) {
+                double t = (j - halfTaps + 1) - fraction;
+                double x = cutoff * t;
+                double sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(PI * x) / (PI * x);
+                double u = t / halfTaps;
+                double window = std::fabs(u) >= 1.0 ? 0.0 : 0.42 + 0.5 * std::cos(PI * u) + 0.08 * std::cos(2.0 * PI * u);
+                double h = cutoff * sinc * window;
+                row[j] = static_cast<float>(h);
+                sum += h;
+            }
+            for (int j = 0; j < taps; j++) {
+                row[j] = static_cast<float>(row[j] / sum);
+            }
+        }
+        
+        // Silence before the first frame: history[0] is input frame -halfTaps
+        history.assign(this->channels, std::vector<float>(halfTaps, 0.0f));
+    }
+    
+    void Resampler::process(const float* in, size_t frames, std::vector<float>& out, unsigned maxLanes) {
+        if (passthrough) {
+            out.insert(out.end(), in, in + frames * channels);
+            return;
+        }
+        
+        for (int c = 0; c < channels; c++) {
+            std::vector<float>& channel = history[c];
+            const size_t offset = channel.size();
+            channel.resize(offset + frames);
+            for (size_t i = 0; i < frames; i++) {
+                channel[offset + i] = in[i * channels + c];
+            }
+        }
+        
+        // Every output whose taps are all available
+        const size_t available = history[0].size();
+        while (static_cast<size_t>(position) + 1 + taps <= available) {
+            const size_t index = static_cast<size_t>(position);
+            const int phase = static_cast<int>(std::lround((position - index) * RESAMPLE_PHASES));
+            const float* row = &table[static_cast<size_t>(phase) * taps];
+            for (int c = 0; c < channels; c++) {
+                out.push_back(dot(&history[c][index + 1], row, taps, maxLanes));
+            }
+            position += step;
+        }
+        
+        // Drop input no later output can reach
+        const size_t consumed = static_cast<size_t>(position);
+        for (std::vector<float>& channel : history) {
+            channel.erase(channel.begin(), channel.begin() + consumed);
+        }
+        position -= consumed;
+    }
+    
+    void Resampler::flush(std::vector<float>& out, unsigned maxLanes) {
+        if (passthrough) return;
+        
+        // Enough silence to complete every output up to the last input frame
+        std::vector<float> silence(static_cast<size_t>(halfTaps) * channels, 0.0f);
+        process(silence.data(), halfTaps, out, maxLanes);
+    }
+    
+    void resample(const std::vector<float>& in, int channels, int inRate, int outRate,
+                  std::vector<float>& out, unsigned maxLanes) {
+        out.clear();
+        if (channels < 1 || inRate <= 0 || outRate <= 0 || in.size() < static_cast<size_t>(channels)) {
+            return;
+        }
+        
+        Resampler resampler(channels, inRate, outRate);
+        out.reserve(static_cast<size_t>(static_cast<double>(in.size()) * outRate / inRate) + channels);
+        resampler.process(in.data(), in.size() / channels, out, maxLanes);
+        resampler.flush(out, maxLanes);
+    }
+    
+    const char* simdPathName() {
+#if defined(AUDIO_KERNELS_AVX)
+        return "AVX";
+#elif defined(AUDIO_KERNELS_SSE)
+        return "SSE";
+#else
+        return "scalar";
+#endif
+    }
+    
+    template <typename Kernel>
+    static double nanosecondsPerFrame(Kernel&& kernel, size_t frames, int iterations) {
+        kernel();   // Warm-up
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            kernel();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds * 1.0e9 / (static_cast<double>(frames) * std::max(1, iterations));
+    }
+    
+    void runBenchmark(size_t frames, int iterations, std::ostream& out) {
+        std::ios::fmtflags savedFlags = out.flags();
+        std::streamsize savedPrecision = out.precision();
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        
+        std::vector<float> mono(frames), stereo(frames * 2), mix(frames * 2, 0.0f);
+        std::vector<int16_t> pcm(frames * 2);
+        for (float& sample : mono) sample = unit(rng) * 0.5f;
+        for (float& sample : stereo) sample = unit(rng) * 0.5f;
+        for (int16_t& sample : pcm) sample = static_cast<int16_t>(unit(rng) * 16000.0f);
+        const StereoGain start = equalPowerPan(-0.3f, 0.8f);
+        const StereoGain end = equalPowerPan(0.2f, 0.6f);
+        
+        std::vector<unsigned> laneCounts = { 1 };
+#if defined(AUDIO_KERNELS_SSE)
+        laneCounts.push_back(4);
+#endif
+#if defined(AUDIO_KERNELS_AVX)
+        laneCounts.push_back(8);
+#endif
+
+        out << "Audio kernels: " << frames << " stereo frames, " << iterations
+            << " iterations, SIMD path " << simdPathName() << " (ns per output frame)" << std::endl;
+        out << std::left << std::setw(8) << "lanes" << std::setw(14) << "s16->float" << std::setw(14) << "float->s16"
+            << std::setw(14) << "mono->stereo" << "stereo" << std::endl;
+        for (unsigned lanes : laneCounts) {
+            double toFloat = nanosecondsPerFrame([&] { s16ToFloat(pcm.data(), mix.data(), frames * 2, lanes); }, frames, iterations);
+            double toS16 = nanosecondsPerFrame([&] { floatToS16(stereo.data(), pcm.data(), frames * 2, lanes); }, frames, iterations);
+            double pan = nanosecondsPerFrame([&] { mixMonoToStereo(mono.data(), mix.data(), frames, start, end, lanes); }, frames, iterations);
+            double ramp = nanosecondsPerFrame([&] { mixStereo(stereo.data(), mix.data(), frames, start, end, lanes); }, frames, iterations);
+            out << std::left << std::setw(8) << lanes << std::fixed << std::setprecision(3)
+                << std::setw(14) << toFloat << std::setw(14) << toS16 << std::setw(14) << pan << ramp
+                << std::defaultfloat << std::endl;
+        }
+        
+        // Bus effects: filter, compressor level detection and gain
+        std::vector<float> levels(frames), gains(frames);
+        for (float& gain : gains) gain = unit(rng) < 0.0f ? -1.0f : 1.0f;    // Repeated calls must not decay to denormals
+        const BiquadCoefficients lowPass = lowPassCoefficients(2000.0f, 0.7071f, 44100);
+        out << std::left << std::setw(8) << "lanes" << std::setw(14) << "biquad" << std::setw(14) << "peak"
+            << "frame gains" << std::endl;
+        for (unsigned lanes : laneCounts) {
+            BiquadState filterState = {};
+            double filter = nanosecondsPerFrame([&] { biquadStereo(mix.data(), frames, lowPass, filterState, lanes); }, frames, iterations);
+            double peak = nanosecondsPerFrame([&] { stereoPeak(stereo.data(), levels.data(), frames, lanes); }, frames, iterations);
+            double scale = nanosecondsPerFrame([&] { applyFrameGains(stereo.data(), gains.data(), frames, lanes); }, frames, iterations);
+            out << std::left << std::setw(8) << lanes << std::fixed << std::setprecision(3)
+                << std::setw(14) << filter << std::setw(14) << peak << scale
+                << std::defaultfloat << std::endl;
+        }
+        
+        // Pitched voices: linear interpolation slightly below the source rate, as Doppler gives
+        out << std::left << std::setw(8) << "lanes" << std::setw(14) << "pitch mono" << "pitch stereo" << std::endl;
+        for (unsigned lanes : laneCounts) {
+            double pitchMono = nanosecondsPerFrame([&] { resampleLinear(mono.data(), 1, 0.25f, 0.97f, mix.data(), frames, lanes); }, frames, iterations);
+            double pitchStereo = nanosecondsPerFrame([&] { resampleLinear(stereo.data(), 2, 0.25f, 0.97f, mix.data(), frames, lanes); }, frames, iterations);
+            out << std::left << std::setw(8) << lanes << std::fixed << std::setprecision(3)
+                << std::setw(14) << pitchMono << pitchStereo
+                << std::defaultfloat << std::endl;
+        }
+        
+        // Resampling: one second of a 1 kHz sine, error against the exact sine away from the edges
+        out << std::endl << "Resampler (windowed sinc, " << RESAMPLE_ZERO_CROSSINGS << " zero crossings, "
+            << RESAMPLE_PHASES << " phases)" << std::endl;
+        out << std::left << std::setw(18) << "rate" << std::setw(8) << "lanes" << std::setw(16) << "Msamples/sec"
+            << "max error (dB)" << std::endl;
+        const int rates[][2] = { { 48000, 44100 }, { 22050, 44100 }, { 96000, 44100 } };
+        for (const auto& rate : rates) {
+            std::vector<float> source(rate[0]), resampled;
+            for (size_t i = 0; i < source.size(); i++) {
+                source[i] = static_cast<float>(0.5 * std::sin(2.0 * PI * 1000.0 * i / rate[0]));
+            }
+            
+            for (unsigned lanes : laneCounts) {
+                auto begin = std::chrono::steady_clock::now();
+                resample(source, 1, rate[0], rate[1], resampled, lanes);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                
+                double maxError = 0.0;
+                for (size_t n = rate[1] / 10; n + rate[1] / 10 < resampled.size(); n++) {
+                    double exact = 0.5 * std::sin(2.0 * PI * 1000.0 * n / rate[1]);
+                    maxError = std::max(maxError, std::fabs(resampled[n] - exact));
+                }
+                
+                std::string label = std::to_string(rate[0]) + "->" + std::to_string(rate[1]);
+                out << std::left << std::setw(18) << label << std::setw(8) << lanes << std::fixed << std::setprecision(1)
+                    << std::setw(16) << (seconds > 0.0 ? resampled.size() / seconds / 1.0e6 : 0.0)
+                    << 20.0 * std::log10(std::max(maxError, 1e-12) / 0.5) << std::defaultfloat << std::endl;
+            }
+        }
+        out << std::endl;
+        
+        out.flags(savedFlags);
+        out.precision(savedPrecision);
+    }
+}
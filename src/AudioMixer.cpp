@@ -0,0 +1,516 @@
+#include "AudioMixer.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+
+AudioMixer::AudioMixer(size_t maxVoices, size_t maxFrames, int sampleRate)
+    : voices(std::max<size_t>(1, maxVoices)),
+      buses(sampleRate, std::max<size_t>(1, maxFrames)),
+      accumulator(std::max<size_t>(1, maxFrames) * CHANNELS),
+      scratch(std::max<size_t>(1, maxFrames) * CHANNELS),
+      maxFrames(std::max<size_t>(1, maxFrames)),
+      activeVoices(0),
+      virtualVoices(0),
+      startCounter(0),
+      stolenVoices(0),
+      rejectedVoices(0),
+      streamUnderruns(0),
+      endCallback(nullptr),
+      endUserdata(nullptr) {}
+
+void AudioMixer::setVoiceEndCallback(VoiceEndCallback callback, void* userdata) {
+    endCallback = callback;
+    endUserdata = userdata;
+}
+
+bool AudioMixer::play(SoundHandle handle, const VoiceDesc& desc) {
+    if (!desc.stream && (!desc.samples || desc.frameCount == 0 ||
+                         (desc.channels != 1 && desc.channels != CHANNELS))) {
+        rejectedVoices++;
+        if (desc.notifyEnd && endCallback) {
+            endCallback(endUserdata, handle);
+        }
+        return false;
+    }
+    
+    // Free slot, or else the lowest-priority voice: inaudible first, then oldest among equals
+    Voice* target = nullptr;
+    for (Voice& voice : voices) {
+        if (!voice.active) {
+            target = &voice;
+            break;
+        }
+        if (!target || voice.priority < target->priority) {
+            target = &voice;
+            continue;
+        }
+        if (voice.priority == target->priority) {
+            const bool audible = isAudible(voice.applied);
+            const bool targetAudible = isAudible(target->applied);
+            if ((!audible && targetAudible) || (audible == targetAudible && voice.startOrder < target->startOrder)) {
+                target = &voice;
+            }
+        }
+    }
+    
+    if (target->active) {
+        // Never cut a more important sound for a less important one
+        if (target->priority > desc.priority) {
+            rejectedVoices++;
+            if (desc.stream) {
+                desc.stream->release();
+            }
+            if (desc.notifyEnd && endCallback) {
+                endCallback(endUserdata, handle);
+            }
+            return false;
+        }
+        release(*target);
+        stolenVoices++;
+    }
+    
+    target->handle = handle;
+    target->samples = desc.samples;
+    target->frameCount = desc.frameCount;
+    target->stream = desc.stream;
+    target->position = 0;
+    target->fraction = 0.0f;
+    target->startOrder = startCounter++;
+    target->channels = desc.channels;
+    target->gain = desc.gain;
+    target->pan = desc.pan;
+    target->attenuation = desc.attenuation;
+    target->pitch = std::max(0.0f, desc.pitch);
+    target->applied = targetGain(*target);   // New voices start at their gain, no ramp
+    target->priority = desc.priority;
+    target->bus = desc.bus;
+    target->looping = desc.looping;
+    target->notifyEnd = desc.notifyEnd;
+    target->active = true;
+    activeVoices++;
+    return true;
+}
+
+void AudioMixer::stop(SoundHandle handle) {
+    for (Voice& voice : voices) {
+        if (voice.active && voice.handle == handle) {
+            release(voice);
+        }
+    }
+}
+
+void AudioMixer::stopAll() {
+    for (Voice& voice : voices) {
+        if (voice.active) {
+            release(voice);
+        }
+    }
+}
+
+void AudioMixer::setGain(SoundHandle handle, float gain) {
+    for (Voice& voice : voices) {
+        if (voice.active && voice.handle == handle) {
+            voice.gain = gain;
+        }
+    }
+}
+
+void AudioMixer::setPan(SoundHandle handle, float pan) {
+    for (Voice& voice : voices) {
+        if (voice.active && voice.handle == handle) {
+            voice.pan = std::max(-1.0f, std::min(pan, 1.0f));
+        }
+    }
+}
+
+void AudioMixer::setSpatial(SoundHandle handle, float attenuation, float pan, float pitch) {
+    for (Voice& voice : voices) {
+        if (voice.active && voice.handle == handle) {
+            voice.attenuation = attenuation;
+            voice.pan = std::max(-1.0f, std::min(pan, 1.0f));
+            voice.pitch = std::max(0.0f, pitch);
+        }
+    }
+}
+
+AudioKernels::StereoGain AudioMixer::targetGain(const Voice& voice) {
+    const float gain = voice.gain * voice.attenuation;
+    if (voice.channels == 1) {
+        return AudioKernels::equalPowerPan(voice.pan, gain);
+    }
+    // Stereo sources keep both sides at full level in the center and fade the far side out
+    return AudioKernels::StereoGain{ gain * std::min(1.0f, 1.0f - voice.pan),
+                                     gain * std::min(1.0f, 1.0f + voice.pan) };
+}
+
+void AudioMixer::release(Voice& voice) {
+    if (voice.stream) {
+        voice.stream->release();
+    }
+    voice.stream = nullptr;
+    voice.samples = nullptr;
+    if (voice.notifyEnd && endCallback) {
+        endCallback(endUserdata, voice.handle);
+    }
+    voice.active = false;
+    activeVoices--;
+}
+
+void AudioMixer::mix(int16_t* output, size_t frames) {
+    // Larger requests than the accumulator are mixed in pieces
+    while (frames > 0) {
+        const size_t chunk = std::min(frames, maxFrames);
+        const size_t sampleCount = chunk * CHANNELS;
+        mix(accumulator.data(), chunk);
+        
+        // Single clip and conversion for the whole mix
+        AudioKernels::floatToS16(accumulator.data(), output, sampleCount);
+        
+        output += sampleCount;
+        frames -= chunk;
+    }
+}
+
+void AudioMixer::mix(float* output, size_t frames) {
+    PROFILE_ZONE("AudioMixer::mix");
+    
+    while (frames > 0) {
+        const size_t chunk = std::min(frames, maxFrames);
+        buses.begin(chunk);
+        virtualVoices = 0;
+        
+        if (activeVoices > 0) {
+            for (Voice& voice : voices) {
+                if (voice.active) {
+                    mixVoice(voice, chunk);
+                }
+            }
+        }
+        
+        buses.render(output);
+        output += chunk * CHANNELS;
+        frames -= chunk;
+    }
+}
+
+void AudioMixer::mixVoice(Voice& voice, size_t frames) {
+    const float* source = nullptr;
+    if (voice.stream && voice.position == 0 && voice.stream->peek(source) > 0) {
+        // A stream's channel count is known once its first block arrives
+        voice.channels = voice.stream->getChannels();
+        voice.applied = targetGain(voice);
+    }
+    
+    // Ramp from the gains left by the last chunk to the current target across this chunk
+    const AudioKernels::StereoGain from = voice.applied;
+    const AudioKernels::StereoGain to = targetGain(voice);
+    auto rampAt = [&](size_t frame) {
+        const float t = static_cast<float>(frame) / frames;
+        return AudioKernels::StereoGain{ from.left + (to.left - from.left) * t,
+                                         from.right + (to.right - from.right) * t };
+    };
+    voice.applied = to;
+    
+    // Silent for the whole chunk: only keep time
+    if (!isAudible(from) && !isAudible(to)) {
+        virtualVoices++;
+        skipVoice(voice, frames);
+        return;
+    }
+    
+    float* accum = buses.getInput(voice.bus);
+    
+    // A voice whose pitch settles near 1 (an emitter coming to rest) rejoins the source
+    // rate at the nearest frame
+    const bool pitched = playbackRate(voice) != 1.0f;
+    if (!voice.stream && !pitched && voice.fraction != 0.0f) {
+        if (voice.fraction >= 0.5f) {
+            voice.position++;
+        }
+        voice.fraction = 0.0f;
+        if (voice.position >= voice.frameCount) {
+            if (!voice.looping) {
+                release(voice);
+                return;
+            }
+            voice.position %= voice.frameCount;
+        }
+    }
+    
+    // Off-rate voices are interpolated into scratch first
+    if (!voice.stream && pitched) {
+        const size_t produced = resampleVoice(voice, scratch.data(), frames);
+        if (voice.channels == CHANNELS) {
+            AudioKernels::mixStereo(scratch.data(), accum, produced, from, rampAt(produced));
+        } else {
+            AudioKernels::mixMonoToStereo(scratch.data(), accum, produced, from, rampAt(produced));
+        }
+        if (!voice.looping && voice.position >= voice.frameCount) {
+            release(voice);
+        }
+        return;
+    }
+    
+    size_t written = 0;
+    
+    while (written < frames && voice.active) {
+        size_t count;
+        if (voice.stream) {
+            // Never wait for the streaming thread: a late block is heard as a gap
+            count = std::min(frames - written, voice.stream->peek(source));
+            if (count == 0) {
+                if (voice.stream->isFinished()) {
+                    release(voice);
+                } else if (voice.position > 0) {
+                    streamUnderruns++;
+                }
+                break;
+            }
+        } else {
+            count = std::min(frames - written, static_cast<size_t>(voice.frameCount - voice.position));
+            source = voice.samples + static_cast<size_t>(voice.position) * voice.channels;
+        }
+        float* destination = accum + written * CHANNELS;
+        
+        if (voice.channels == CHANNELS) {
+            AudioKernels::mixStereo(source, destination, count, rampAt(written), rampAt(written + count));
+        } else {
+            AudioKernels::mixMonoToStereo(source, destination, count, rampAt(written), rampAt(written + count));
+        }
+        
+        written += count;
+        voice.position += static_cast<uint32_t>(count);
+        if (voice.stream) {
+            voice.stream->consume(count);
+        } else if (voice.position >= voice.frameCount) {
+            if (voice.looping) {
+                voice.position = 0;
+            } else {
+                release(voice);
+            }
+        }
+    }
+}
+
+void AudioMixer::skipVoice(Voice& voice, size_t frames) {
+    if (voice.stream) {
+        // Streams are read and dropped so they stay in time
+        const float* source;
+        while (frames > 0) {
+            const size_t count = std::min(frames, voice.stream->peek(source));
+            if (count == 0) {
+                if (voice.stream->isFinished()) {
+                    release(voice);
+                }
+                return;
+            }
+            voice.stream->consume(count);
+            voice.position += static_cast<uint32_t>(count);
+            frames -= count;
+        }
+        return;
+    }
+    
+    const double advance = voice.fraction + frames * static_cast<double>(playbackRate(voice));
+    const uint64_t whole = static_cast<uint64_t>(advance);
+    uint64_t position = voice.position + whole;
+    voice.fraction = static_cast<float>(advance - whole);
+    if (position >= voice.frameCount) {
+        if (!voice.looping) {
+            release(voice);
+            return;
+        }
+        position %= voice.frameCount;
+    }
+    voice.position = static_cast<uint32_t>(position);
+}
+
+size_t AudioMixer::resampleVoice(Voice& voice, float* output, size_t frames) {
+    const int channels = voice.channels;
+    size_t produced = 0;
+    
+    while (produced < frames) {
+        if (voice.position >= voice.frameCount) {
+            if (!voice.looping) {
+                break;
+            }
+            voice.position %= voice.frameCount;
+        }
+        
+        // Frames whose right neighbour is still inside the sound interpolate in one kernel call.
+        // The margin covers the kernel's float positions
+        const double room = static_cast<double>(voice.frameCount - 1 - voice.position) - voice.fraction - 0.01;
+        size_t run = 0;
+        if (room > 0.0) {
+            run = frames - produced;
+            if (voice.pitch > 0.0f) {
+                run = static_cast<size_t>(std::min(static_cast<double>(run), room / voice.pitch));
+            }
+        }
+        if (run > 0) {
+            AudioKernels::resampleLinear(voice.samples + static_cast<size_t>(voice.position) * channels, channels,
+                                         voice.fraction, voice.pitch, output + produced * channels, run);
+            produced += run;
+            const double advance = voice.fraction + run * static_cast<double>(voice.pitch);
+            const uint32_t whole = static_cast<uint32_t>(advance);
+            voice.position += whole;
+            voice.fraction = static_cast<float>(advance - whole);
+            continue;
+        }
+        
+        // The frame after the last is the first when looping, else the last again
+        uint32_t next = voice.position + 1;
+        if (next >= voice.frameCount) {
+            next = voice.looping ? 0 : voice.position;
+        }
+        const float* a = voice.samples + static_cast<size_t>(voice.position) * channels;
+        const float* b = voice.samples + static_cast<size_t>(next) * channels;
+        for (int c = 0; c < channels; c++) {
+            output[produced * channels + c] = a[c] + (b[c] - a[c]) * voice.fraction;
+        }
+        produced++;
+        
+        voice.fraction += voice.pitch;
+        const uint32_t whole = static_cast<uint32_t>(voice.fraction);
+        voice.position += whole;
+        voice.fraction -= whole;
+    }
+    return produced;
+}
+
+void AudioMixer::runBenchmark(int callbacks, std::ostream& out) {
+    std::ios::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+    
+    const int channels = CHANNELS;
+    const size_t frames = 1024;
+    const int sampleRate = 44100;
+    const double budgetMicros = 1.0e6 * frames / sampleRate;
+    callbacks = std::max(1, callbacks);
+    
+    // One second of mono noise; voices loop over it at different offsets
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.4f, 0.4f);
+    std::uniform_real_distribution<float> pan(-1.0f, 1.0f);
+    std::vector<float> source(sampleRate);
+    for (float& sample : source) {
+        sample = noise(rng);
+    }
+    std::vector<int16_t> output(frames * channels);
+    
+    out << "Audio mixer (" << AudioKernels::simdPathName() << "): " << frames << " frames per callback, "
+        << channels << " channels, "
+        << callbacks << " callbacks, budget " << std::fixed << std::setprecision(1) << budgetMicros << " us" << std::endl;
+    out << std::left << std::setw(10) << "voices" << std::setw(14) << "avg us" << std::setw(14) << "worst us"
+        << std::setw(14) << "worst/budget" << "ns/voice/frame" << std::endl;
+    
+    const size_t voiceCounts[] = { 1, 8, 32, 64, 128, 256 };
+    for (size_t voiceCount : voiceCounts) {
+        AudioMixer mixer(voiceCount, frames, sampleRate);
+        for (size_t i = 0; i < voiceCount; i++) {
+            VoiceDesc desc;
+            desc.samples = source.data() + (i * 997) % (source.size() / 2);
+            desc.frameCount = static_cast<uint32_t>(source.size() / 2);
+            desc.gain = 0.5f;
+            desc.pan = pan(rng);
+            desc.looping = true;
+            mixer.play(static_cast<SoundHandle>(i + 1), desc);
+        }
+        
+        mixer.mix(output.data(), frames);   // Warm-up
+        double total = 0.0;
+        double worst = 0.0;
+        for (int i = 0; i < callbacks; i++) {
+            auto start = std::chrono::steady_clock::now();
+            mixer.mix(output.data(), frames);
+            double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            total += micros;
+            worst = std::max(worst, micros);
+            // Keep the gain ramps busy, as moving emitters would
+            mixer.setPan(static_cast<SoundHandle>(1 + i % voiceCount), pan(rng));
+        }
+        
+        double average = total / callbacks;
+        out << std::left << std::setw(10) << voiceCount << std::setw(14) << std::setprecision(2) << average
+            << std::setw(14) << worst << std::setw(14) << std::setprecision(3) << worst / budgetMicros
+            << std::setprecision(2) << average * 1000.0 / (voiceCount * frames) << std::endl;
+    }
+    
+    // Positional scene: 256 Doppler-shifted voices, three quarters out of range (virtual)
+    {
+        AudioMixer mixer(256, frames, sampleRate);
+        for (size_t i = 0; i < 256; i++) {
+            VoiceDesc desc;
+            desc.samples = source.data() + (i * 997) % (source.size() / 2);
+            desc.frameCount = static_cast<uint32_t>(source.size() / 2);
+            desc.pan = pan(rng);
+            desc.attenuation = i % 4 == 0 ? 0.5f : 0.0f;
+            desc.pitch = 0.97f + 0.06f * static_cast<float>(i % 16) / 15.0f;
+            desc.looping = true;
+            mixer.play(static_cast<SoundHandle>(i + 1), desc);
+        }
+        
+        mixer.mix(output.data(), frames);   // Warm-up
+        double total = 0.0;
+        for (int i = 0; i < callbacks; i++) {
+            auto start = std::chrono::steady_clock::now();
+            mixer.mix(output.data(), frames);
+            total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+        out << "Positional (256 pitched voices, " << mixer.getVirtualVoiceCount() << " virtual): avg "
+            << std::setprecision(2) << total / callbacks << " us" << std::endl;
+    }
+    
+    // Bus effects with every bus in use: low-pass, compressor and reverb send each, then the limiter
+    {
+        AudioBusGraph graph(sampleRate, frames);
+        const AudioBusID ids[] = { AudioBusID::SFX, AudioBusID::Music, AudioBusID::UI };
+        for (AudioBusID id : ids) {
+            graph.setLowPass(id, 4000.0f);
+            graph.setReverbSend(id, 0.3f);
+            graph.setCompressor(id, true);
+        }
+        std::vector<float> master(frames * channels);
+        double total = 0.0;
+        for (int i = 0; i <= callbacks; i++) {
+            auto start = std::chrono::steady_clock::now();
+            graph.begin(frames);
+            for (AudioBusID id : ids) {
+                std::copy_n(source.data() + (i * 331) % (source.size() / 2), frames * channels, graph.getInput(id));
+            }
+            graph.render(master.data());
+            if (i > 0) {    // The first render is the warm-up
+                total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+        out << "Bus effects (3 buses with low-pass, compressor and reverb send, master limiter): avg "
+            << std::setprecision(2) << total / callbacks << " us" << std::endl;
+    }
+    
+    // Voice stealing under load: a 32-voice pool receiving 4 new one-shots per callback
+    AudioMixer mixer(32, frames, sampleRate);
+    std::uniform_int_distribution<int> priority(0, 3);
+    std::uniform_int_distribution<int> length(frames, frames * 40);
+    double worst = 0.0;
+    SoundHandle handle = 0;
+    for (int i = 0; i < callbacks; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int j = 0; j < 4; j++) {
+            VoiceDesc desc;
+            desc.samples = source.data();
+            desc.frameCount = static_cast<uint32_t>(length(rng));
+            desc.priority = priority(rng);
+            mixer.play(++handle, desc);
+        }
+        mixer.mix(output.data(), frames);
+        worst = std::max(worst, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    out << "Stealing (32-voice pool, 4 new voices per callback): " << mixer.getStolenVoiceCount() << " stolen, "
+        << mixer.getRejectedVoiceCount() << " rejected, worst " << std::setprecision(2) << worst << " us" << std::endl;
+    
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
@@ -0,0 +1,37 @@
+// audio_render: plays the scripted audio scene through the offline backend (no GPU, window
+// or audio device) and fails if any callback missed its deadline, so CI can gate on it.
+// Usage: audio_render [--seconds s] [--assets dir] output.wav
+#include "AudioScene.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#ifndef ENGINE_ASSET_DIR
+#define ENGINE_ASSET_DIR ".."
+#endif
+
+int main(int argc, char** argv) {
+    std::string assets = ENGINE_ASSET_DIR;
+    std::string outputPath;
+    double seconds = 10.0;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--seconds" && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (argument == "--assets" && hasValue) {
+            assets = argv[++i];
+        } else if (outputPath.empty() && argument.compare(0, 2, "--") != 0) {
+            outputPath = argument;
+        } else {
+            outputPath.clear();
+            break;
+        }
+    }
+    if (outputPath.empty() || seconds <= 0.0) {
+        std::cerr << "Usage: audio_render [--seconds s] [--assets dir] output.wav" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    return AudioScene::render(assets, outputPath, seconds, std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,61 @@
+#include "AudioScene.hpp"
+#include "SoundSystem.hpp"
+#include "Camera.hpp"
+#include <cmath>
+#include <glm/glm.hpp>
+
+namespace AudioScene {
+    bool render(const std::string& assets, const std::string& outputPath, double seconds, std::ostream& out) {
+        const std::string audio = assets + "/audio/";
+        SoundSystem soundSystem(AudioBackend::Offline);
+        if (!soundSystem.loadBank(audio + "sounds.sbank")) {
+            soundSystem.loadSound(audio + "paddle_hit.wav");
+            soundSystem.loadSound(audio + "brick_hit.wav");
+            soundSystem.loadSound(audio + "wall_hit.wav");
+        }
+        if (!soundSystem.startCapture(outputPath)) {
+            return false;
+        }
+        
+        const SoundID paddleHit = SoundID::fromName("paddle_hit");
+        const SoundID brickHit = SoundID::fromName("brick_hit");
+        const SoundID wallHit = SoundID::fromName("wall_hit");
+        Camera listener;
+        listener.setPosition(glm::vec3(0.0f));
+        listener.setTarget(glm::vec3(0.0f, 0.0f, -1.0f));
+        
+        // Looping music, a paddle hit every quarter second, eight stacked brick hits every half
+        // second (the limiter's worst case) and a wall hit circling the listener every second
+        soundSystem.setBusReverbSend(AudioBusID::SFX, 0.2f);
+        soundSystem.playStream(audio + "win_game.wav", true);
+        const int steps = static_cast<int>(seconds * 60.0);
+        const float dt = 1.0f / 60.0f;
+        for (int step = 0; step < steps; step++) {
+            const float time = step * dt;
+            if (step % 15 == 0) {
+                soundSystem.playSound(paddleHit);
+            }
+            if (step % 30 == 0) {
+                for (int i = 0; i < 8; i++) {
+                    soundSystem.playSound(brickHit);
+                }
+            }
+            if (step % 60 == 0) {
+                soundSystem.playSoundAt(wallHit, glm::vec3(10.0f * std::sin(time), 0.0f, -10.0f * std::cos(time)));
+            }
+            if (step == steps / 2) {
+                soundSystem.setBusLowPass(AudioBusID::Music, 800.0f);   // Muffled, as behind a pause menu
+            }
+            
+            soundSystem.update(listener, dt);
+            soundSystem.advanceOffline(dt);
+        }
+        soundSystem.stopCapture();
+        
+        out << "Wrote " << outputPath << " (" << soundSystem.getOfflineTime() << " s)" << std::endl;
+        const AudioInstrumentation& instrumentation = soundSystem.getInstrumentation();
+        instrumentation.print(out);
+        out << "Dropped commands: " << soundSystem.getDroppedCommandCount() << std::endl;
+        return instrumentation.getDeadlineMissCount() == 0;
+    }
+}
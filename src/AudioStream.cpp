@@ -0,0 +1,296 @@
+#include "AudioStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// Source frames decoded per read
+static const size_t STREAM_READ_FRAMES = 4096;
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+AudioStream::AudioStream(const std::string& filepath, int outputRate, bool looping)
+    : filepath(filepath),
+      outputRate(outputRate),
+      looping(looping),
+      opened(false),
+      ended(false),
+      dataStart(0),
+      dataSize(0),
+      dataRead(0),
+      fileChannels(0),
+      bytesPerSample(0),
+      floatSamples(false),
+      writeBlock(0),
+      flushed(false),
+      convertedOffset(0),
+      channels(1),
+      readBlock(0),
+      readOffset(0),
+      finished(false),
+      released(false) {}
+
+void AudioStream::open() {
+    opened = true;
+    file.open(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open audio stream: " << filepath << std::endl;
+        publishEmpty();
+        return;
+    }
+    
+    char riff[4], wave[4];
+    uint32_t riffSize;
+    if (!file.read(riff, 4) || !readValue(file, riffSize) || !file.read(wave, 4) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(wave, "WAVE", 4) != 0) {
+        std::cerr << "Error: Not a WAV file: " << filepath << std::endl;
+        publishEmpty();
+        return;
+    }
+    
+    // Walk the chunks for the format and the start of the sample data
+    uint16_t formatTag = 0, bitsPerSample = 0;
+    uint32_t sampleRate = 0;
+    bool haveFormat = false;
+    char id[4];
+    uint32_t size;
+    while (file.read(id, 4) && readValue(file, size)) {
+        const std::streamoff chunkStart = file.tellg();
+        if (std::memcmp(id, "fmt ", 4) == 0 && size >= 16) {
+            uint16_t channelCount, blockAlign;
+            uint32_t byteRate;
+            readValue(file, formatTag);
+            readValue(file, channelCount);
+            readValue(file, sampleRate);
+            readValue(file, byteRate);
+            readValue(file, blockAlign);
+            readValue(file, bitsPerSample);
+            if (formatTag == 0xFFFE && size >= 40) {
+                // WAVE_FORMAT_EXTENSIBLE: the real tag starts the sub-format GUID
+                file.seekg(chunkStart + 24);
+                readValue(file, formatTag);
+            }
+            fileChannels = channelCount;
+            haveFormat = true;
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            dataStart = static_cast<uint64_t>(chunkStart);
+            dataSize = size;
+            break;
+        }
+        file.seekg(chunkStart + static_cast<std::streamoff>(size + (size & 1)));
+    }
+    
+    bytesPerSample = bitsPerSample / 8;
+    floatSamples = formatTag == 3;
+    const bool supported = haveFormat && dataStart != 0 && fileChannels > 0 && sampleRate > 0 &&
+        ((formatTag == 1 && bytesPerSample >= 1 && bytesPerSample <= 4) || (floatSamples && bytesPerSample == 4));
+    if (!supported) {
+        std::cerr << "Error: Unsupported WAV format for streaming: " << filepath << std::endl;
+        publishEmpty();
+        return;
+    }
+    
+    // Same conversion as SoundSystem::loadSound: mono and stereo kept, wider folded to mono
+    channels = fileChannels > 2 ? 1 : fileChannels;
+    resampler = std::make_unique<AudioKernels::Resampler>(channels, static_cast<int>(sampleRate), outputRate);
+    dataSize -= dataSize % (static_cast<uint64_t>(bytesPerSample) * fileChannels);
+    for (Block& block : blocks) {
+        block.samples.resize(BLOCK_FRAMES * channels);
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(dataStart));
+}
+
+void AudioStream::publishEmpty() {
+    Block& block = blocks[writeBlock];
+    block.frames = 0;
+    block.last = true;
+    ended = true;
+    block.ready.store(true, std::memory_order_release);
+}
+
+bool AudioStream::decodeNext() {
+    converted.clear();
+    convertedOffset = 0;
+    
+    const size_t frameBytes = static_cast<size_t>(bytesPerSample) * fileChannels;
+    if (dataRead == dataSize && looping && dataSize > 0) {
+        // Wrap without flushing the resampler so the loop point stays seamless
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(dataStart));
+        dataRead = 0;
+    }
+    if (dataRead == dataSize) {
+        if (flushed) {
+            return false;
+        }
+        flushed = true;
+        resampler->flush(converted);
+        return !converted.empty();
+    }
+    
+    const size_t frames = static_cast<size_t>(std::min<uint64_t>(STREAM_READ_FRAMES, (dataSize - dataRead) / frameBytes));
+    raw.resize(frames * frameBytes);
+    if (!file.read(raw.data(), raw.size())) {
+        std::cerr << "Error: Audio stream read failed: " << filepath << std::endl;
+        dataSize = dataRead;    // Play what was read, then end
+        looping = false;
+        return decodeNext();
+    }
+    dataRead += raw.size();
+    
+    // To float
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(raw.data());
+    if (bytesPerSample == 3) {
+        decoded.resize(frames * fileChannels);
+        for (size_t i = 0; i < decoded.size(); i++) {
+            const uint8_t* sample = bytes + i * 3;
+            int32_t value = static_cast<int32_t>(static_cast<uint32_t>(sample[0]) << 8 |
+                                                 static_cast<uint32_t>(sample[1]) << 16 |
+                                                 static_cast<uint32_t>(sample[2]) << 24);
+            decoded[i] = static_cast<float>(value * (1.0 / 2147483648.0));
+        }
+    } else {
+        using AudioKernels::SampleFormat;
+        const SampleFormat format = floatSamples ? SampleFormat::F32 :
+            bytesPerSample == 1 ? SampleFormat::U8 : bytesPerSample == 2 ? SampleFormat::S16 : SampleFormat::S32;
+        AudioKernels::decodeToFloat(bytes, raw.size(), format, decoded);
+    }
+    
+    if (fileChannels != channels) {
+        for (size_t frame = 0; frame < frames; frame++) {
+            float sum = 0.0f;
+            for (int c = 0; c < fileChannels; c++) {
+                sum += decoded[frame * fileChannels + c];
+            }
+            decoded[frame] = sum / fileChannels;
+        }
+    }
+    
+    resampler->process(decoded.data(), frames, converted);
+    return true;
+}
+
+void AudioStream::fill() {
+    while (!ended && !blocks[writeBlock].ready.load(std::memory_order_acquire)) {
+        Block& block = blocks[writeBlock];
+        block.frames = 0;
+        block.last = false;
+        
+        while (block.frames < BLOCK_FRAMES) {
+            const size_t pending = converted.size() / channels - convertedOffset;
+            if (pending == 0) {
+                if (!decodeNext()) {
+                    block.last = true;
+                    break;
+                }
+                continue;
+            }
+            
+            const size_t count = std::min(pending, BLOCK_FRAMES - block.frames);
+            std::copy_n(&converted[convertedOffset * channels], count * channels, &block.samples[block.frames * channels]);
+            block.frames += count;
+            convertedOffset += count;
+        }
+        
+        ended = block.last;
+        block.ready.store(true, std::memory_order_release);
+        writeBlock = (writeBlock + 1) % BLOCK_COUNT;
+    }
+}
+
+size_t AudioStream::peek(const float*& samples) {
+    Block& block = blocks[readBlock];
+    if (!block.ready.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    if (readOffset >= block.frames) {
+        // Only the last block is left unreturned once played
+        finished = block.last;
+        return 0;
+    }
+    samples = &block.samples[readOffset * channels];
+    return block.frames - readOffset;
+}
+
+void AudioStream::consume(size_t frames) {
+    Block& block = blocks[readBlock];
+    readOffset += frames;
+    if (readOffset >= block.frames && !block.last) {
+        // Hand the block back for refilling
+        block.ready.store(false, std::memory_order_release);
+        readBlock = (readBlock + 1) % BLOCK_COUNT;
+        readOffset = 0;
+    }
+}
+
+AudioStreamer::AudioStreamer() : stopping(false), syncRequested(false), passesStarted(0), passesDone(0) {
+    thread = std::thread(&AudioStreamer::threadLoop, this);
+}
+
+AudioStreamer::~AudioStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+    thread.join();
+}
+
+void AudioStreamer::add(AudioStream* stream) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        incoming.emplace_back(stream);
+    }
+    wakeCondition.notify_one();
+}
+
+void AudioStreamer::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t target = passesStarted + 1;
+    syncRequested = true;
+    wakeCondition.notify_one();
+    passCondition.wait(lock, [&] { return passesDone >= target || stopping; });
+}
+
+void AudioStreamer::threadLoop() {
+    while (true) {
+        {
+            // A block lasts ~186 ms; polling well inside that keeps both blocks full.
+            // New streams wake the thread at once so they start without waiting.
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(10),
+                                   [&] { return stopping || syncRequested || !incoming.empty(); });
+            if (stopping) {
+                return;
+            }
+            syncRequested = false;
+            passesStarted++;
+            for (auto& stream : incoming) {
+                streams.push_back(std::move(stream));
+            }
+            incoming.clear();
+        }
+        
+        for (auto& stream : streams) {
+            if (stream->isReleased()) {
+                stream.reset();
+                continue;
+            }
+            if (!stream->isOpen()) {
+                stream->open();
+            }
+            stream->fill();
+        }
+        streams.erase(std::remove(streams.begin(), streams.end(), nullptr), streams.end());
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            passesDone++;
+        }
+        passCondition.notify_all();
+    }
+}
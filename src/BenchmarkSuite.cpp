@@ -0,0 +1,158 @@
+#include "BenchmarkSuite.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+static double runSeconds(const BenchmarkSuite::Body& body, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string formatNanos(double nanoseconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(nanoseconds < 10.0 ? 2 : 1);
+    if (nanoseconds < 1.0e3) {
+        text << nanoseconds << " ns";
+    } else if (nanoseconds < 1.0e6) {
+        text << nanoseconds / 1.0e3 << " us";
+    } else {
+        text << nanoseconds / 1.0e6 << " ms";
+    }
+    return text.str();
+}
+
+static void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << (static_cast<unsigned char>(c) < 0x20 ? ' ' : c);
+    }
+    out << '"';
+}
+
+BenchmarkSuite::BenchmarkSuite(const Settings& settings, std::ostream& progress) : settings(settings), progress(progress) {
+    this->settings.repetitions = std::max(1, settings.repetitions);
+    this->settings.minSeconds = std::max(0.0, settings.minSeconds);
+}
+
+void BenchmarkSuite::addContext(const std::string& key, const std::string& value) {
+    context.emplace_back(key, value);
+}
+
+bool BenchmarkSuite::isSelected(const std::string& name) const {
+    return settings.filter.empty() || name.find(settings.filter) != std::string::npos;
+}
+
+void BenchmarkSuite::run(const std::string& name, size_t items, const Body& body) {
+    if (!isSelected(name)) return;
+    
+    // Grow the iteration count until one run is long enough to time; this also warms up
+    const double target = settings.minSeconds / settings.repetitions;
+    size_t iterations = 1;
+    for (;;) {
+        const double seconds = runSeconds(body, iterations);
+        if (seconds >= target || iterations >= (size_t(1) << 30)) break;
+        const double scale = seconds > 0.0 ? std::min(100.0, 1.2 * target / seconds) : 100.0;
+        iterations = std::max(iterations + 1, static_cast<size_t>(iterations * scale));
+    }
+    
+    std::vector<double> samples(settings.repetitions);
+    for (double& sample : samples) {
+        sample = runSeconds(body, iterations) * 1.0e9 / iterations;
+    }
+    
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.itemsPerIteration = std::max<size_t>(1, items);
+    std::sort(samples.begin(), samples.end());
+    const size_t middle = samples.size() / 2;
+    result.medianNs = samples.size() % 2 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+    result.minNs = samples.front();
+    for (double sample : samples) {
+        result.meanNs += sample / samples.size();
+    }
+    for (double sample : samples) {
+        result.stddevNs += (sample - result.meanNs) * (sample - result.meanNs);
+    }
+    result.stddevNs = samples.size() > 1 ? std::sqrt(result.stddevNs / (samples.size() - 1)) : 0.0;
+    results.push_back(result);
+    
+    // Progress as cases finish; the full table is printed at the end
+    std::ios::fmtflags savedFlags = progress.flags();
+    progress << std::left << std::setw(44) << name << formatNanos(result.medianNs) << std::endl;
+    progress.flags(savedFlags);
+}
+
+void BenchmarkSuite::print(std::ostream& out) const {
+    std::ios::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+    
+    out << std::left << std::setw(44) << "benchmark" << std::setw(12) << "iterations" << std::setw(14) << "median"
+        << std::setw(14) << "min" << std::setw(14) << "mean" << std::setw(10) << "stddev" << "items/sec" << std::endl;
+    for (const Result& result : results) {
+        const double deviation = result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0;
+        out << std::left << std::setw(44) << result.name << std::setw(12) << result.iterations
+            << std::setw(14) << formatNanos(result.medianNs) << std::setw(14) << formatNanos(result.minNs)
+            << std::setw(14) << formatNanos(result.meanNs)
+            << std::fixed << std::setprecision(1) << std::setw(10) << (std::to_string(static_cast<int>(std::round(deviation))) + "%")
+            << std::setprecision(3) << result.getItemsPerSecond() / 1.0e6 << " M" << std::endl;
+    }
+    
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
+
+bool BenchmarkSuite::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open benchmark results for writing: " << path << std::endl;
+        return false;
+    }
+    
+    char date[32] = {};
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    
+    out << "{\n  \"context\": {\n    \"date\": ";
+    writeJsonString(out, date);
+    out << ",\n    \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ",\n    \"repetitions\": " << settings.repetitions;
+    for (const std::pair<std::string, std::string>& entry : context) {
+        out << ",\n    ";
+        writeJsonString(out, entry.first);
+        out << ": ";
+        writeJsonString(out, entry.second);
+    }
+    out << "\n  },\n  \"benchmarks\": [";
+    
+    out << std::setprecision(6);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeJsonString(out, result.name);
+        out << ", \"iterations\": " << result.iterations
+            << ", \"real_time\": " << result.medianNs
+            << ", \"min_time\": " << result.minNs
+            << ", \"mean_time\": " << result.meanNs
+            << ", \"stddev_time\": " << result.stddevNs
+            << ", \"time_unit\": \"ns\""
+            << ", \"items_per_second\": " << result.getItemsPerSecond() << "}";
+    }
+    out << "\n  ]\n}\n";
+    
+    if (!out) {
+        std::cerr << "Failed to write benchmark results: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
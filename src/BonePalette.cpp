@@ -0,0 +1,58 @@
+#include "BonePalette.hpp"
+#include <algorithm>
+
+BonePalette::BonePalette(size_t initialCapacity)
+    : buffer(0), texture(0), capacity(std::max<size_t>(1, initialCapacity)) {
+    matrices.reserve(capacity);
+    
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    
+    // Each matrix is read back as four RGBA32F texels (one per column)
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+    
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+BonePalette::~BonePalette() {
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+}
+
+void BonePalette::beginFrame() {
+    matrices.clear();
+}
+
+int BonePalette::allocate(const std::vector<glm::mat4>& boneMatrices) {
+    int offset = static_cast<int>(matrices.size());
+    matrices.insert(matrices.end(), boneMatrices.begin(), boneMatrices.end());
+    return offset;
+}
+
+void BonePalette::upload() {
+    if (matrices.empty()) {
+        return;
+    }
+    
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    
+    if (matrices.size() > capacity) {
+        // Grow geometrically; the buffer texture keeps pointing at the same buffer name
+        capacity = std::max(matrices.size(), capacity * 2);
+    }
+    
+    // Orphan the old storage so we never stall on last frame's draws, then write the used range
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, matrices.size() * sizeof(glm::mat4), matrices.data());
+    
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BonePalette::bind(GLuint textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+}
@@ -216,11 +216,13 @@ Breakout::Breakout(SoundSystem& soundSystem, float left, float right, float top,
     AABB worldBounds(glm::vec3(left, bottom, -10.0f), glm::vec3(right, top, 10.0f));
     sceneGraph = std::make_unique<SceneGraph>(worldBounds);
     
-    // Load game sounds
-    paddleHitSound = soundSystem.loadSound("../audio/paddle_hit.wav");
-    brickHitSound = soundSystem.loadSound("../audio/brick_hit.wav");
-    wallHitSound = soundSystem.loadSound("../audio/wall_hit.wav");
-    loseLifeSound = soundSystem.loadSound("../audio/lose_life.wav");
+    // Load game sounds: one mapped bank (Main --build-soundbank ../audio ../audio/sounds.sbank),
+    // or the WAV files one by one when it has not been built
+    if (!soundSystem.loadBank(SOUND_BANK)) {
+        soundSystem.loadSound("../audio/paddle_hit.wav");
+        soundSystem.loadSound("../audio/brick_hit.wav");
+        soundSystem.loadSound("../audio/wall_hit.wav");
+    }
     
     std::cout << "Creating shapes directly..." << std::endl;
     
@@ -431,7 +433,7 @@ void Breakout::update(float deltaTime) {
     
     // Bottom wall - lose life
     if (ballPos.y - ballRadius <= bottomBoundary) {
-        soundSystem.playSound(loseLifeSound);
+        soundSystem.playStream(LOSE_LIFE_STREAM, false, 1);
         lives--;
         
         if (lives <= 0) {
@@ -452,6 +454,7 @@ void Breakout::update(float deltaTime) {
     
     if (allBricksDestroyed) {
         state = GameState::Win;
+        soundSystem.playStream(WIN_GAME_STREAM, false, 1);
     }
     
     // Update scene graph
@@ -0,0 +1,420 @@
+#include "CompressedAnimation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Smallest three components lie in [-1/sqrt(2), 1/sqrt(2)]
+static const float SMALLEST_THREE_RANGE = 0.70710678f;
+static const float QUANT_MAX = 32767.0f;            // 15 bits per component
+static const float TIME_MAX = 65535.0f;             // 16-bit normalized key times
+
+static const char CANIM_MAGIC[4] = { 'C', 'A', 'N', 'M' };
+static const uint32_t CANIM_VERSION = 2;            // 2: event track after the rotations
+
+// Angle between two rotations in degrees (q and -q are the same rotation)
+static float angleBetweenDegrees(const Quaternion& a, const Quaternion& b) {
+    float dot = std::fabs(a.getW() * b.getW() + a.getX() * b.getX() + a.getY() * b.getY() + a.getZ() * b.getZ());
+    return glm::degrees(2.0f * std::acos(std::min(1.0f, dot)));
+}
+
+PackedQuaternion PackedQuaternion::pack(const Quaternion& q) {
+    float c[4] = { q.getW(), q.getX(), q.getY(), q.getZ() };
+    
+    // Drop the largest component; it is rebuilt from unit length
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (std::fabs(c[i]) > std::fabs(c[largest])) largest = i;
+    }
+    
+    // Keep the dropped component positive so its sign needs no storage
+    float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+    
+    uint64_t packed = static_cast<uint64_t>(largest);
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        float normalized = (c[i] * sign + SMALLEST_THREE_RANGE) / (2.0f * SMALLEST_THREE_RANGE);
+        float clamped = std::min(1.0f, std::max(0.0f, normalized));
+        packed = (packed << 15) | static_cast<uint64_t>(std::lround(clamped * QUANT_MAX));
+    }
+    
+    PackedQuaternion result;
+    result.bits[0] = static_cast<uint16_t>(packed >> 32);
+    result.bits[1] = static_cast<uint16_t>(packed >> 16);
+    result.bits[2] = static_cast<uint16_t>(packed);
+    return result;
+}
+
+Quaternion PackedQuaternion::unpack() const {
+    uint64_t packed = (static_cast<uint64_t>(bits[0]) << 32) |
+                      (static_cast<uint64_t>(bits[1]) << 16) |
+                       static_cast<uint64_t>(bits[2]);
+    int largest = static_cast<int>((packed >> 45) & 0x3);
+    
+    float c[4];
+    float sumSquares = 0.0f;
+    int shift = 30;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        float quantized = static_cast<float>((packed >> shift) & 0x7FFF);
+        c[i] = quantized / QUANT_MAX * (2.0f * SMALLEST_THREE_RANGE) - SMALLEST_THREE_RANGE;
+        sumSquares += c[i] * c[i];
+        shift -= 15;
+    }
+    c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+    
+    return Quaternion(c[0], c[1], c[2], c[3]);
+}
+
+void AnimationCompressionStats::print(std::ostream& out) const {
+    float ratio = compressedBytes > 0 ? static_cast<float>(sourceBytes) / compressedBytes : 0.0f;
+    out << "Keys: " << sourceKeys << " -> " << storedKeys
+        << " (" << constantTracks << " constant tracks)" << std::endl;
+    out << "Memory: " << sourceBytes << " -> " << compressedBytes << " bytes ("
+        << ratio << "x smaller)" << std::endl;
+    out << "Rotation error: max " << maxErrorDegrees << " deg, mean " << meanErrorDegrees << " deg" << std::endl;
+}
+
+CompressedAnimation::CompressedAnimation() {}
+
+float CompressedAnimation::keyTime(uint32_t key) const {
+    return static_cast<float>(keyTimes[key]) / TIME_MAX * duration;
+}
+
+CompressedAnimation CompressedAnimation::compress(const Animation& source,
+                                                  const AnimationCompressionSettings& settings,
+                                                  AnimationCompressionStats* stats) {
+    CompressedAnimation clip;
+    clip.name = source.name;
+    clip.interpolationMode = source.interpolationMode;
+    clip.events = source.getEvents();
+    clip.duration = source.duration;
+    clip.poseSize = source.getPoseSize();
+    
+    size_t constantTracks = 0;
+    size_t sourceKeys = 0;
+    
+    for (const Animation::BoneTrack& track : source.tracks) {
+        const size_t count = track.times.size();
+        sourceKeys += count;
+        if (count == 0) {
+            continue;
+        }
+        
+        // Work on quantized values so the error check includes quantization
+        std::vector<uint16_t> times(count);
+        std::vector<PackedQuaternion> packed(count);
+        std::vector<Quaternion> decoded(count);
+        for (size_t i = 0; i < count; i++) {
+            float normalized = clip.duration > 0.0f ? track.times[i] / clip.duration : 0.0f;
+            times[i] = static_cast<uint16_t>(std::lround(std::min(1.0f, std::max(0.0f, normalized)) * TIME_MAX));
+            packed[i] = PackedQuaternion::pack(track.rotations[i]);
+            decoded[i] = packed[i].unpack();
+        }
+        auto decodedTime = [&](size_t i) { return static_cast<float>(times[i]) / TIME_MAX * clip.duration; };
+        
+        Track compressedTrack;
+        compressedTrack.boneID = track.boneID;
+        compressedTrack.firstKey = static_cast<uint32_t>(clip.keyTimes.size());
+        
+        // Constant track: every key reproduces the first one within tolerance
+        bool constant = true;
+        for (size_t i = 1; i < count && constant; i++) {
+            constant = angleBetweenDegrees(decoded[0], track.rotations[i]) <= settings.maxErrorDegrees;
+        }
+        
+        if (constant) {
+            clip.keyTimes.push_back(times[0]);
+            clip.keyRotations.push_back(packed[0]);
+            compressedTrack.keyCount = 1;
+            constantTracks++;
+        } else {
+            // Greedy key reduction: extend each segment while the dropped keys stay within tolerance
+            std::vector<size_t> kept;
+            kept.push_back(0);
+            size_t anchor = 0;
+            for (size_t end = anchor + 2; end < count; end++) {
+                bool fits = true;
+                float span = decodedTime(end) - decodedTime(anchor);
+                for (size_t k = anchor + 1; k < end && fits; k++) {
+                    float t = span > 0.0f ? (decodedTime(k) - decodedTime(anchor)) / span : 0.0f;
+                    Quaternion approx = slerp(decoded[anchor], decoded[end], t);
+                    fits = angleBetweenDegrees(approx, track.rotations[k]) <= settings.maxErrorDegrees;
+                }
+                if (!fits) {
+                    anchor = end - 1;
+                    kept.push_back(anchor);
+                }
+            }
+            if (count > 1) {
+                kept.push_back(count - 1);
+            }
+            
+            for (size_t i : kept) {
+                clip.keyTimes.push_back(times[i]);
+                clip.keyRotations.push_back(packed[i]);
+            }
+            compressedTrack.keyCount = static_cast<uint32_t>(kept.size());
+        }
+        
+        clip.tracks.push_back(compressedTrack);
+    }
+    
+    if (stats) {
+        stats->sourceKeys = sourceKeys;
+        stats->storedKeys = clip.keyTimes.size();
+        stats->constantTracks = constantTracks;
+        stats->sourceBytes = getMemoryUsage(source);
+        stats->compressedBytes = clip.getMemoryUsage();
+        
+        // Resample both clips densely and compare every animated bone
+        AnimationPose reference;
+        AnimationPose approximation;
+        source.preparePose(reference);
+        clip.preparePose(approximation);
+        
+        const int steps = std::max(2, static_cast<int>(std::ceil(clip.duration * 240.0f)) + 1);
+        double errorSum = 0.0;
+        size_t errorCount = 0;
+        float maxError = 0.0f;
+        for (int step = 0; step < steps; step++) {
+            float time = clip.duration * static_cast<float>(step) / static_cast<float>(steps - 1);
+            source.sample(time, reference);
+            clip.sample(time, approximation);
+            for (size_t bone = 0; bone < reference.size(); bone++) {
+                if (!reference.animated[bone]) continue;
+                float error = angleBetweenDegrees(reference.rotations[bone], approximation.rotations[bone]);
+                maxError = std::max(maxError, error);
+                errorSum += error;
+                errorCount++;
+            }
+        }
+        stats->maxErrorDegrees = maxError;
+        stats->meanErrorDegrees = errorCount > 0 ? static_cast<float>(errorSum / errorCount) : 0.0f;
+    }
+    
+    return clip;
+}
+
+template <typename Visitor>
+void CompressedAnimation::visitKeys(float time, Cursor* cursor, Visitor&& visit) const {
+    // Clamp time to animation duration
+    time = std::max(0.0f, std::min(time, duration));
+    
+    // Compare in 16-bit key units to avoid decoding every key time
+    const float keyUnits = duration > 0.0f ? time / duration * TIME_MAX : 0.0f;
+    
+    bool validCursor = cursor && cursor->keys.size() == tracks.size();
+    bool useCursor = validCursor && time >= cursor->lastTime;
+    
+    for (size_t t = 0; t < tracks.size(); t++) {
+        const Track& track = tracks[t];
+        size_t bone = static_cast<size_t>(track.boneID);
+        
+        const uint16_t* times = keyTimes.data() + track.firstKey;
+        const PackedQuaternion* rotations = keyRotations.data() + track.firstKey;
+        const uint32_t lastKey = track.keyCount - 1;
+        
+        // Constant track, or outside the key range: hold the end rotation
+        if (track.keyCount == 1 || keyUnits <= times[0]) {
+            Quaternion held = rotations[0].unpack();
+            visit(bone, held, held, 0.0f);
+            if (validCursor) cursor->keys[t] = 0;
+            continue;
+        }
+        if (keyUnits >= times[lastKey]) {
+            Quaternion held = rotations[lastKey].unpack();
+            visit(bone, held, held, 0.0f);
+            if (validCursor) cursor->keys[t] = lastKey;
+            continue;
+        }
+        
+        // Find the bracketing keys: step forward from the cursor, or binary search
+        uint32_t key;
+        if (useCursor) {
+            key = std::min(cursor->keys[t], lastKey - 1);
+            while (key + 1 < lastKey && times[key + 1] <= keyUnits) {
+                key++;
+            }
+        } else {
+            const uint16_t* it = std::upper_bound(times, times + track.keyCount, keyUnits,
+                                                  [](float value, uint16_t keyTime) { return value < keyTime; });
+            key = static_cast<uint32_t>(it - times - 1);
+        }
+        if (validCursor) {
+            cursor->keys[t] = key;
+        }
+        
+        float t0 = keyTime(track.firstKey + key);
+        float t1 = keyTime(track.firstKey + key + 1);
+        float alpha = t1 > t0 ? (time - t0) / (t1 - t0) : 0.0f;
+        
+        visit(bone, rotations[key].unpack(), rotations[key + 1].unpack(), alpha);
+    }
+    
+    if (cursor) {
+        cursor->lastTime = time;
+    }
+}
+
+void CompressedAnimation::sample(float time, AnimationPose& pose, Cursor* cursor) const {
+    visitKeys(time, cursor, [&](size_t bone, const Quaternion& q1, const Quaternion& q2, float alpha) {
+        if (bone >= pose.size()) {
+            return;
+        }
+        pose.animated[bone] = 1;
+        pose.rotations[bone] = alpha > 0.0f ? QuaternionMath::interpolate(interpolationMode, q1, q2, alpha) : q1;
+    });
+}
+
+void CompressedAnimation::gatherKeys(float time, Cursor* cursor, PoseKeyBatch& batch) const {
+    batch.count = 0;
+    visitKeys(time, cursor, [&](size_t bone, const Quaternion& q1, const Quaternion& q2, float alpha) {
+        batch.push(bone, q1, q2, alpha);
+    });
+}
+
+size_t CompressedAnimation::getMemoryUsage() const {
+    return tracks.size() * sizeof(Track) +
+           keyTimes.size() * sizeof(uint16_t) +
+           keyRotations.size() * sizeof(PackedQuaternion);
+}
+
+size_t CompressedAnimation::getMemoryUsage(const Animation& animation) {
+    size_t bytes = animation.tracks.size() * sizeof(Animation::BoneTrack);
+    for (const Animation::BoneTrack& track : animation.tracks) {
+        bytes += track.times.size() * sizeof(float) + track.rotations.size() * sizeof(Quaternion);
+    }
+    return bytes;
+}
+
+// Raw little-endian field I/O for the .canim format
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool CompressedAnimation::saveToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open compressed animation for writing: " << filename << std::endl;
+        return false;
+    }
+    
+    // Header
+    file.write(CANIM_MAGIC, sizeof(CANIM_MAGIC));
+    writeValue(file, CANIM_VERSION);
+    writeValue(file, static_cast<uint32_t>(name.size()));
+    file.write(name.data(), name.size());
+    writeValue(file, duration);
+    writeValue(file, static_cast<uint32_t>(poseSize));
+    writeValue(file, static_cast<uint32_t>(tracks.size()));
+    writeValue(file, static_cast<uint32_t>(keyTimes.size()));
+    
+    // Tracks, then key times, then packed rotations
+    for (const Track& track : tracks) {
+        writeValue(file, track.boneID);
+        writeValue(file, track.firstKey);
+        writeValue(file, track.keyCount);
+    }
+    file.write(reinterpret_cast<const char*>(keyTimes.data()), keyTimes.size() * sizeof(uint16_t));
+    for (const PackedQuaternion& rotation : keyRotations) {
+        file.write(reinterpret_cast<const char*>(rotation.bits), sizeof(rotation.bits));
+    }
+    
+    // Events store names; IDs are only valid within one process
+    writeValue(file, static_cast<uint32_t>(events.size()));
+    for (const EventKey& event : events) {
+        const std::string& eventName = AnimationEvents::getName(event.id);
+        writeValue(file, event.time);
+        writeValue(file, static_cast<uint32_t>(eventName.size()));
+        file.write(eventName.data(), eventName.size());
+    }
+    
+    return static_cast<bool>(file);
+}
+
+bool CompressedAnimation::loadFromFile(const std::string& filename, CompressedAnimation& animation) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open compressed animation file: " << filename << std::endl;
+        return false;
+    }
+    
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t nameLength = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, CANIM_MAGIC, sizeof(magic)) != 0 ||
+        !readValue(file, version) || version < 1 || version > CANIM_VERSION || !readValue(file, nameLength)) {
+        std::cerr << "Not a compressed animation file: " << filename << std::endl;
+        return false;
+    }
+    
+    CompressedAnimation clip;
+    uint32_t poseSize = 0;
+    uint32_t trackCount = 0;
+    uint32_t keyCount = 0;
+    clip.name.resize(nameLength);
+    if (!file.read(&clip.name[0], nameLength) || !readValue(file, clip.duration) ||
+        !readValue(file, poseSize) || !readValue(file, trackCount) || !readValue(file, keyCount)) {
+        std::cerr << "Truncated compressed animation header: " << filename << std::endl;
+        return false;
+    }
+    clip.poseSize = poseSize;
+    
+    clip.tracks.resize(trackCount);
+    for (Track& track : clip.tracks) {
+        if (!readValue(file, track.boneID) || !readValue(file, track.firstKey) || !readValue(file, track.keyCount) ||
+            track.boneID < 0 || static_cast<uint32_t>(track.boneID) >= poseSize ||
+            track.keyCount == 0 || track.firstKey > keyCount || track.keyCount > keyCount - track.firstKey) {
+            std::cerr << "Invalid track in compressed animation: " << filename << std::endl;
+            return false;
+        }
+    }
+    
+    clip.keyTimes.resize(keyCount);
+    clip.keyRotations.resize(keyCount);
+    if (!file.read(reinterpret_cast<char*>(clip.keyTimes.data()), keyCount * sizeof(uint16_t))) {
+        std::cerr << "Truncated key times in compressed animation: " << filename << std::endl;
+        return false;
+    }
+    for (PackedQuaternion& rotation : clip.keyRotations) {
+        if (!file.read(reinterpret_cast<char*>(rotation.bits), sizeof(rotation.bits))) {
+            std::cerr << "Truncated key rotations in compressed animation: " << filename << std::endl;
+            return false;
+        }
+    }
+    
+    // Version 1 files have no event track
+    uint32_t eventCount = 0;
+    if (version >= 2 && !readValue(file, eventCount)) {
+        std::cerr << "Truncated events in compressed animation: " << filename << std::endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < eventCount; i++) {
+        float time = 0.0f;
+        uint32_t eventNameLength = 0;
+        std::string eventName;
+        if (!readValue(file, time) || !readValue(file, eventNameLength) || eventNameLength > 1024) {
+            std::cerr << "Invalid event in compressed animation: " << filename << std::endl;
+            return false;
+        }
+        eventName.resize(eventNameLength);
+        if (eventNameLength > 0 && !file.read(&eventName[0], eventNameLength)) {
+            std::cerr << "Truncated events in compressed animation: " << filename << std::endl;
+            return false;
+        }
+        clip.addEvent(time, eventName);
+    }
+    
+    animation = std::move(clip);
+    std::cout << "Loaded compressed animation: " << animation.name << " with " << trackCount
+              << " bone tracks, " << keyCount << " keys, " << eventCount << " events, duration: " << animation.duration << "s" << std::endl;
+    return true;
+}
@@ -0,0 +1,349 @@
+#include "CpuSkinner.hpp"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CPU_SKINNER_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPU_SKINNER_SSE 1
+#endif
+
+// Below this many vertices per worker, threading costs more than it saves
+static const size_t MIN_VERTICES_PER_THREAD = 2048;
+
+static AABB emptyBounds() {
+    const float inf = std::numeric_limits<float>::max();
+    return AABB(glm::vec3(inf), glm::vec3(-inf));
+}
+
+CpuSkinner::CpuSkinner(const Shape& shape, JobSystem* jobSystem)
+    : vertexCount(0), boneCount(shape.getBoneCount()), jobSystem(jobSystem) {
+    initStreams(shape.getPositions(), shape.getNormals(), shape.getVertexBoneData());
+}
+
+CpuSkinner::CpuSkinner(const std::vector<glm::vec3>& positions,
+                       const std::vector<glm::vec3>& normals,
+                       const std::vector<VertexBoneData>& vertexBoneData,
+                       size_t boneCount,
+                       JobSystem* jobSystem)
+    : vertexCount(0), boneCount(boneCount), jobSystem(jobSystem) {
+    initStreams(positions, normals, vertexBoneData);
+}
+
+void CpuSkinner::initStreams(const std::vector<glm::vec3>& positions,
+                             const std::vector<glm::vec3>& normals,
+                             const std::vector<VertexBoneData>& vertexBoneData) {
+    vertexCount = std::min(positions.size(), normals.size());
+    if (boneCount >= std::numeric_limits<uint16_t>::max()) {
+        std::cerr << "Error: CpuSkinner supports at most 65534 bones" << std::endl;
+        boneCount = 0;
+    }
+    
+    bindPX.resize(vertexCount); bindPY.resize(vertexCount); bindPZ.resize(vertexCount);
+    bindNX.resize(vertexCount); bindNY.resize(vertexCount); bindNZ.resize(vertexCount);
+    outPX.resize(vertexCount);  outPY.resize(vertexCount);  outPZ.resize(vertexCount);
+    outNX.resize(vertexCount);  outNY.resize(vertexCount);  outNZ.resize(vertexCount);
+    boneIndices.assign(vertexCount * 4, 0);
+    boneWeights.assign(vertexCount * 4, 0.0f);
+    
+    const uint16_t fallbackSlot = static_cast<uint16_t>(boneCount);
+    
+    for (size_t i = 0; i < vertexCount; ++i) {
+        bindPX[i] = positions[i].x; bindPY[i] = positions[i].y; bindPZ[i] = positions[i].z;
+        bindNX[i] = normals[i].x;   bindNY[i] = normals[i].y;   bindNZ[i] = normals[i].z;
+        
+        // Keep valid influences and normalize them, matching the shader path
+        float weightSum = 0.0f;
+        if (i < vertexBoneData.size()) {
+            for (int j = 0; j < 4; ++j) {
+                int index = vertexBoneData[i].indices[j];
+                float weight = vertexBoneData[i].weights[j];
+                if (weight > 0.0f && index >= 0 && static_cast<size_t>(index) < boneCount) {
+                    boneIndices[i * 4 + j] = static_cast<uint16_t>(index);
+                    boneWeights[i * 4 + j] = weight;
+                    weightSum += weight;
+                }
+            }
+        }
+        
+        if (weightSum > 0.0f) {
+            for (int j = 0; j < 4; ++j) {
+                boneWeights[i * 4 + j] /= weightSum;
+            }
+        } else {
+            // Unweighted vertex: fully bound to the model matrix slot
+            boneIndices[i * 4] = fallbackSlot;
+            boneWeights[i * 4] = 1.0f;
+        }
+    }
+    
+    palette.resize(boneCount + 1, glm::mat4(1.0f));
+    bounds = emptyBounds();
+}
+
+bool CpuSkinner::skin(const std::vector<glm::mat4>& boneMatrices, const glm::mat4& modelMatrix,
+                      Kernel kernel) {
+    if (boneMatrices.size() < boneCount) {
+        std::cerr << "Error: CpuSkinner expected " << boneCount << " bone matrices, got "
+                  << boneMatrices.size() << std::endl;
+        return false;
+    }
+    
+    std::copy(boneMatrices.begin(), boneMatrices.begin() + boneCount, palette.begin());
+    palette[boneCount] = modelMatrix;
+    
+    // One chunk per thread, unless that would leave a thread too little work
+    size_t chunks = std::min<size_t>(getThreadCount(), std::max<size_t>(1, vertexCount / MIN_VERTICES_PER_THREAD));
+    size_t chunkSize = (vertexCount + chunks - 1) / chunks;
+    chunkSize = (chunkSize + 7) & ~static_cast<size_t>(7);   // Keep chunks SIMD-aligned
+    chunkBounds.assign(chunks, emptyBounds());
+    
+    auto runChunk = [this, kernel, chunkSize](size_t chunk) {
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(vertexCount, begin + chunkSize);
+        if (begin >= end) return;
+        if (kernel == Kernel::SIMD) {
+            skinRangeSIMD(begin, end, chunkBounds[chunk]);
+        } else {
+            skinRangeScalar(begin, end, chunkBounds[chunk]);
+        }
+    };
+    
+    if (chunks > 1) {
+        jobSystem->parallelFor(chunks, 1, [&runChunk](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                runChunk(chunk);
+            }
+        });
+    } else {
+        runChunk(0);
+    }
+    
+    bounds = emptyBounds();
+    for (const AABB& chunk : chunkBounds) {
+        bounds = bounds.merge(chunk);
+    }
+    return true;
+}
+
+void CpuSkinner::skinRangeScalar(size_t begin, size_t end, AABB& rangeBounds) {
+    glm::vec3 minP = rangeBounds.min;
+    glm::vec3 maxP = rangeBounds.max;
+    
+    for (size_t i = begin; i < end; ++i) {
+        const uint16_t* idx = &boneIndices[i * 4];
+        const float* w = &boneWeights[i * 4];
+        
+        // Blend the four influences into one matrix, then transform once
+        glm::mat4 blended = palette[idx[0]] * w[0] + palette[idx[1]] * w[1]
+                          + palette[idx[2]] * w[2] + palette[idx[3]] * w[3];
+        
+        glm::vec4 p = blended * glm::vec4(bindPX[i], bindPY[i], bindPZ[i], 1.0f);
+        glm::vec3 n = glm::mat3(blended) * glm::vec3(bindNX[i], bindNY[i], bindNZ[i]);
+        
+        float lengthSq = glm::dot(n, n);
+        if (lengthSq > 0.0f) {
+            n *= 1.0f / std::sqrt(lengthSq);
+        }
+        
+        outPX[i] = p.x; outPY[i] = p.y; outPZ[i] = p.z;
+        outNX[i] = n.x; outNY[i] = n.y; outNZ[i] = n.z;
+        
+        minP = glm::min(minP, glm::vec3(p));
+        maxP = glm::max(maxP, glm::vec3(p));
+    }
+    
+    rangeBounds = AABB(minP, maxP);
+}
+
+#if defined(CPU_SKINNER_SSE)
+// Normalize the xyz lanes of v (w is expected to be zero)
+static inline __m128 normalize3(__m128 v) {
+    __m128 sq = _mm_mul_ps(v, v);
+    __m128 shuf = _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(sq, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    __m128 lengthSq = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 valid = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+    __m128 normalized = _mm_div_ps(v, _mm_sqrt_ps(lengthSq));
+    return _mm_or_ps(_mm_and_ps(valid, normalized), _mm_andnot_ps(valid, v));
+}
+
+// Blend four bone matrices column by column
+static inline void blendColumns(const float* m0, const float* m1, const float* m2, const float* m3,
+                                const float* w, __m128 columns[4]) {
+    __m128 w0 = _mm_set1_ps(w[0]);
+    __m128 w1 = _mm_set1_ps(w[1]);
+    __m128 w2 = _mm_set1_ps(w[2]);
+    __m128 w3 = _mm_set1_ps(w[3]);
+    for (int c = 0; c < 4; ++c) {
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m0 + c * 4), w0), _mm_mul_ps(_mm_loadu_ps(m1 + c * 4), w1));
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m2 + c * 4), w2), _mm_mul_ps(_mm_loadu_ps(m3 + c * 4), w3));
+        columns[c] = _mm_add_ps(a, b);
+    }
+}
+#endif
+
+#if defined(CPU_SKINNER_AVX)
+// Blend four bone matrices two columns at a time (columns 0-1 and 2-3 are contiguous)
+static inline void blendColumnsAVX(const float* m0, const float* m1, const float* m2, const float* m3,
+                                   const float* w, __m128 columns[4]) {
+    __m256 w0 = _mm256_broadcast_ss(w + 0);
+    __m256 w1 = _mm256_broadcast_ss(w + 1);
+    __m256 w2 = _mm256_broadcast_ss(w + 2);
+    __m256 w3 = _mm256_broadcast_ss(w + 3);
+    __m256 c01 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(m0), w0), _mm256_mul_ps(_mm256_loadu_ps(m1), w1)),
+                               _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(m2), w2), _mm256_mul_ps(_mm256_loadu_ps(m3), w3)));
+    __m256 c23 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(m0 + 8), w0), _mm256_mul_ps(_mm256_loadu_ps(m1 + 8), w1)),
+                               _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(m2 + 8), w2), _mm256_mul_ps(_mm256_loadu_ps(m3 + 8), w3)));
+    columns[0] = _mm256_castps256_ps128(c01);
+    columns[1] = _mm256_extractf128_ps(c01, 1);
+    columns[2] = _mm256_castps256_ps128(c23);
+    columns[3] = _mm256_extractf128_ps(c23, 1);
+}
+#endif
+
+void CpuSkinner::skinRangeSIMD(size_t begin, size_t end, AABB& rangeBounds) {
+#if defined(CPU_SKINNER_SSE)
+    const float inf = std::numeric_limits<float>::max();
+    __m128 minP = _mm_set1_ps(inf);
+    __m128 maxP = _mm_set1_ps(-inf);
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    alignas(16) float p[4];
+    alignas(16) float n[4];
+    
+    auto matrix = [this](uint16_t index) { return glm::value_ptr(palette[index]); };
+    
+    for (size_t i = begin; i < end; ++i) {
+        const uint16_t* idx = &boneIndices[i * 4];
+        __m128 columns[4];
+#if defined(CPU_SKINNER_AVX)
+        blendColumnsAVX(matrix(idx[0]), matrix(idx[1]), matrix(idx[2]), matrix(idx[3]),
+                        &boneWeights[i * 4], columns);
+#else
+        blendColumns(matrix(idx[0]), matrix(idx[1]), matrix(idx[2]), matrix(idx[3]),
+                     &boneWeights[i * 4], columns);
+#endif
+
+        __m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(bindPX[i])),
+                                           _mm_mul_ps(columns[1], _mm_set1_ps(bindPY[i]))),
+                                _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(bindPZ[i])), columns[3]));
+        __m128 nrm = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(bindNX[i])),
+                                           _mm_mul_ps(columns[1], _mm_set1_ps(bindNY[i]))),
+                                _mm_mul_ps(columns[2], _mm_set1_ps(bindNZ[i])));
+        nrm = normalize3(_mm_and_ps(nrm, xyzMask));
+        
+        minP = _mm_min_ps(minP, pos);
+        maxP = _mm_max_ps(maxP, pos);
+        
+        _mm_store_ps(p, pos);
+        _mm_store_ps(n, nrm);
+        outPX[i] = p[0]; outPY[i] = p[1]; outPZ[i] = p[2];
+        outNX[i] = n[0]; outNY[i] = n[1]; outNZ[i] = n[2];
+    }
+    
+    alignas(16) float lo[4];
+    alignas(16) float hi[4];
+    _mm_store_ps(lo, minP);
+    _mm_store_ps(hi, maxP);
+    rangeBounds = AABB(glm::vec3(lo[0], lo[1], lo[2]), glm::vec3(hi[0], hi[1], hi[2]));
+#else
+    // No SIMD instruction set available for this target
+    skinRangeScalar(begin, end, rangeBounds);
+#endif
+}
+
+const std::vector<float>& CpuSkinner::packVertexData() {
+    // Shape VBOs store all positions, then all normals (AoS vec3 each)
+    vertexData.resize(vertexCount * 6);
+    float* positions = vertexData.data();
+    float* normals = vertexData.data() + vertexCount * 3;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        positions[i * 3 + 0] = outPX[i];
+        positions[i * 3 + 1] = outPY[i];
+        positions[i * 3 + 2] = outPZ[i];
+        normals[i * 3 + 0] = outNX[i];
+        normals[i * 3 + 1] = outNY[i];
+        normals[i * 3 + 2] = outNZ[i];
+    }
+    return vertexData;
+}
+
+const char* CpuSkinner::simdPathName() {
+#if defined(CPU_SKINNER_AVX)
+    return "AVX";
+#elif defined(CPU_SKINNER_SSE)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+void CpuSkinner::runBenchmark(const std::vector<glm::vec3>& positions,
+                              const std::vector<glm::vec3>& normals,
+                              const std::vector<VertexBoneData>& vertexBoneData,
+                              const std::vector<glm::mat4>& boneMatrices,
+                              int iterations,
+                              std::ostream& out) {
+    JobSystem jobSystem;   // One worker per hardware thread besides this one
+    std::ios::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+    CpuSkinner reference(positions, normals, vertexBoneData, boneMatrices.size());
+    reference.skin(boneMatrices, glm::mat4(1.0f), Kernel::Scalar);
+    
+    out << "CPU skinning benchmark: " << reference.getVertexCount() << " vertices, "
+        << boneMatrices.size() << " bones, " << iterations << " iterations, SIMD path "
+        << simdPathName() << std::endl;
+    out << std::left << std::setw(10) << "kernel" << std::setw(10) << "threads"
+        << std::setw(14) << "ms/iter" << std::setw(16) << "Mverts/sec" << "max error" << std::endl;
+    
+    const Kernel kernels[2] = { Kernel::Scalar, Kernel::SIMD };
+    const unsigned threadCounts[2] = { 1, jobSystem.getWorkerCount() + 1 };
+    
+    for (Kernel kernel : kernels) {
+        for (unsigned threads : threadCounts) {
+            CpuSkinner skinner(positions, normals, vertexBoneData, boneMatrices.size(),
+                               threads > 1 ? &jobSystem : nullptr);
+            skinner.skin(boneMatrices, glm::mat4(1.0f), kernel);   // Warm-up
+            
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                skinner.skin(boneMatrices, glm::mat4(1.0f), kernel);
+            }
+            auto stop = std::chrono::steady_clock::now();
+            
+            double seconds = std::chrono::duration<double>(stop - start).count();
+            double msPerIteration = seconds * 1000.0 / std::max(1, iterations);
+            double verticesPerSecond = seconds > 0.0
+                ? static_cast<double>(skinner.getVertexCount()) * iterations / seconds : 0.0;
+            
+            // Compare against the single-threaded scalar result
+            float maxError = 0.0f;
+            for (size_t v = 0; v < skinner.getVertexCount(); ++v) {
+                glm::vec3 d = glm::abs(skinner.getPosition(v) - reference.getPosition(v));
+                maxError = std::max(maxError, std::max(d.x, std::max(d.y, d.z)));
+            }
+            
+            out << std::left << std::setw(10) << (kernel == Kernel::SIMD ? "simd" : "scalar")
+                << std::setw(10) << threads
+                << std::setw(14) << std::fixed << std::setprecision(4) << msPerIteration
+                << std::setw(16) << std::setprecision(2) << verticesPerSecond / 1.0e6
+                << std::scientific << std::setprecision(2) << maxError
+                << std::defaultfloat << std::endl;
+            
+            if (threads == threadCounts[1]) break;   // Single-core machine: one row is enough
+        }
+    }
+    
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
@@ -3,27 +3,32 @@
 
 DeferredRenderer::DeferredRenderer(int width, int height, 
                                  const std::string& geoVertPath, const std::string& geoFragPath,
-                                 const std::string& lightVertPath, const std::string& lightFragPath) 
-    : screenWidth(width), screenHeight(height),
+                                 const std::string& lightVertPath, const std::string& lightFragPath,
+                                 GBufferLayout layout) 
+    : layout(layout),
+      // Initialize gBuffer in the initialization list from the layout preset
+      gBuffer(width, height, TextureProperties::gBufferPreset(layout), true,
+              TextureProperties::gBufferNeedsDepthTexture(layout)),
       geometryShader(geoVertPath, geoFragPath),
       lightingShader(lightVertPath, lightFragPath),
-      // Initialize gBuffer in the initialization list
-      gBuffer(width, height, {
-            TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST),  // Diffuse
-            TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST),  // Normal
-            TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST)   // Position
-      }, true)
+      screenWidth(width), screenHeight(height),
+      viewMatrix(1.0f), projMatrix(1.0f)
 {
     // Create screen quad for lighting pass
     quadVAO = createScreenQuad();
     
     // Set up lighting shader uniforms (using uniform instead of setInt)
     lightingShader.use();
-    glUniform1i(glGetUniformLocation(lightingShader.program, "gDiffuse"), 0);
-    glUniform1i(glGetUniformLocation(lightingShader.program, "gNormal"), 1);
-    glUniform1i(glGetUniformLocation(lightingShader.program, "gPosition"), 2);
+    glUniform1i(glGetUniformLocation(lightingShader.program, "diffuseTexture"), 0);
+    glUniform1i(glGetUniformLocation(lightingShader.program, "normalTexture"), 1);
+    if (layout == GBufferLayout::Compact) {
+        glUniform1i(glGetUniformLocation(lightingShader.program, "depthTexture"), 2);
+    } else {
+        glUniform1i(glGetUniformLocation(lightingShader.program, "positionTexture"), 2);
+    }
     
-    std::cout << "G-Buffer created successfully with 3 attachments" << std::endl;
+    std::cout << "G-Buffer created successfully with " << gBuffer.getTextureCount() << " attachments"
+              << (layout == GBufferLayout::Compact ? " (compact layout)" : "") << std::endl;
 }
 
 DeferredRenderer::~DeferredRenderer() {
@@ -98,7 +103,14 @@ void DeferredRenderer::renderLighting(const glm::vec3& lightPos, const glm::vec3
     glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(1)); // Normal
     
     glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(2)); // Position
+    if (layout == GBufferLayout::Compact) {
+        glBindTexture(GL_TEXTURE_2D, gBuffer.getDepthTexture()); // Depth (position is rebuilt from it)
+        
+        glm::mat4 invViewProj = glm::inverse(projMatrix * viewMatrix);
+        glUniformMatrix4fv(glGetUniformLocation(lightingShader.program, "invViewProj"), 1, GL_FALSE, &invViewProj[0][0]);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(2)); // Position
+    }
     
     // Set light properties using glUniform instead of setVec3
     glUniform3fv(glGetUniformLocation(lightingShader.program, "lightPos"), 1, &lightPos[0]);
@@ -127,20 +139,32 @@ void DeferredRenderer::setBoneMatrices(const std::vector<glm::mat4>& boneMatrice
         int boneCount = static_cast<int>(boneMatrices.size());
         glUniform1i(glGetUniformLocation(geometryShader.program, "boneCount"), boneCount);
         
-        // Set bone matrices
-        for (int i = 0; i < boneCount; i++) {
-            std::string uniformName = "boneMatrices[" + std::to_string(i) + "]";
-            glUniformMatrix4fv(
-                glGetUniformLocation(geometryShader.program, uniformName.c_str()),
-                1, GL_FALSE, &boneMatrices[i][0][0]
-            );
+        // Set all bone matrices with one call (the array is contiguous)
+        glUniform1i(glGetUniformLocation(geometryShader.program, "useBonePalette"), 0);
+        if (boneCount > 0) {
+            glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "boneMatrices"),
+                               boneCount, GL_FALSE, &boneMatrices[0][0][0]);
         }
     }
 }
 
+void DeferredRenderer::setBonePalette(const BonePalette& palette, int boneOffset, int boneCount) {
+    geometryShader.use();
+    
+    // Palette goes on texture unit 1 so the diffuse texture keeps unit 0
+    palette.bind(1);
+    glUniform1i(glGetUniformLocation(geometryShader.program, "bonePalette"), 1);
+    glActiveTexture(GL_TEXTURE0);
+    
+    glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 1);
+    glUniform1i(glGetUniformLocation(geometryShader.program, "useBonePalette"), 1);
+    glUniform1i(glGetUniformLocation(geometryShader.program, "boneOffset"), boneOffset);
+    glUniform1i(glGetUniformLocation(geometryShader.program, "boneCount"), boneCount);
+}
+
 void DeferredRenderer::renderGBufferTexture(int textureIndex) {
     // Make sure the index is valid
-    if (textureIndex < 0 || textureIndex >= 3) {
+    if (textureIndex < 0 || textureIndex >= static_cast<int>(gBuffer.getTextureCount())) {
         std::cerr << "Invalid G-Buffer texture index: " << textureIndex << std::endl;
         return;
     }
@@ -216,6 +240,10 @@ void DeferredRenderer::renderGBufferTexture(int textureIndex) {
 }
 
 void DeferredRenderer::setMatrices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj) {
+    // Keep view/projection for the lighting pass
+    viewMatrix = view;
+    projMatrix = proj;
+    
     geometryShader.use();
     
     // Use glUniform instead of setMat4
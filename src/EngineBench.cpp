@@ -0,0 +1,617 @@
+// engine_bench: headless benchmarks of the engine's hot paths (no window or GL context).
+// Usage: engine_bench [--filter text] [--json results.json] [--min-time seconds]
+//                     [--repetitions n] [--assets dir] [--check]
+// Self-checks run first and fail the run on a mismatch; --check runs only them.
+#include "BenchmarkSuite.hpp"
+#include "Shape.hpp"
+#include "GameObject.hpp"
+#include "SceneGraph.hpp"
+#include "Camera.hpp"
+#include "GJK.hpp"
+#include "MPR.hpp"
+#include "Animations.hpp"
+#include "CompressedAnimation.hpp"
+#include "CpuSkinner.hpp"
+#include "QuaternionMath.hpp"
+#include "AudioMixer.hpp"
+#include "AudioKernels.hpp"
+#include "Profiler.hpp"
+#include "RenderGraph.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#ifndef ENGINE_ASSET_DIR
+#define ENGINE_ASSET_DIR ".."
+#endif
+
+#ifndef ENGINE_BUILD_TYPE
+#define ENGINE_BUILD_TYPE "unknown"
+#endif
+
+// Scene sizes (objects) for the spatial structure and broad phase
+static const size_t SCENE_SIZES[] = { 64, 512, 4096 };
+
+// Repo meshes, smallest first, for the narrow phase and the parser
+static const char* const MESHES[] = { "suzanne", "armature", "shape", "ipadHead" };
+
+// Whether any of a group's cases would run (skip the group's setup otherwise)
+static bool anySelected(const BenchmarkSuite& suite, const std::vector<std::string>& names) {
+    for (const std::string& name : names) {
+        if (suite.isSelected(name)) return true;
+    }
+    return false;
+}
+
+static std::unique_ptr<Shape> loadShape(const std::string& assets, const std::string& mesh) {
+    std::unique_ptr<Shape> shape(createShapeFromFile(assets + "/" + mesh + ".mesh"));
+    if (!shape || !shape->hasVertexData()) {
+        std::cerr << "Failed to load " << mesh << ".mesh from " << assets << " (see --assets)" << std::endl;
+        return nullptr;
+    }
+    return shape;
+}
+
+// Objects scattered at constant density (so bigger scenes are bigger, not more crowded),
+// each circling its start point once a second
+static void buildScene(const Shape& shape, size_t count, std::vector<std::unique_ptr<GameObject>>& objects,
+                       SceneGraph& sceneGraph, float& halfSize) {
+    halfSize = 2.5f * std::cbrt(static_cast<float>(count));
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-halfSize, halfSize);
+    std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+    
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec3 start(coordinate(rng), coordinate(rng), coordinate(rng));
+        objects.emplace_back(new GameObject(start, Quaternion(), shape, static_cast<int>(i)));
+        float angle = phase(rng);
+        objects.back()->setUpdateFunction([start, angle](GameObject* object, float deltaTime) mutable {
+            angle += 6.2831853f * deltaTime;
+            object->setPosition(start + 0.5f * glm::vec3(std::cos(angle), std::sin(angle), 0.0f));
+        });
+        sceneGraph.addObject(objects.back().get());
+    }
+    sceneGraph.updateSpatialStructure();
+}
+
+static void benchSpatial(BenchmarkSuite& suite, const std::string& assets) {
+    std::unique_ptr<Shape> shape;
+    for (size_t count : SCENE_SIZES) {
+        const std::string size = "/" + std::to_string(count);
+        if (!anySelected(suite, { "octree/build" + size, "octree/update" + size, "octree/query" + size,
+                                  "broadphase/pairs" + size })) continue;
+        
+        // Loaded on first use, so a filter that skips the group skips the parse too
+        if (!shape) shape = loadShape(assets, "suzanne");
+        if (!shape) return;
+        
+        std::vector<std::unique_ptr<GameObject>> objects;
+        SceneGraph sceneGraph;
+        float halfSize = 0.0f;
+        buildScene(*shape, count, objects, sceneGraph, halfSize);
+        
+        suite.run("octree/build" + size, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                sceneGraph.updateSpatialStructure();
+            }
+        });
+        
+        // Objects move, then the octree re-files them (the per-frame path)
+        suite.run("octree/update" + size, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                sceneGraph.updateSpatialStructure(1.0f / 60.0f);
+            }
+        });
+        
+        // Frustum culling from outside the scene, looking at its middle
+        Camera camera(60.0f, 16.0f / 9.0f, 0.1f, 4.0f * halfSize + 100.0f);
+        camera.setPosition(glm::vec3(0.0f, 0.0f, 2.0f * halfSize));
+        camera.setTarget(glm::vec3(0.0f));
+        camera.updateMatrices();
+        std::vector<GameObject*> visible;
+        suite.run("octree/query" + size, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                visible.clear();
+                sceneGraph.getVisibleObjects(visible, camera);
+                benchmarkKeep(visible.size());
+            }
+        });
+        
+        std::vector<std::pair<GameObject*, GameObject*>> pairs;
+        suite.run("broadphase/pairs" + size, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                pairs.clear();
+                sceneGraph.detectCollisions(pairs);
+                benchmarkKeep(pairs.size());
+            }
+        });
+    }
+}
+
+static void benchNarrowPhase(BenchmarkSuite& suite, const std::string& assets) {
+    for (const char* mesh : MESHES) {
+        const std::string name = mesh;
+        if (!anySelected(suite, { "gjk/" + name + "/overlap", "gjk/" + name + "/separated",
+                                  "mpr/" + name + "/overlap", "mpr/" + name + "/separated" })) continue;
+        std::unique_ptr<Shape> shape = loadShape(assets, name);
+        if (!shape) continue;
+        
+        // The same mesh twice, B turned a little about its centre: centres 0.3 widths
+        // apart (overlapping), or further apart than the mesh's diagonal (separated)
+        glm::vec3 lower(std::numeric_limits<float>::max());
+        glm::vec3 upper(-std::numeric_limits<float>::max());
+        for (const glm::vec3& position : shape->getPositions()) {
+            lower = glm::min(lower, position);
+            upper = glm::max(upper, position);
+        }
+        const glm::vec3 center = 0.5f * (lower + upper);
+        Quaternion rotationA;
+        Quaternion rotationB(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::vec3 positionA = -center;
+        const glm::vec3 touching = -rotationB.rotate(center) + glm::vec3(0.3f * (upper.x - lower.x), 0.0f, 0.0f);
+        const glm::vec3 apart = -rotationB.rotate(center) + glm::vec3(1.1f * glm::length(upper - lower), 0.0f, 0.0f);
+        const size_t vertices = shape->getVertexCount();
+        
+        // Both outcomes are timed regardless; say so when an algorithm disagrees with the placement
+        if (!Collision::GJK(*shape, rotationA, positionA, *shape, rotationB, touching).collision ||
+            Collision::GJK(*shape, rotationA, positionA, *shape, rotationB, apart).collision) {
+            std::cerr << "Warning: GJK misjudges the " << name << " overlap/separated placement" << std::endl;
+        }
+        if (!Collision::MPR(*shape, rotationA, positionA, *shape, rotationB, touching) ||
+            Collision::MPR(*shape, rotationA, positionA, *shape, rotationB, apart)) {
+            std::cerr << "Warning: MPR misjudges the " << name << " overlap/separated placement" << std::endl;
+        }
+        
+        suite.run("gjk/" + name + "/overlap", vertices, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                benchmarkKeep(Collision::GJK(*shape, rotationA, positionA, *shape, rotationB, touching));
+            }
+        });
+        suite.run("gjk/" + name + "/separated", vertices, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                benchmarkKeep(Collision::GJK(*shape, rotationA, positionA, *shape, rotationB, apart));
+            }
+        });
+        suite.run("mpr/" + name + "/overlap", vertices, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                benchmarkKeep(Collision::MPR(*shape, rotationA, positionA, *shape, rotationB, touching));
+            }
+        });
+        suite.run("mpr/" + name + "/separated", vertices, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                benchmarkKeep(Collision::MPR(*shape, rotationA, positionA, *shape, rotationB, apart));
+            }
+        });
+    }
+}
+
+static void benchAnimation(BenchmarkSuite& suite, const std::string& assets) {
+    const size_t crowdSizes[] = { 16, 128, 1024 };
+    std::vector<std::string> names = { "animation/sample/keyframed", "animation/sample/compressed" };
+    for (size_t count : crowdSizes) {
+        names.push_back("animation/manager/" + std::to_string(count));
+    }
+    if (!anySelected(suite, names)) return;
+    
+    const std::string clipPath = assets + "/animation.anim";
+    Animation clip = Animation::loadFromFile(clipPath);
+    if (clip.duration <= 0.0f) {
+        std::cerr << "Failed to load " << clipPath << std::endl;
+        return;
+    }
+    CompressedAnimation compressed = CompressedAnimation::compress(clip);
+    
+    // One pose per frame at 60 Hz, looping, as a playing clip samples
+    auto sampleClip = [&](const AnimationClip& source) {
+        AnimationPose pose;
+        AnimationClip::Cursor cursor;
+        source.preparePose(pose);
+        source.prepareCursor(cursor);
+        float time = 0.0f;
+        return [&source, pose, cursor, time](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                time = std::fmod(time + 1.0f / 60.0f, source.duration);
+                source.sample(time, pose, &cursor);
+                benchmarkKeep(pose.rotations.data());
+            }
+        };
+    };
+    suite.run("animation/sample/keyframed", clip.getTrackCount(), sampleClip(clip));
+    suite.run("animation/sample/compressed", compressed.getTrackCount(), sampleClip(compressed));
+    
+    // The manager's whole frame (clocks, sampling, posing skeletons) for crowds of armatures
+    std::unique_ptr<Shape> armature = loadShape(assets, "armature");
+    if (!armature) return;
+    for (size_t count : crowdSizes) {
+        const std::string name = "animation/manager/" + std::to_string(count);
+        if (!suite.isSelected(name)) continue;
+        
+        std::vector<std::unique_ptr<GameObject>> objects;
+        AnimationManager manager;
+        manager.loadAnimation("clip", clipPath);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> phase(0.0f, clip.duration);
+        for (size_t i = 0; i < count; i++) {
+            objects.emplace_back(new GameObject(glm::vec3(static_cast<float>(i), 0.0f, 0.0f), Quaternion(), *armature,
+                                                static_cast<int>(i)));
+            manager.playAnimation(objects.back().get(), "clip", true);
+            manager.getPlayer(objects.back().get())->setTime(phase(rng));
+        }
+        
+        suite.run(name, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                manager.update(1.0f / 60.0f);
+            }
+        });
+    }
+}
+
+static void benchSkinning(BenchmarkSuite& suite) {
+    const size_t vertexCounts[] = { 1024, 16384, 131072 };
+    const size_t boneCount = 64;
+    
+    // A posed palette: every bone turned and shifted a little
+    std::vector<glm::mat4> boneMatrices(boneCount);
+    for (size_t b = 0; b < boneCount; b++) {
+        const float angle = 0.02f * static_cast<float>(b + 1);
+        boneMatrices[b] = glm::mat4(glm::vec4(std::cos(angle), std::sin(angle), 0.0f, 0.0f),
+                                    glm::vec4(-std::sin(angle), std::cos(angle), 0.0f, 0.0f),
+                                    glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+                                    glm::vec4(0.01f * static_cast<float>(b), 0.0f, 0.0f, 1.0f));
+    }
+    
+    for (size_t count : vertexCounts) {
+        const std::string size = "/" + std::to_string(count);
+        if (!anySelected(suite, { "skinning/scalar" + size, "skinning/simd" + size,
+                                  "skinning/simd_parallel" + size })) continue;
+        
+        // Random vertices with four influences each, like a dense character mesh
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+        std::uniform_int_distribution<int> bone(0, static_cast<int>(boneCount) - 1);
+        std::vector<glm::vec3> positions(count), normals(count);
+        std::vector<VertexBoneData> vertexBoneData(count);
+        for (size_t i = 0; i < count; i++) {
+            positions[i] = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+            normals[i] = glm::normalize(glm::vec3(coordinate(rng), coordinate(rng), 1.0f));
+            for (int j = 0; j < 4; j++) {
+                vertexBoneData[i].indices[j] = bone(rng);
+                vertexBoneData[i].weights[j] = 0.5f + 0.5f * coordinate(rng);
+            }
+        }
+        
+        // No job system, so these cases compare the kernels themselves
+        CpuSkinner skinner(positions, normals, vertexBoneData, boneCount);
+        const std::pair<const char*, CpuSkinner::Kernel> kernels[] = {
+            { "skinning/scalar", CpuSkinner::Kernel::Scalar },
+            { "skinning/simd", CpuSkinner::Kernel::SIMD }
+        };
+        for (const auto& kernel : kernels) {
+            suite.run(kernel.first + size, count, [&](size_t iterations) {
+                for (size_t i = 0; i < iterations; i++) {
+                    skinner.skin(boneMatrices, glm::mat4(1.0f), kernel.second);
+                    benchmarkKeep(&skinner.getBounds());
+                }
+            });
+        }
+        
+        // The same kernel split across a persistent worker pool
+        if (!suite.isSelected("skinning/simd_parallel" + size)) continue;
+        JobSystem jobSystem;
+        CpuSkinner parallelSkinner(positions, normals, vertexBoneData, boneCount, &jobSystem);
+        suite.run("skinning/simd_parallel" + size, count, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                parallelSkinner.skin(boneMatrices, glm::mat4(1.0f), CpuSkinner::Kernel::SIMD);
+                benchmarkKeep(&parallelSkinner.getBounds());
+            }
+        });
+    }
+}
+
+static void benchMeshParsing(BenchmarkSuite& suite, const std::string& assets) {
+    for (const char* mesh : MESHES) {
+        const std::string name = "mesh/parse/" + std::string(mesh);
+        if (!suite.isSelected(name)) continue;
+        
+        const std::string path = assets + "/" + mesh + ".mesh";
+        size_t vertexCount = 0, faceCount = 0;
+        std::vector<float> positionData, normalData, uvData;
+        std::vector<Bone> bones;
+        std::vector<VertexBoneData> vertexBoneData;
+        bool hasBones = false;
+        if (!loadMeshWithArmature(path, vertexCount, faceCount, positionData, normalData, uvData, bones, vertexBoneData, hasBones)) {
+            std::cerr << "Failed to parse " << path << std::endl;
+            continue;
+        }
+        
+        suite.run(name, vertexCount, [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                loadMeshWithArmature(path, vertexCount, faceCount, positionData, normalData, uvData, bones,
+                                     vertexBoneData, hasBones);
+                benchmarkKeep(positionData.data());
+            }
+        });
+    }
+}
+
+static void benchQuaternions(BenchmarkSuite& suite) {
+    const size_t count = 4096;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> fraction(0.0f, 1.0f);
+    auto randomRotation = [&]() {
+        glm::vec3 axis(unit(rng), unit(rng), unit(rng));
+        if (glm::dot(axis, axis) < 1.0e-4f) axis = glm::vec3(0.0f, 1.0f, 0.0f);
+        return Quaternion(angle(rng), glm::normalize(axis));
+    };
+    
+    std::vector<Quaternion> a(count), b(count), product(count);
+    std::vector<glm::vec3> vectors(count), rotated(count);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = randomRotation();
+        b[i] = randomRotation();
+        vectors[i] = glm::vec3(unit(rng), unit(rng), unit(rng));
+    }
+    
+    const std::string size = "/" + std::to_string(count);
+    suite.run("quaternion/multiply" + size, count, [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; i++) {
+            for (size_t j = 0; j < count; j++) {
+                product[j] = a[j] * b[j];
+            }
+            benchmarkKeep(product.data());
+        }
+    });
+    suite.run("quaternion/rotate" + size, count, [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; i++) {
+            for (size_t j = 0; j < count; j++) {
+                rotated[j] = a[j].rotate(vectors[j]);
+            }
+            benchmarkKeep(rotated.data());
+        }
+    });
+    
+    // Batched interpolation as the animation system runs it, scalar and at full SIMD width
+    std::vector<float> aw(count), ax(count), ay(count), az(count);
+    std::vector<float> bw(count), bx(count), by(count), bz(count);
+    std::vector<float> t(count), ow(count), ox(count), oy(count), oz(count);
+    for (size_t i = 0; i < count; i++) {
+        aw[i] = a[i].getW(); ax[i] = a[i].getX(); ay[i] = a[i].getY(); az[i] = a[i].getZ();
+        bw[i] = b[i].getW(); bx[i] = b[i].getX(); by[i] = b[i].getY(); bz[i] = b[i].getZ();
+        t[i] = fraction(rng);
+    }
+    const QuaternionMath::ConstStream from = { aw.data(), ax.data(), ay.data(), az.data() };
+    const QuaternionMath::ConstStream to = { bw.data(), bx.data(), by.data(), bz.data() };
+    const QuaternionMath::Stream out = { ow.data(), ox.data(), oy.data(), oz.data() };
+    
+    const QuaternionMath::InterpolationMode modes[] = {
+        QuaternionMath::InterpolationMode::Slerp,
+        QuaternionMath::InterpolationMode::Nlerp,
+        QuaternionMath::InterpolationMode::ApproxSlerp
+    };
+    for (QuaternionMath::InterpolationMode mode : modes) {
+        for (unsigned lanes : { 1u, 8u }) {
+            if (mode == QuaternionMath::InterpolationMode::Slerp && lanes > 1) continue;   // Always scalar
+            const std::string name = std::string("quaternion/") + QuaternionMath::modeName(mode) +
+                                     (lanes == 1 ? "/scalar" : "/simd") + size;
+            suite.run(name, count, [&, mode, lanes](size_t iterations) {
+                for (size_t i = 0; i < iterations; i++) {
+                    QuaternionMath::interpolateBatch(mode, count, from, to, t.data(), out, lanes);
+                    benchmarkKeep(ow.data());
+                }
+            });
+        }
+    }
+}
+
+static void benchAudio(BenchmarkSuite& suite) {
+    // One callback's worth of the mixer with looping voices over a second of noise,
+    // panning one voice per callback to keep the gain ramps busy
+    const size_t frames = 1024;
+    const int sampleRate = 44100;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.4f, 0.4f);
+    std::uniform_real_distribution<float> pan(-1.0f, 1.0f);
+    std::vector<float> source(sampleRate);
+    for (float& sample : source) {
+        sample = noise(rng);
+    }
+    std::vector<int16_t> output(frames * AudioMixer::CHANNELS);
+    
+    // Pitched cases play every voice slightly off rate, as moving emitters do under Doppler
+    const size_t voiceCounts[] = { 8, 32, 128 };
+    for (size_t voiceCount : voiceCounts) {
+        for (bool pitched : { false, true }) {
+            const std::string name = (pitched ? "audio/mix_pitched/" : "audio/mix/") + std::to_string(voiceCount);
+            if (!suite.isSelected(name)) continue;
+            
+            AudioMixer mixer(voiceCount, frames, sampleRate);
+            for (size_t i = 0; i < voiceCount; i++) {
+                VoiceDesc desc;
+                desc.pitch = pitched ? 0.97f + 0.06f * static_cast<float>(i % 16) / 15.0f : 1.0f;
+                desc.samples = source.data() + (i * 997) % (source.size() / 2);
+                desc.frameCount = static_cast<uint32_t>(source.size() / 2);
+                desc.gain = 0.5f;
+                desc.pan = pan(rng);
+                desc.bus = i % 4 == 0 ? AudioBusID::Music : AudioBusID::SFX;
+                desc.looping = true;
+                mixer.play(static_cast<SoundHandle>(i + 1), desc);
+            }
+            
+            size_t callback = 0;
+            suite.run(name, frames, [&](size_t iterations) {
+                for (size_t i = 0; i < iterations; i++) {
+                    mixer.setPan(static_cast<SoundHandle>(1 + callback++ % voiceCount), pan(rng));
+                    mixer.mix(output.data(), frames);
+                    benchmarkKeep(output.data());
+                }
+            });
+        }
+    }
+}
+
+// A bloom/tonemap frame declared out of order, with a disabled debug view and a pass
+// nobody reads; every transient resource follows the screen size
+static void buildFrameGraph(RenderGraph& graph) {
+    const TextureProperties colour;
+    graph.createResource("GBuffer", RenderTargetDesc({ colour, colour }, true, true));
+    graph.createResource("HDR", RenderTargetDesc({ colour }, false));
+    graph.createResource("BloomA", RenderTargetDesc({ colour }, false, false, 0.5f));
+    graph.createResource("BloomB", RenderTargetDesc({ colour }, false, false, 0.5f));
+    graph.createResource("BloomC", RenderTargetDesc({ colour }, false, false, 0.5f));
+    graph.createResource("Scratch", RenderTargetDesc({ colour }, false));
+    graph.importResource("Backbuffer");
+    
+    const RenderGraph::ExecuteFunction nothing = [](RenderGraph&) {};
+    graph.addPass("Tonemap", nothing).read("HDR").read("BloomC").write("Backbuffer");
+    graph.addPass("Geometry", nothing).write("GBuffer");
+    graph.addPass("BloomBlur2", nothing).read("BloomB").write("BloomC");
+    graph.addPass("Lighting", nothing).read("GBuffer").write("HDR");
+    graph.addPass("GBufferDebug", nothing).read("GBuffer").write("Backbuffer");
+    graph.addPass("BloomDown", nothing).read("HDR").write("BloomA");
+    graph.addPass("BloomBlur", nothing).read("BloomA").write("BloomB");
+    graph.addPass("Unused", nothing).write("Scratch");
+    graph.setPassEnabled("GBufferDebug", false);
+}
+
+// Render graph scheduling needs no GL context, so its compiled schedule is checked here:
+// pass order, culling and which transient targets alias. Returns false on any mismatch
+static bool checkRenderGraph(std::ostream& report) {
+    RenderGraph graph;
+    buildFrameGraph(graph);
+    if (!graph.compile()) {
+        std::cerr << "Render graph check: compile() failed" << std::endl;
+        return false;
+    }
+    
+    bool passed = true;
+    auto expect = [&passed](bool condition, const std::string& what) {
+        if (!condition) {
+            std::cerr << "Render graph check failed: " << what << std::endl;
+            passed = false;
+        }
+    };
+    
+    const std::vector<std::string> order = { "Geometry", "Lighting", "BloomDown", "BloomBlur", "BloomBlur2", "Tonemap" };
+    expect(graph.getExecutionOrder() == order, "execution order");
+    expect(!graph.isPassActive("GBufferDebug"), "disabled GBufferDebug is culled");
+    expect(!graph.isPassActive("Unused"), "Unused (output never read) is culled");
+    
+    // BloomC starts after BloomA's last read, so the two share a target; HDR lives
+    // across the whole bloom chain and GBuffer's layout differs from everything else
+    const std::pair<const char*, int> slots[] = {
+        { "GBuffer", 0 }, { "HDR", 1 }, { "BloomA", 2 }, { "BloomB", 3 }, { "BloomC", 2 },
+        { "Scratch", -1 }, { "Backbuffer", -1 }
+    };
+    for (const auto& slot : slots) {
+        expect(graph.getPhysicalSlot(slot.first) == slot.second, std::string("physical slot of ") + slot.first);
+    }
+    expect(graph.getPhysicalTargetCount() == 4, "physical target count");
+    
+    // Re-enabling the debug view brings it back after Tonemap, its fellow Backbuffer writer
+    graph.setPassEnabled("GBufferDebug", true);
+    expect(graph.compile() && graph.isPassActive("GBufferDebug") &&
+           graph.getExecutionOrder().back() == "GBufferDebug", "re-enabled GBufferDebug runs after Tonemap");
+    
+    if (!passed) {
+        graph.dumpSchedule(std::cerr);
+        return false;
+    }
+    report << "Render graph check passed" << std::endl;
+    return true;
+}
+
+static void benchRenderGraph(BenchmarkSuite& suite) {
+    if (!suite.isSelected("rendergraph/compile")) return;
+    
+    RenderGraph graph;
+    buildFrameGraph(graph);
+    suite.run("rendergraph/compile", 1, [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; i++) {
+            benchmarkKeep(graph.compile());
+        }
+    });
+}
+
+int main(int argc, char** argv) {
+    BenchmarkSuite::Settings settings;
+    std::string jsonPath;
+    std::string assets = ENGINE_ASSET_DIR;
+    bool checkOnly = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--filter" && hasValue) {
+            settings.filter = argv[++i];
+        } else if (argument == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (argument == "--min-time" && hasValue) {
+            settings.minSeconds = std::atof(argv[++i]);
+        } else if (argument == "--repetitions" && hasValue) {
+            settings.repetitions = std::atoi(argv[++i]);
+        } else if (argument == "--assets" && hasValue) {
+            assets = argv[++i];
+        } else if (argument == "--check") {
+            checkOnly = true;
+        } else {
+            std::cerr << "Usage: engine_bench [--filter text] [--json results.json] [--min-time seconds]"
+                      << " [--repetitions n] [--assets dir] [--check]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    
+    // Timings should measure the engine, not the profiler. No GL context either:
+    // shapes keep CPU-side data only, since ShapeGpu is never installed
+    Profiler::setEnabled(false);
+    
+    // Engine code logs as it loads and builds; the report goes to its own stream
+    std::ostream report(std::cout.rdbuf());
+    std::streambuf* engineLog = std::cout.rdbuf(nullptr);
+    
+    BenchmarkSuite suite(settings, report);
+    suite.addContext("build_type", ENGINE_BUILD_TYPE);
+    suite.addContext("audio_simd", AudioKernels::simdPathName());
+    suite.addContext("quaternion_simd", QuaternionMath::simdPathName());
+    suite.addContext("skinning_simd", CpuSkinner::simdPathName());
+    report << "engine_bench (" << ENGINE_BUILD_TYPE << " build), assets from " << assets << std::endl;
+#ifndef NDEBUG
+    report << "Warning: assertions are enabled; timings are not representative" << std::endl;
+#endif
+    
+    const bool checksPassed = checkRenderGraph(report);
+    if (!checksPassed || checkOnly) {
+        std::cout.rdbuf(engineLog);
+        return checksPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    benchSpatial(suite, assets);
+    benchNarrowPhase(suite, assets);
+    benchAnimation(suite, assets);
+    benchSkinning(suite);
+    benchMeshParsing(suite, assets);
+    benchQuaternions(suite);
+    benchAudio(suite);
+    benchRenderGraph(suite);
+    std::cout.rdbuf(engineLog);
+    
+    if (suite.getResults().empty()) {
+        std::cerr << "No benchmark matched the filter" << std::endl;
+        return EXIT_FAILURE;
+    }
+    report << std::endl;
+    suite.print(report);
+    if (!jsonPath.empty()) {
+        if (!suite.writeJson(jsonPath)) {
+            return EXIT_FAILURE;
+        }
+        report << "Wrote " << jsonPath << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
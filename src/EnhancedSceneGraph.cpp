@@ -3,6 +3,7 @@
 #include "MPR.hpp"
 #include "GameObject.hpp"
 #include "AABB.hpp"
+#include "Profiler.hpp"
 #include <algorithm>
 
 // EnhancedSceneGraph implementation
@@ -116,6 +117,7 @@ void EnhancedSceneGraph::detectCollisions(GameObject* obj, std::vector<GameObjec
 }
 
 void EnhancedSceneGraph::processCollisionResponses() {
+    PROFILE_ZONE("EnhancedSceneGraph::processCollisionResponses");
     std::vector<std::pair<GameObject*, GameObject*>> collisions;
     detectCollisions(collisions);
     
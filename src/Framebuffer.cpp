@@ -1,7 +1,40 @@
 #include "Framebuffer.hpp"
 
-Framebuffer::Framebuffer(int width, int height, const std::vector<TextureProperties>& textureProps, bool createDepthStencil) 
-    : resX(width), resY(height), hasDepthStencil(createDepthStencil), rbo(0) {
+TextureProperties TextureProperties::rgb32f() {
+    return TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST);
+}
+
+TextureProperties TextureProperties::albedoRGBA8() {
+    return TextureProperties(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST, GL_NEAREST);
+}
+
+TextureProperties TextureProperties::octNormalRG16() {
+    // Unsigned normalized: the shader remaps the octahedral [-1,1] square to [0,1]
+    return TextureProperties(GL_RG16, GL_RG, GL_UNSIGNED_SHORT, GL_NEAREST, GL_NEAREST);
+}
+
+std::vector<TextureProperties> TextureProperties::gBufferPreset(GBufferLayout layout) {
+    if (layout == GBufferLayout::Compact) {
+        return {
+            albedoRGBA8(),     // Albedo
+            octNormalRG16()    // Normal (position comes from the depth texture)
+        };
+    }
+    
+    return {
+        rgb32f(),  // Diffuse
+        rgb32f(),  // Normal
+        rgb32f()   // Position
+    };
+}
+
+bool TextureProperties::gBufferNeedsDepthTexture(GBufferLayout layout) {
+    return layout == GBufferLayout::Compact;
+}
+
+Framebuffer::Framebuffer(int width, int height, const std::vector<TextureProperties>& textureProps, bool createDepthStencil,
+                         bool sampleableDepth) 
+    : resX(width), resY(height), hasDepthStencil(createDepthStencil), rbo(0), depthTex(0) {
     
     // Check for maximum number of color attachments
     const size_t MAX_COLOR_ATTACHMENTS = 8;
@@ -51,8 +84,19 @@ Framebuffer::Framebuffer(int width, int height, const std::vector<TexturePropert
         glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
     }
     
-    // Create renderbuffer for depth and stencil if requested
-    if (createDepthStencil) {
+    // Create depth/stencil texture if it has to be read back in a later pass
+    if (createDepthStencil && sampleableDepth) {
+        glGenTextures(1, &depthTex);
+        glBindTexture(GL_TEXTURE_2D, depthTex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, resX, resY, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTex, 0);
+    }
+    // Otherwise create renderbuffer for depth and stencil if requested
+    else if (createDepthStencil) {
         glGenRenderbuffers(1, &rbo);
         glBindRenderbuffer(GL_RENDERBUFFER, rbo);
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, resX, resY);
@@ -74,7 +118,10 @@ Framebuffer::~Framebuffer() {
         glDeleteTextures(static_cast<GLsizei>(tex.size()), tex.data());
     }
     
-    // Delete renderbuffer if it exists
+    // Delete depth texture or renderbuffer if it exists
+    if (depthTex) {
+        glDeleteTextures(1, &depthTex);
+    }
     if (rbo) {
         glDeleteRenderbuffers(1, &rbo);
     }
@@ -84,6 +131,7 @@ Framebuffer::~Framebuffer() {
     
     // Clear data
     tex.clear();
+    depthTex = 0;
     rbo = 0;
     fbo = 0;
 }
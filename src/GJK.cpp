@@ -1,5 +1,6 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "GJK.hpp"
+#include "Profiler.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
 #include <limits>
@@ -307,6 +308,7 @@ namespace Collision {
 // Enhanced GJK that returns distance when not colliding
 GJKResult GJK(Shape& shapeA, Quaternion& rotationA, const glm::vec3& positionA,
     Shape& shapeB, Quaternion& rotationB, const glm::vec3& positionB) {
+PROFILE_ZONE("GJK");
 GJKResult result;
 
 // Initialize simplex
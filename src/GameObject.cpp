@@ -1,6 +1,7 @@
 #include "GameObject.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <unordered_map>
+#include <algorithm>
 #include "TypeRegistry.hpp"
 
 // Implementation of getGameObjectTypeId
@@ -23,8 +24,12 @@ GameObject::GameObject(glm::vec3 pos, Quaternion rot, const Shape& shape, int id
       boundsDirty(true)               // Start with dirty bounds to force initial calculation
 {
     // Initialize model matrix using our helper method
+    hasArmature = false;
     updateModelMatrix();
-                  
+    
+    // Pose the shape's skeleton, if any, at bind pose
+    initBoneData();
+    
     // Initialize bounding box (will be updated when first accessed)
     boundingBox = AABB(position - glm::vec3(0.5f), position + glm::vec3(0.5f));
 }
@@ -38,9 +43,9 @@ void GameObject::updateModelMatrix() {
   // Combine the transformations: translate * rotate * scale
   modelMatrix = translationMatrix * rotationMatrix * scaleMatrix;
   
-  // Update bone transforms if we have an armature
+  // Moving the object leaves the pose alone; only the world matrices change
   if (hasArmature) {
-      updateBoneTransforms();
+      updateBoneWorldMatrices();
   }
   
   // Mark bounds as dirty
@@ -66,8 +71,14 @@ const AABB& GameObject::getBoundingBox() {
 }
 
 void GameObject::updateBoundingBox() {
+    // Skinned meshes: union of the posed bone boxes, O(bones) and valid under animation
+    AABB skinnedBounds;
+    if (hasArmature && skeleton->computeSkinnedBounds(boneMatrices, modelMatrix, skinnedBounds)) {
+        const float margin = 0.05f;
+        boundingBox = AABB(skinnedBounds.min - glm::vec3(margin), skinnedBounds.max + glm::vec3(margin));
+    }
     // If the shape has vertex data
-    if (renderElementShape.hasVertexData()) {
+    else if (renderElementShape.hasVertexData()) {
         const auto& positions = renderElementShape.getPositions();
         
         // Start with first vertex transformed to world space
@@ -104,44 +115,33 @@ void GameObject::updateBoundingBox() {
     boundsDirty = false;
 }
 
+void GameObject::setSkinnedBounds(const AABB& skinnedBounds) {
+    // Same culling margin as updateBoundingBox
+    const float margin = 0.05f;
+    boundingBox = AABB(skinnedBounds.min - glm::vec3(margin), skinnedBounds.max + glm::vec3(margin));
+    boundsDirty = false;
+}
+
 void GameObject::initBoneData() {
+  setSkeleton(renderElementShape.hasArmature() ? renderElementShape.getSkeleton() : nullptr);
+}
+
+void GameObject::setSkeleton(std::shared_ptr<const Skeleton> newSkeleton) {
   // Reset bone data
-  boneTransforms.clear();
+  skeleton = std::move(newSkeleton);
+  boneRotations.clear();
+  boneModelSpace.clear();
+  boneSkinning.clear();
   boneMatrices.clear();
   hasArmature = false;
   
-  // Check if shape has bone data using the public accessor
-  if (!renderElementShape.hasArmature()) {
+  if (!skeleton || skeleton->getBoneCount() == 0) {
       return;
   }
   
-  // Use the public accessor to get the bones
-  const auto& bones = renderElementShape.getBones();
-  if (bones.empty()) {
-      return;
-  }
-  
-  // We have bone data
+  // We have bone data; every bone starts at the bind pose (identity rotation)
   hasArmature = true;
-  
-  // Resize containers
-  boneTransforms.resize(bones.size());
-  boneMatrices.resize(bones.size(), glm::mat4(1.0f));
-  
-  // Initialize bone transforms
-  for (size_t i = 0; i < bones.size(); i++) {
-      const Bone& bone = bones[i];
-      
-      BoneTransform& transform = boneTransforms[i];
-      transform.initialRotation = Quaternion(1.0f, 0.0f, 0.0f, 0.0f); // Identity quaternion
-      transform.currentRotation = Quaternion(1.0f, 0.0f, 0.0f, 0.0f); // Identity quaternion
-      transform.localPosition = bone.localPosition;
-      transform.parentIndex = bone.parentIndex;
-      
-      // Create offset matrix (translation to bone position)
-      transform.offsetMatrix = glm::translate(glm::mat4(1.0f), bone.localPosition);
-      transform.finalTransform = transform.offsetMatrix; // Initialize with offset
-  }
+  boneRotations.assign(skeleton->getBoneCount(), Quaternion());
   
   // Initial update of bone transforms
   updateBoneTransforms();
@@ -154,8 +154,8 @@ void GameObject::updateBoneRotations(const std::map<int, Quaternion>& rotations)
   for (const auto& pair : rotations) {
       int boneId = pair.first;
       
-      if (boneId >= 0 && boneId < static_cast<int>(boneTransforms.size())) {
-          boneTransforms[boneId].currentRotation = pair.second;
+      if (boneId >= 0 && boneId < static_cast<int>(boneRotations.size())) {
+          boneRotations[boneId] = pair.second;
       }
   }
   
@@ -166,29 +166,36 @@ void GameObject::updateBoneRotations(const std::map<int, Quaternion>& rotations)
   boundsDirty = true;
 }
 
-void GameObject::updateBoneTransforms() {
+void GameObject::updateBoneRotations(const std::vector<Quaternion>& rotations, const std::vector<uint8_t>& animated) {
   if (!hasArmature) return;
   
-  // Recursively compute bone transforms in hierarchy order
-  for (size_t i = 0; i < boneTransforms.size(); i++) {
-      BoneTransform& transform = boneTransforms[i];
-      
-      // Create local transform from position and rotation
-      glm::mat4 localRotation = transform.currentRotation.toMatrix();
-      glm::mat4 localTransform = transform.offsetMatrix * localRotation;
-      
-      // Apply parent transform if this bone has a parent
-      if (transform.parentIndex >= 0 && 
-          transform.parentIndex < static_cast<int>(boneTransforms.size())) {
-          // Combine with parent transform
-          transform.finalTransform = 
-              boneTransforms[transform.parentIndex].finalTransform * localTransform;
-      } else {
-          // Root bone - combine with object's transform
-          transform.finalTransform = modelMatrix * localTransform;
+  // Apply rotations for every bone the pose animates
+  size_t count = std::min(boneRotations.size(), std::min(rotations.size(), animated.size()));
+  for (size_t i = 0; i < count; i++) {
+      if (animated[i]) {
+          boneRotations[i] = rotations[i];
       }
-      
-      // Store the final transform matrix for this bone
-      boneMatrices[i] = transform.finalTransform;
   }
-}
\ No newline at end of file
+  
+  // Update the transforms
+  updateBoneTransforms();
+  
+  // Mark bounding box as dirty since bones changed
+  boundsDirty = true;
+}
+
+void GameObject::updateBoneTransforms() {
+  if (!hasArmature) return;
+  
+  // Local rotations -> model space, in the skeleton's parent-before-child order
+  skeleton->computeModelSpace(boneRotations, boneModelSpace, boneSkinning);
+  
+  updateBoneWorldMatrices();
+}
+
+void GameObject::updateBoneWorldMatrices() {
+  if (!hasArmature) return;
+  
+  // Model space -> world space; the only bone work needed when the object moves
+  skeleton->computeWorldMatrices(boneSkinning, modelMatrix, boneMatrices);
+}
@@ -0,0 +1,90 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned threadCount)
+    : job(nullptr), jobCount(0), jobGrain(1), nextIndex(0), busyWorkers(0), generation(0), stopping(false) {
+    if (threadCount == 0) {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::runChunks() {
+    // Grab chunks until the range is exhausted
+    while (true) {
+        size_t begin = nextIndex.fetch_add(jobGrain);
+        if (begin >= jobCount) {
+            break;
+        }
+        (*job)(begin, std::min(jobCount, begin + jobGrain));
+    }
+}
+
+void JobSystem::workerLoop() {
+    uint64_t seenGeneration = 0;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+        
+        runChunks();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunction& func) {
+    grain = std::max<size_t>(1, grain);
+    
+    // Small ranges (or no workers) run inline
+    if (workers.empty() || count <= grain) {
+        if (count > 0) {
+            func(0, count);
+        }
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &func;
+        jobCount = count;
+        jobGrain = grain;
+        nextIndex.store(0);
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+    
+    // The caller works too, then waits for stragglers
+    runChunks();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
@@ -1,6 +1,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "MPR.hpp"
 #include "GJK.hpp"  // For minkowskiSupport and support functions
+#include "Profiler.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
 
@@ -56,6 +57,8 @@ namespace Collision {
     // MPR collision detection algorithm
     bool MPR(const Shape& shapeA, const Quaternion& rotationA, const glm::vec3& positionA,
             const Shape& shapeB, const Quaternion& rotationB, const glm::vec3& positionB) {
+        PROFILE_ZONE("MPR");
+        
         // Get an interior point of the Minkowski Difference
         glm::vec3 interior = findInteriorPoint(shapeA, rotationA, positionA, shapeB, rotationB, positionB);
         
@@ -4,15 +4,29 @@
 #include "Renderer.hpp"
 #include "GameObject.hpp"
 #include "SoundSystem.hpp"
+#include "SoundBank.hpp"
+#include "AudioScene.hpp"
+#include "AudioMixer.hpp"
+#include "AudioKernels.hpp"
 #include "SceneGraph.hpp"
 #include "Camera.hpp"
 #include "PhysicsIntegrator.hpp"
 #include "GJK.hpp"
 #include "EnhancedSceneGraph.hpp"
 #include "Framebuffer.hpp"
+#include "RenderTargetPool.hpp"
+#include "RenderGraph.hpp"
+#include "BonePalette.hpp"
+#include "CpuSkinner.hpp"
+#include "ShapeGpu.hpp"
+#include "CompressedAnimation.hpp"
+#include "QuaternionMath.hpp"
 #include "QuadRenderer.hpp"
+#include "Profiler.hpp"
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdlib>
 #include <thread>
 #include <chrono>
 #include <cmath> // For sin and cos functions
@@ -100,12 +114,114 @@ class LightObject : public GameObject {
         
         // Get light color
         const glm::vec3& getLightColor() const { return lightColor; }
-        
+    
     private:
         glm::vec3 lightColor;
 };
 
+// Headless CPU skinning benchmark on an armature mesh (no window or GL context needed)
+int runSkinningBenchmark(const std::string& meshPath, int iterations) {
+    size_t vertexCount, faceCount;
+    std::vector<float> positionData, normalData, uvData;
+    std::vector<Bone> bones;
+    std::vector<VertexBoneData> vertexBoneData;
+    bool hasBones;
+    
+    if (!loadMeshWithArmature(meshPath, vertexCount, faceCount, positionData, normalData, uvData, bones, vertexBoneData, hasBones) || !hasBones) {
+        std::cerr << "Failed to load armature mesh for skinning benchmark!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    std::vector<glm::vec3> positions(vertexCount);
+    std::vector<glm::vec3> normals(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        positions[i] = glm::vec3(positionData[i * 3], positionData[i * 3 + 1], positionData[i * 3 + 2]);
+        normals[i] = glm::vec3(normalData[i * 3], normalData[i * 3 + 1], normalData[i * 3 + 2]);
+    }
+    
+    // Non-trivial pose: every bone rotated a little around its head
+    std::vector<glm::mat4> boneMatrices(bones.size());
+    for (size_t i = 0; i < bones.size(); i++) {
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), bones[i].localPosition)
+                        * glm::rotate(glm::mat4(1.0f), 0.05f * static_cast<float>(i + 1), glm::vec3(0.0f, 0.0f, 1.0f))
+                        * glm::translate(glm::mat4(1.0f), -bones[i].localPosition);
+        boneMatrices[i] = bones[i].parentIndex >= 0 ? boneMatrices[bones[i].parentIndex] * local : local;
+    }
+    
+    CpuSkinner::runBenchmark(positions, normals, vertexBoneData, boneMatrices, iterations, std::cout);
+    return EXIT_SUCCESS;
+}
+
+// Convert a text .anim clip into a compressed .canim clip and report the error introduced
+int convertAnimation(const std::string& inputPath, const std::string& outputPath, float maxErrorDegrees) {
+    Animation source = Animation::loadFromFile(inputPath);
+    if (source.duration <= 0.0f) {
+        std::cerr << "Failed to load animation: " << inputPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    AnimationCompressionSettings settings;
+    settings.maxErrorDegrees = maxErrorDegrees;
+    AnimationCompressionStats stats;
+    CompressedAnimation compressed = CompressedAnimation::compress(source, settings, &stats);
+    
+    if (!compressed.saveToFile(outputPath)) {
+        return EXIT_FAILURE;
+    }
+    
+    std::cout << "Wrote " << outputPath << std::endl;
+    stats.print(std::cout);
+    return EXIT_SUCCESS;
+}
+
+// Convert every WAV file in a directory into one sound bank at the output rate
+int buildSoundBank(const std::string& directory, const std::string& outputPath) {
+    SoundBankBuildStats stats;
+    if (!SoundBank::build(directory, outputPath, SoundSystem::OUTPUT_RATE, &stats)) {
+        return EXIT_FAILURE;
+    }
+    
+    std::cout << "Wrote " << outputPath << std::endl;
+    stats.print(std::cout);
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv) {
+    // Usage: Main --convert-anim <input.anim> <output.canim> [maxErrorDegrees]
+    if (argc > 3 && std::string(argv[1]) == "--convert-anim") {
+        return convertAnimation(argv[2], argv[3], argc > 4 ? static_cast<float>(std::atof(argv[4])) : 0.5f);
+    }
+    
+    // Usage: Main --build-soundbank <audioDirectory> <output.sbank>
+    if (argc > 3 && std::string(argv[1]) == "--build-soundbank") {
+        return buildSoundBank(argv[2], argv[3]);
+    }
+    
+    // Usage: Main --bench-skinning [iterations]
+    if (argc > 1 && std::string(argv[1]) == "--bench-skinning") {
+        return runSkinningBenchmark("../armature.mesh", argc > 2 ? std::atoi(argv[2]) : 200);
+    }
+    
+    // Usage: Main --bench-quaternions [iterations]
+    if (argc > 1 && std::string(argv[1]) == "--bench-quaternions") {
+        QuaternionMath::runBenchmark(4096, argc > 2 ? std::atoi(argv[2]) : 2000, std::cout);
+        return EXIT_SUCCESS;
+    }
+    
+    // Usage: Main --render-audio <output.wav> [seconds]
+    if (argc > 2 && std::string(argv[1]) == "--render-audio") {
+        const double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+        return AudioScene::render("..", argv[2], seconds, std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    
+    // Usage: Main --bench-audio [callbacks]
+    if (argc > 1 && std::string(argv[1]) == "--bench-audio") {
+        int callbacks = argc > 2 ? std::atoi(argv[2]) : 2000;
+        AudioKernels::runBenchmark(SoundSystem::OUTPUT_FRAMES, callbacks, std::cout);
+        AudioMixer::runBenchmark(callbacks, std::cout);
+        return EXIT_SUCCESS;
+    }
+    
     // Engine initialization
     Engine::initialize();
     
@@ -115,30 +231,39 @@ int main(int argc, char** argv) {
     
     SDL_Manager& sdl = SDL_Manager::sdl();
     sdl.spawnWindow("Deferred Rendering with N-Lights", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_TRUE);
-
+    
     if (!initOpenGL()) return EXIT_FAILURE;
     
     // Initialize sound system
     SoundSystem soundSystem;
-
+    
     // Set background color to dark gray
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     
-    // Create the G-Buffer
-    std::vector<TextureProperties> textureProps;
-    textureProps.push_back(TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST));  // Diffuse
-    textureProps.push_back(TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST));  // Normal
-    textureProps.push_back(TextureProperties(GL_RGB32F, GL_RGB, GL_FLOAT, GL_NEAREST, GL_NEAREST));  // Position
-    Framebuffer gBuffer(WINDOW_WIDTH, WINDOW_HEIGHT, textureProps, true);
+    // G-Buffer layout: Compact packs albedo + octahedral normals and rebuilds position from depth
+    const GBufferLayout gBufferLayout = GBufferLayout::Compact;
+    const bool compactGBuffer = (gBufferLayout == GBufferLayout::Compact);
+    
+    // Render targets come from a pool that follows the window size
+    RenderTargetPool renderTargets(WINDOW_WIDTH, WINDOW_HEIGHT);
+    
+    // Describe the G-Buffer (screen-sized, acquired from the pool every frame)
+    RenderTargetDesc gBufferDesc(TextureProperties::gBufferPreset(gBufferLayout), true,
+                                 TextureProperties::gBufferNeedsDepthTexture(gBufferLayout));
+    
+    // Bone matrices of every skinned object, uploaded once per frame
+    BonePalette bonePalette;
+    int armatureBoneOffset = 0;
     
     // Create geometry pass shader
-    Shader geometryShader("../deferred.vert", "../deferred.frag");
+    Shader geometryShader("../deferred.vert", compactGBuffer ? "../deferred_compact.frag" : "../deferred.frag");
     
     // Create lighting shader for deferred rendering
-    Shader lightingShader("../deferred_display.vert", "../lighting.frag");
+    Shader lightingShader("../deferred_display.vert", compactGBuffer ? "../lighting_compact.frag" : "../lighting.frag");
     
     // Create shader for displaying individual G-Buffer textures
-    Shader displayShader("../deferred_display.vert", "../deferred_display.frag");
+    Shader displayShader("../deferred_display.vert",
+                         compactGBuffer ? "../deferred_display_compact.frag" : "../deferred_display.frag");
     
     // Create quad renderer for screen rendering
     QuadRenderer quadRenderer;
@@ -160,7 +285,7 @@ int main(int argc, char** argv) {
     
     // Create a smaller cube shape for lights
     Shape lightShape = createCubeShape();
-
+    
     // Load the armature mesh
     size_t vertexCount;
     size_t faceCount;
@@ -170,14 +295,19 @@ int main(int argc, char** argv) {
     std::vector<Bone> bones;
     std::vector<VertexBoneData> vertexBoneData;
     bool hasBones;
-
+    
     if (!loadMeshWithArmature("../suzanne.mesh", vertexCount, faceCount, positionData, normalData, uvData, bones, vertexBoneData, hasBones)) {
         std::cerr << "Failed to load armature mesh!" << std::endl;
         return EXIT_FAILURE;
     }
-
+    
     Shape armatureShape(faceCount, positionData, normalData, uvData, bones, vertexBoneData, hasBones);
     
+    // CPU skinning fallback: skins into the armature VBO and drives its bounds
+    const bool cpuSkinning = false;
+    JobSystem skinningJobs;
+    CpuSkinner armatureSkinner(armatureShape, &skinningJobs);
+    
     // Create game objects
     TestCube* cube = new TestCube(glm::vec3(3.0f, 0.0f, 0.1f), cubeShape);
     Armature* armature = new Armature(glm::vec3(0.0f, 0.0f, 0.0f), armatureShape);
@@ -243,7 +373,7 @@ int main(int argc, char** argv) {
             std::cout << "Cube position: (" << cubeObj->getPosition().x << ", " 
                       << cubeObj->getPosition().y << ", " 
                       << cubeObj->getPosition().z << ")" << std::endl;
-                      
+            
             // Print current velocities for debugging
             std::cout << "Cube velocity: (" << cubeObj->getVelocity().x << ", " 
                       << cubeObj->getVelocity().y << ", " << cubeObj->getVelocity().z << ")" << std::endl;
@@ -268,15 +398,203 @@ int main(int argc, char** argv) {
     // 3 = Position buffer only
     int displayMode = 0;
     
+    // Per-frame matrices shared with the render passes
+    glm::mat4 view(1.0f);
+    glm::mat4 proj(1.0f);
+    glm::mat4 invViewProj(1.0f);
+    
+    // Declare the frame as a render graph: the G-Buffer is transient, the default framebuffer is imported
+    RenderGraph renderGraph;
+    renderGraph.createResource("GBuffer", gBufferDesc);
+    renderGraph.importResource("Backbuffer");
+    
+    // Bind and clear the default framebuffer for a screen-space pass
+    auto beginBackbufferPass = [&]() {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, renderTargets.getScreenWidth(), renderTargets.getScreenHeight());
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    };
+    
+    // FIRST PASS: Geometry pass to G-Buffer
+    renderGraph.addPass("Geometry", [&](RenderGraph& graph) {
+        // Bind the G-Buffer framebuffer
+        graph.getFramebuffer("GBuffer")->bindFBO();
+        
+        // Clear the G-Buffer
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        
+        // Use the geometry shader
+        geometryShader.use();
+        
+        // Set common uniforms
+        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "proj"), 1, GL_FALSE, glm::value_ptr(proj));
+        
+        // Render cube
+        glUniform1i(glGetUniformLocation(geometryShader.program, "hasTexture"), 0);
+        glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 0);
+        glUniform3f(glGetUniformLocation(geometryShader.program, "baseColor"), 0.9f, 0.3f, 0.3f);
+        glUniform4f(glGetUniformLocation(geometryShader.program, "objectColor"), 1.0f, 1.0f, 1.0f, 1.0f);
+        
+        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
+                          glm::value_ptr(cube->getModelMatrix()));
+        
+        glBindVertexArray(cube->getVAO());
+        glDrawArrays(GL_TRIANGLES, 0, cube->getVertexCount());
+        
+        // Render armature
+        glUniform3f(glGetUniformLocation(geometryShader.program, "baseColor"), 0.3f, 0.7f, 0.9f);
+        
+        // Set armature-specific uniforms (bone matrices if available)
+        if (cpuSkinning) {
+            // Vertices are already skinned into world space
+            glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 0);
+        } else if (armature->hasAnimatableSkeleton()) {
+            glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 1);
+            glUniform1i(glGetUniformLocation(geometryShader.program, "boneCount"), 
+                       static_cast<int>(armature->getBoneMatrices().size()));
+            
+            // Read bone matrices from this frame's palette (texture unit 1)
+            bonePalette.bind(1);
+            glUniform1i(glGetUniformLocation(geometryShader.program, "bonePalette"), 1);
+            glUniform1i(glGetUniformLocation(geometryShader.program, "useBonePalette"), 1);
+            glUniform1i(glGetUniformLocation(geometryShader.program, "boneOffset"), armatureBoneOffset);
+            glActiveTexture(GL_TEXTURE0);
+        } else {
+            glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 0);
+        }
+        
+        glm::mat4 armatureModel = cpuSkinning ? glm::mat4(1.0f) : armature->getModelMatrix();
+        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
+                          glm::value_ptr(armatureModel));
+        
+        glBindVertexArray(armature->getVAO());
+        glDrawArrays(GL_TRIANGLES, 0, armature->getVertexCount());
+        
+        // Render light objects (small cubes representing lights)
+        for (size_t i = 0; i < lightObjects.size(); i++) {
+            // Set light color as base color
+            glUniform3fv(glGetUniformLocation(geometryShader.program, "baseColor"), 1, 
+                        glm::value_ptr(lightObjects[i]->getLightColor()));
+            
+            // Set model matrix
+            glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
+                              glm::value_ptr(lightObjects[i]->getModelMatrix()));
+            
+            // Draw light cube
+            glBindVertexArray(lightObjects[i]->getVAO());
+            glDrawArrays(GL_TRIANGLES, 0, lightObjects[i]->getVertexCount());
+        }
+    }).write("GBuffer");
+    
+    // SECOND PASS: Combined result with lighting (use lighting shader)
+    renderGraph.addPass("Lighting", [&](RenderGraph& graph) {
+        Framebuffer* gBuffer = graph.getFramebuffer("GBuffer");
+        beginBackbufferPass();
+        
+        lightingShader.use();
+        
+        // Bind G-Buffer textures
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(0)); // Diffuse
+        glUniform1i(glGetUniformLocation(lightingShader.program, "diffuseTexture"), 0);
+        
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(1)); // Normal
+        glUniform1i(glGetUniformLocation(lightingShader.program, "normalTexture"), 1);
+        
+        glActiveTexture(GL_TEXTURE2);
+        if (compactGBuffer) {
+            glBindTexture(GL_TEXTURE_2D, gBuffer->getDepthTexture()); // Depth
+            glUniform1i(glGetUniformLocation(lightingShader.program, "depthTexture"), 2);
+            glUniformMatrix4fv(glGetUniformLocation(lightingShader.program, "invViewProj"), 1, GL_FALSE,
+                              glm::value_ptr(invViewProj));
+        } else {
+            glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(2)); // Position
+            glUniform1i(glGetUniformLocation(lightingShader.program, "positionTexture"), 2);
+        }
+        
+        // Set camera position for specular calculations
+        glUniform3fv(glGetUniformLocation(lightingShader.program, "viewPos"), 1, 
+                    glm::value_ptr(camera.getPosition()));
+        
+        // Set ambient light
+        glUniform3f(glGetUniformLocation(lightingShader.program, "ambientColor"), 0.1f, 0.1f, 0.1f);
+        
+        // Set attenuation factors
+        glUniform1f(glGetUniformLocation(lightingShader.program, "constantFactor"), 0.1f);
+        glUniform1f(glGetUniformLocation(lightingShader.program, "linearFactor"), 0.01f);
+        glUniform1f(glGetUniformLocation(lightingShader.program, "quadraticFactor"), 0.001f);
+        
+        // Set light count
+        glUniform1i(glGetUniformLocation(lightingShader.program, "numActiveLights"), 
+                   static_cast<int>(lightPositions.size()));
+        
+        // Set light positions and colors
+        for (size_t i = 0; i < lightPositions.size(); i++) {
+            std::string posName = "lightPositions[" + std::to_string(i) + "]";
+            std::string colorName = "lightColors[" + std::to_string(i) + "]";
+            
+            glUniform3fv(glGetUniformLocation(lightingShader.program, posName.c_str()), 1, 
+                        glm::value_ptr(lightPositions[i]));
+            glUniform3fv(glGetUniformLocation(lightingShader.program, colorName.c_str()), 1, 
+                        glm::value_ptr(lightColors[i]));
+        }
+        
+        // Render quad
+        quadRenderer.renderQuad();
+    }).read("GBuffer").write("Backbuffer");
+    
+    // Debug view of individual G-Buffer attachments (culled unless a debug display mode is active)
+    renderGraph.addPass("GBufferDebug", [&](RenderGraph& graph) {
+        Framebuffer* gBuffer = graph.getFramebuffer("GBuffer");
+        beginBackbufferPass();
+        
+        displayShader.use();
+        
+        // Bind G-Buffer textures
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(0)); // Diffuse
+        glUniform1i(glGetUniformLocation(displayShader.program, "diffuseTexture"), 0);
+        
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(1)); // Normal
+        glUniform1i(glGetUniformLocation(displayShader.program, "normalTexture"), 1);
+        
+        glActiveTexture(GL_TEXTURE2);
+        if (compactGBuffer) {
+            glBindTexture(GL_TEXTURE_2D, gBuffer->getDepthTexture()); // Depth
+            glUniform1i(glGetUniformLocation(displayShader.program, "depthTexture"), 2);
+            glUniformMatrix4fv(glGetUniformLocation(displayShader.program, "invViewProj"), 1, GL_FALSE,
+                              glm::value_ptr(invViewProj));
+        } else {
+            glBindTexture(GL_TEXTURE_2D, gBuffer->getTexture(2)); // Position
+            glUniform1i(glGetUniformLocation(displayShader.program, "positionTexture"), 2);
+        }
+        
+        // Set display mode
+        glUniform1i(glGetUniformLocation(displayShader.program, "displayMode"), displayMode);
+        
+        // Render quad
+        quadRenderer.renderQuad();
+    }).read("GBuffer").write("Backbuffer");
+    
+    if (renderGraph.compile()) {
+        renderGraph.dumpSchedule(std::cout);
+    }
+    
     bool exit = false;
     SDL_Event e;
     
     std::cout << "Deferred Rendering with N-Lights Demo." << std::endl;
     std::cout << "Press SPACE to reset cube position." << std::endl;
     std::cout << "Press V to cycle through view modes (Combined, Diffuse, Normal, Position)" << std::endl;
+    std::cout << "Press P to print the last frame's profile and write profile_trace.json" << std::endl;
     
+    PROFILE_THREAD("Main");
     while (!exit) {
         Engine::update();
+        PROFILE_FRAME();
         float dt = Engine::getDeltaSeconds();
         totalTime += dt;
         
@@ -286,6 +604,12 @@ int main(int argc, char** argv) {
             if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_CLOSE) {
                 sdl.closeWindow(e.window.windowID);
             }
+            
+            // Follow window resizes (targets are recreated lazily by the pool)
+            if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                renderTargets.resize(e.window.data1, e.window.data2);
+                camera.setAspectRatio((float)e.window.data1 / (float)e.window.data2);
+            }
             if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE) {
                 exit = true;
             }
@@ -308,6 +632,12 @@ int main(int argc, char** argv) {
                 }
             }
             
+            // Dump the profiler with 'P' key (open the trace in ui.perfetto.dev)
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_p) {
+                Profiler::printLastFrame(std::cout);
+                Profiler::exportChromeTrace("profile_trace.json");
+            }
+            
             // Toggle display mode with 'V' key
             if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_v) {
                 displayMode = (displayMode + 1) % 4;
@@ -328,12 +658,12 @@ int main(int argc, char** argv) {
         }
         
         Quaternion combinedRotation;
-
+        
         // Combine rotations
         Quaternion xRotation(90.0f, glm::vec3(1.0f, 0.0f, 0.0f));
         Quaternion yRotation(currentRotation, glm::vec3(0.0f, 1.0f, 0.0f));
         combinedRotation = yRotation * xRotation;  // Apply X rotation first, then Y rotation
-
+        
         // Apply the combined rotation directly
         armature->setRotation(combinedRotation);
         
@@ -352,7 +682,7 @@ int main(int argc, char** argv) {
             // Update position in light positions array
             lightPositions[i] = position;
         }
-
+        
         // Update physics
         Physics::updateObject(cube, dt, false);
         Physics::updateObject(armature, dt, false);
@@ -365,156 +695,44 @@ int main(int argc, char** argv) {
         sceneGraph.updateSpatialStructure(dt);
         sceneGraph.processCollisionResponses();
         
-        // Get view and projection matrices
-        glm::mat4 view = camera.getViewMatrix();
-        glm::mat4 proj = camera.getProjectionMatrix();
-        
-        // FIRST PASS: Geometry pass to G-Buffer
-        // Bind the G-Buffer framebuffer
-        gBuffer.bindFBO();
-        
-        // Clear the G-Buffer
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // Use the geometry shader
-        geometryShader.use();
-        
-        // Set common uniforms
-        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "proj"), 1, GL_FALSE, glm::value_ptr(proj));
-        
-        // Render cube
-        glUniform1i(glGetUniformLocation(geometryShader.program, "hasTexture"), 0);
-        glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 0);
-        glUniform3f(glGetUniformLocation(geometryShader.program, "baseColor"), 0.9f, 0.3f, 0.3f);
-        glUniform4f(glGetUniformLocation(geometryShader.program, "objectColor"), 1.0f, 1.0f, 1.0f, 1.0f);
-        
-        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
-                          glm::value_ptr(cube->getModelMatrix()));
-        
-        glBindVertexArray(cube->getVAO());
-        glDrawArrays(GL_TRIANGLES, 0, cube->getVertexCount());
-        
-        // Render armature
-        glUniform3f(glGetUniformLocation(geometryShader.program, "baseColor"), 0.3f, 0.7f, 0.9f);
-        
-        // Set armature-specific uniforms (bone matrices if available)
-        if (armature->hasAnimatableSkeleton()) {
-            glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 1);
-            glUniform1i(glGetUniformLocation(geometryShader.program, "boneCount"), 
-                       static_cast<int>(armature->getBoneMatrices().size()));
-            
-            // Set bone matrices
-            for (size_t i = 0; i < armature->getBoneMatrices().size(); i++) {
-                std::string uniformName = "boneMatrices[" + std::to_string(i) + "]";
-                glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, uniformName.c_str()), 
-                                 1, GL_FALSE, glm::value_ptr(armature->getBoneMatrices()[i]));
-            }
-        } else {
-            glUniform1i(glGetUniformLocation(geometryShader.program, "hasArmature"), 0);
-        }
-        
-        glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
-                          glm::value_ptr(armature->getModelMatrix()));
-        
-        glBindVertexArray(armature->getVAO());
-        glDrawArrays(GL_TRIANGLES, 0, armature->getVertexCount());
+        // Listener follows the camera; positional sounds are respatialized
+        soundSystem.update(camera, dt);
         
-        // Render light objects (small cubes representing lights)
-        for (size_t i = 0; i < lightObjects.size(); i++) {
-            // Set light color as base color
-            glUniform3fv(glGetUniformLocation(geometryShader.program, "baseColor"), 1, 
-                        glm::value_ptr(lightObjects[i]->getLightColor()));
-            
-            // Set model matrix
-            glUniformMatrix4fv(glGetUniformLocation(geometryShader.program, "model"), 1, GL_FALSE, 
-                              glm::value_ptr(lightObjects[i]->getModelMatrix()));
-            
-            // Draw light cube
-            glBindVertexArray(lightObjects[i]->getVAO());
-            glDrawArrays(GL_TRIANGLES, 0, lightObjects[i]->getVertexCount());
+        // Get view and projection matrices
+        view = camera.getViewMatrix();
+        proj = camera.getProjectionMatrix();
+        invViewProj = glm::inverse(proj * view);
+        
+        // Only one final pass is live per frame; the graph culls the other
+        renderGraph.setPassEnabled("Lighting", displayMode == 0);
+        renderGraph.setPassEnabled("GBufferDebug", displayMode != 0);
+        
+        // Skin on the CPU when shader skinning is unavailable
+        if (cpuSkinning && armature->hasAnimatableSkeleton() &&
+            armatureSkinner.skin(armature->getBoneMatrices(), armature->getModelMatrix())) {
+            ShapeGpu::uploadSkinned(armature->getVBO(), armatureSkinner);
+            armature->setSkinnedBounds(armatureSkinner.getBounds());
         }
         
-        // SECOND PASS: Display G-Buffer information
-        // Bind default framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-        
-        // Clear default framebuffer
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        if (displayMode == 0) {
-            // Combined result with lighting (use lighting shader)
-            lightingShader.use();
-            
-            // Bind G-Buffer textures
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(0)); // Diffuse
-            glUniform1i(glGetUniformLocation(lightingShader.program, "diffuseTexture"), 0);
-            
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(1)); // Normal
-            glUniform1i(glGetUniformLocation(lightingShader.program, "normalTexture"), 1);
-            
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(2)); // Position
-            glUniform1i(glGetUniformLocation(lightingShader.program, "positionTexture"), 2);
-            
-            // Set camera position for specular calculations
-            glUniform3fv(glGetUniformLocation(lightingShader.program, "viewPos"), 1, 
-                        glm::value_ptr(camera.getPosition()));
-            
-            // Set ambient light
-            glUniform3f(glGetUniformLocation(lightingShader.program, "ambientColor"), 0.1f, 0.1f, 0.1f);
-            
-            // Set attenuation factors
-            glUniform1f(glGetUniformLocation(lightingShader.program, "constantFactor"), 0.1f);
-            glUniform1f(glGetUniformLocation(lightingShader.program, "linearFactor"), 0.01f);
-            glUniform1f(glGetUniformLocation(lightingShader.program, "quadraticFactor"), 0.001f);
-            
-            // Set light count
-            glUniform1i(glGetUniformLocation(lightingShader.program, "numActiveLights"), 
-                       static_cast<int>(lightPositions.size()));
-            
-            // Set light positions and colors
-            for (size_t i = 0; i < lightPositions.size(); i++) {
-                std::string posName = "lightPositions[" + std::to_string(i) + "]";
-                std::string colorName = "lightColors[" + std::to_string(i) + "]";
-                
-                glUniform3fv(glGetUniformLocation(lightingShader.program, posName.c_str()), 1, 
-                            glm::value_ptr(lightPositions[i]));
-                glUniform3fv(glGetUniformLocation(lightingShader.program, colorName.c_str()), 1, 
-                            glm::value_ptr(lightColors[i]));
-            }
-        } else {
-            // Display individual G-Buffer (use display shader)
-            displayShader.use();
-            
-            // Bind G-Buffer textures
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(0)); // Diffuse
-            glUniform1i(glGetUniformLocation(displayShader.program, "diffuseTexture"), 0);
-            
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(1)); // Normal
-            glUniform1i(glGetUniformLocation(displayShader.program, "normalTexture"), 1);
-            
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, gBuffer.getTexture(2)); // Position
-            glUniform1i(glGetUniformLocation(displayShader.program, "positionTexture"), 2);
-            
-            // Set display mode
-            glUniform1i(glGetUniformLocation(displayShader.program, "displayMode"), displayMode);
+        // Gather skinned bone matrices and upload them in one buffer update
+        bonePalette.beginFrame();
+        if (armature->hasAnimatableSkeleton()) {
+            armatureBoneOffset = bonePalette.allocate(armature->getBoneMatrices());
         }
+        bonePalette.upload();
         
-        // Render quad
-        quadRenderer.renderQuad();
+        // Hand transient targets back to the pool, then schedule and run the frame
+        renderTargets.beginFrame();
+        renderGraph.execute(renderTargets);
         
         // Update window
         sdl.updateWindows();
         std::this_thread::sleep_for(16ms);
     }
-
+    
+    // How the audio callback kept up over the session
+    soundSystem.getInstrumentation().print(std::cout);
+    
     // Clean up
     delete cube;
     delete armature;
@@ -524,6 +742,6 @@ int main(int argc, char** argv) {
         delete light;
     }
     lightObjects.clear();
-
+    
     return 0;
 }
\ No newline at end of file
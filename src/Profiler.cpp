@@ -0,0 +1,304 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Zones kept per thread (32 bytes each)
+    const size_t RING_CAPACITY = size_t(1) << 16;
+    
+    // Written only by the owning thread; atomic so an export can read while it records.
+    // A slot is reused every RING_CAPACITY zones, so readers check it wasn't reused under them.
+    struct ZoneRecord {
+        std::atomic<const char*> name;
+        std::atomic<uint64_t> start;
+        std::atomic<uint64_t> end;
+        std::atomic<uint32_t> depth;
+    };
+    
+    struct ThreadRing {
+        uint32_t id = 0;
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<bool> inUse{ true };         // False while reserved and not yet claimed
+        std::unique_ptr<ZoneRecord[]> records;
+        std::atomic<uint64_t> claimed{ 0 };      // Zones whose slot the owner has started writing
+        std::atomic<uint64_t> written{ 0 };      // Zones recorded since the thread started
+    };
+    
+    // Copy of a record taken by an export
+    struct Zone {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+        uint32_t depth;
+    };
+    
+    // Rings outlive their threads so a trace still shows workers that have exited
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    
+    // Reserved rings, claimed in order without the registry lock
+    std::atomic<ThreadRing*> reservedRings[Profiler::MAX_REALTIME_THREADS];
+    std::atomic<size_t> reservedCount{ 0 };
+    std::atomic<size_t> reservedClaimed{ 0 };
+    
+    std::atomic<bool> enabled{ true };
+    
+    // Frame thread only
+    uint64_t frameStarts[Profiler::FRAME_HISTORY];
+    uint64_t frameCount = 0;
+    const ThreadRing* frameRing = nullptr;
+    
+    thread_local ThreadRing* localRing = nullptr;
+    thread_local bool localRealtime = false;      // Never allocate a ring for this thread
+    thread_local uint32_t localDepth = 0;
+    
+    // Caller holds registryMutex
+    ThreadRing* createRing(bool inUse) {
+        std::unique_ptr<ThreadRing> created(new ThreadRing());
+        created->id = static_cast<uint32_t>(rings.size());
+        created->inUse.store(inUse, std::memory_order_relaxed);
+        created->records.reset(new ZoneRecord[RING_CAPACITY]());
+        rings.push_back(std::move(created));
+        return rings.back().get();
+    }
+    
+    ThreadRing& threadRing() {
+        if (!localRing) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            localRing = createRing(true);
+        }
+        return *localRing;
+    }
+    
+    std::vector<const ThreadRing*> registeredRings() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::vector<const ThreadRing*> result;
+        for (const std::unique_ptr<ThreadRing>& ring : rings) {
+            if (ring->inUse.load(std::memory_order_acquire)) {
+                result.push_back(ring.get());
+            }
+        }
+        return result;
+    }
+    
+    // The zones still in a ring, oldest first. Read like a seqlock: records whose slot the
+    // owner claimed for a newer zone while they were being copied are dropped.
+    std::vector<Zone> snapshot(const ThreadRing& ring) {
+        const uint64_t end = ring.written.load(std::memory_order_acquire);
+        const uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        
+        std::vector<Zone> zones;
+        zones.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; i++) {
+            const ZoneRecord& record = ring.records[i % RING_CAPACITY];
+            zones.push_back(Zone{ record.name.load(std::memory_order_relaxed),
+                                  record.start.load(std::memory_order_relaxed),
+                                  record.end.load(std::memory_order_relaxed),
+                                  record.depth.load(std::memory_order_relaxed) });
+        }
+        
+        // Pairs with the fence in recordZone: a field copied from a newer zone means its
+        // claim is visible here, so the copy is dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimed = ring.claimed.load(std::memory_order_relaxed);
+        const uint64_t valid = claimed > RING_CAPACITY ? claimed - RING_CAPACITY : 0;
+        if (valid > begin) {
+            zones.erase(zones.begin(), zones.begin() + static_cast<size_t>(std::min<uint64_t>(valid - begin, zones.size())));
+        }
+        return zones;
+    }
+    
+    std::string threadName(const ThreadRing& ring) {
+        const char* name = ring.name.load(std::memory_order_relaxed);
+        return name ? std::string(name) : "Thread " + std::to_string(ring.id);
+    }
+    
+    void writeJsonString(std::ostream& out, const std::string& text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                    << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+    
+    // Complete ("X") event; Chrome trace times are microseconds
+    void writeZoneEvent(std::ostream& out, const char* name, uint32_t thread, uint64_t start, uint64_t end) {
+        out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"name\":";
+        writeJsonString(out, name);
+        out << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << (end - start) / 1000.0 << "}";
+    }
+}
+
+namespace Profiler {
+    uint64_t now() {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+    
+    void setEnabled(bool value) {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+    
+    bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    
+    void setThreadName(const char* name) {
+        ThreadRing& ring = threadRing();
+        if (!ring.name.load(std::memory_order_relaxed)) {
+            ring.name.store(name, std::memory_order_relaxed);
+        }
+    }
+    
+    void reserveRealtimeThreads(size_t count) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (size_t i = 0; i < count; i++) {
+            const size_t index = reservedCount.load(std::memory_order_relaxed);
+            if (index >= MAX_REALTIME_THREADS) break;
+            reservedRings[index].store(createRing(false), std::memory_order_relaxed);
+            reservedCount.store(index + 1, std::memory_order_release);
+        }
+    }
+    
+    void claimRealtimeThread(const char* name) {
+        if (localRing || localRealtime) {
+            if (localRing && !localRing->name.load(std::memory_order_relaxed)) {
+                localRing->name.store(name, std::memory_order_relaxed);
+            }
+            return;
+        }
+        localRealtime = true;
+        
+        size_t index = reservedClaimed.load(std::memory_order_relaxed);
+        while (index < reservedCount.load(std::memory_order_acquire)) {
+            if (reservedClaimed.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                ThreadRing* ring = reservedRings[index].load(std::memory_order_relaxed);
+                ring->name.store(name, std::memory_order_relaxed);
+                ring->inUse.store(true, std::memory_order_release);
+                localRing = ring;
+                return;
+            }
+        }
+    }
+    
+    void beginFrame() {
+        frameRing = &threadRing();
+        frameStarts[frameCount % FRAME_HISTORY] = now();
+        frameCount++;
+    }
+    
+    void recordZone(const char* name, uint64_t startNanos, uint64_t endNanos, uint32_t depth) {
+        if (!localRing && localRealtime) return;    // No reserved ring was left
+        ThreadRing& ring = threadRing();
+        const uint64_t index = ring.written.load(std::memory_order_relaxed);
+        ZoneRecord& record = ring.records[index % RING_CAPACITY];
+        
+        // Claim the slot before overwriting it (seqlock write side)
+        ring.claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record.name.store(name, std::memory_order_relaxed);
+        record.start.store(startNanos, std::memory_order_relaxed);
+        record.end.store(endNanos, std::memory_order_relaxed);
+        record.depth.store(depth, std::memory_order_relaxed);
+        ring.written.store(index + 1, std::memory_order_release);
+    }
+    
+    uint32_t& threadDepth() {
+        return localDepth;
+    }
+    
+    bool exportChromeTrace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Failed to open profile trace for writing: " << path << std::endl;
+            return false;
+        }
+        out << std::fixed << std::setprecision(3);
+        
+        // Everything that ended after the oldest retained frame began
+        const uint64_t firstFrame = frameCount > FRAME_HISTORY ? frameCount - FRAME_HISTORY : 0;
+        const uint64_t windowStart = frameCount > 0 ? frameStarts[firstFrame % FRAME_HISTORY] : 0;
+        
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Engine\"}}";
+        
+        size_t zoneCount = 0;
+        for (const ThreadRing* ring : registeredRings()) {
+            out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->id << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            writeJsonString(out, threadName(*ring));
+            out << "}}";
+            
+            for (const Zone& zone : snapshot(*ring)) {
+                if (zone.end >= windowStart) {
+                    writeZoneEvent(out, zone.name, ring->id, zone.start, zone.end);
+                    zoneCount++;
+                }
+            }
+        }
+        
+        // Complete frames enclose the frame thread's zones
+        for (uint64_t frame = firstFrame; frameRing && frame + 1 < frameCount; frame++) {
+            writeZoneEvent(out, "Frame", frameRing->id, frameStarts[frame % FRAME_HISTORY],
+                           frameStarts[(frame + 1) % FRAME_HISTORY]);
+        }
+        out << "\n]}\n";
+        
+        if (!out) {
+            std::cerr << "Failed to write profile trace: " << path << std::endl;
+            return false;
+        }
+        std::cout << "Wrote profile trace: " << path << " (" << zoneCount << " zones, "
+                  << (frameCount - firstFrame) << " frames)" << std::endl;
+        return true;
+    }
+    
+    void printLastFrame(std::ostream& out) {
+        if (frameCount < 2) {
+            out << "Profiler: no complete frame yet" << std::endl;
+            return;
+        }
+        std::ios::fmtflags savedFlags = out.flags();
+        std::streamsize savedPrecision = out.precision();
+        
+        const uint64_t from = frameStarts[(frameCount - 2) % FRAME_HISTORY];
+        const uint64_t to = frameStarts[(frameCount - 1) % FRAME_HISTORY];
+        out << std::fixed << std::setprecision(3);
+        out << "Frame " << frameCount - 2 << ": " << (to - from) / 1.0e6 << " ms" << std::endl;
+        
+        for (const ThreadRing* ring : registeredRings()) {
+            std::vector<Zone> zones = snapshot(*ring);
+            zones.erase(std::remove_if(zones.begin(), zones.end(), [&](const Zone& zone) {
+                return zone.start < from || zone.end > to;
+            }), zones.end());
+            if (zones.empty()) continue;
+            
+            // Recorded as they close (children first); print parents first
+            std::sort(zones.begin(), zones.end(), [](const Zone& a, const Zone& b) {
+                return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+            });
+            out << "  " << threadName(*ring) << std::endl;
+            for (const Zone& zone : zones) {
+                out << std::string(4 + 2 * zone.depth, ' ') << std::left << std::setw(40 - 2 * std::min(zone.depth, 10u))
+                    << zone.name << std::right << std::setw(10) << (zone.end - zone.start) / 1.0e6 << " ms" << std::endl;
+            }
+        }
+        
+        out.flags(savedFlags);
+        out.precision(savedPrecision);
+    }
+}
@@ -39,7 +39,7 @@ glm::vec3 Quaternion::operator*(const glm::vec3& v) const {
 
 // Compute the conjugate (inverse for unit quaternions)
 Quaternion Quaternion::conjugate() const {
-    return Quaternion(w, -x, -y, -z);
+    return Quaternion(w, -x, -y, -z, Unnormalized());
 }
 
 // Normalize quaternion to unit length
@@ -63,6 +63,14 @@ glm::mat4 Quaternion::toMatrix() const {
     );
 }
 
+glm::mat3 Quaternion::toMatrix3() const {
+    return glm::mat3(
+        1 - 2 * y * y - 2 * z * z, 2 * x * y - 2 * w * z, 2 * x * z + 2 * w * y,
+        2 * x * y + 2 * w * z, 1 - 2 * x * x - 2 * z * z, 2 * y * z - 2 * w * x,
+        2 * x * z - 2 * w * y, 2 * y * z + 2 * w * x, 1 - 2 * x * x - 2 * y * y
+    );
+}
+
 float Quaternion::getAngle() const {
     return glm::degrees(2.0f * std::acos(w)); // Convert from quaternion representation to degrees
 }
@@ -0,0 +1,384 @@
+#include "QuaternionMath.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define QUATERNION_MATH_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QUATERNION_MATH_SSE 1
+#endif
+
+namespace QuaternionMath {
+    // Below this angle between the keys slerp degenerates to nlerp (matches sin(theta) < 0.001)
+    static const float SLERP_LINEAR_THRESHOLD = 0.9999995f;
+    
+    // Polynomial correction of t so nlerp follows slerp's constant angular velocity.
+    // d is |dot(a, b)|; the coefficients are a least-squares fit over d in [0, 1].
+    static inline float correctT(float d, float t) {
+        float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+        float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+        float k = a * (t - 0.5f) * (t - 0.5f) + b;
+        return t + t * (t - 0.5f) * (t - 1.0f) * k;
+    }
+    
+    // Shortest-path lerp of raw components, normalized once at the end
+    static inline void lerpComponents(float aw, float ax, float ay, float az,
+                                      float bw, float bx, float by, float bz,
+                                      float t, bool correct, float* out) {
+        float d = aw * bw + ax * bx + ay * by + az * bz;
+        float absDot = std::fabs(d);
+        if (correct) {
+            t = correctT(absDot, t);
+        }
+        float tb = d < 0.0f ? -t : t;
+        float ta = 1.0f - t;
+        
+        float rw = aw * ta + bw * tb;
+        float rx = ax * ta + bx * tb;
+        float ry = ay * ta + by * tb;
+        float rz = az * ta + bz * tb;
+        float invLength = 1.0f / std::sqrt(rw * rw + rx * rx + ry * ry + rz * rz);
+        out[0] = rw * invLength;
+        out[1] = rx * invLength;
+        out[2] = ry * invLength;
+        out[3] = rz * invLength;
+    }
+    
+    const char* modeName(InterpolationMode mode) {
+        switch (mode) {
+            case InterpolationMode::Slerp: return "slerp";
+            case InterpolationMode::Nlerp: return "nlerp";
+            case InterpolationMode::ApproxSlerp: return "approx";
+        }
+        return "unknown";
+    }
+    
+    float dot(const Quaternion& a, const Quaternion& b) {
+        return a.getW() * b.getW() + a.getX() * b.getX() + a.getY() * b.getY() + a.getZ() * b.getZ();
+    }
+    
+    Quaternion slerp(const Quaternion& a, const Quaternion& b, float t) {
+        float d = dot(a, b);
+        float sign = 1.0f;
+        if (d < 0.0f) {
+            d = -d;
+            sign = -1.0f;
+        }
+        
+        // Nearly identical keys: the sin ratio is unstable, lerp instead
+        if (d > SLERP_LINEAR_THRESHOLD) {
+            return nlerp(a, b, t);
+        }
+        
+        // sin(theta) from the dot product saves one sin call
+        float theta = std::acos(d);
+        float invSinTheta = 1.0f / std::sqrt(1.0f - d * d);
+        float s1 = std::sin((1.0f - t) * theta) * invSinTheta;
+        float s2 = std::sin(t * theta) * invSinTheta * sign;
+        
+        return Quaternion(a.getW() * s1 + b.getW() * s2,
+                          a.getX() * s1 + b.getX() * s2,
+                          a.getY() * s1 + b.getY() * s2,
+                          a.getZ() * s1 + b.getZ() * s2,
+                          Quaternion::Unnormalized());
+    }
+    
+    Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t) {
+        float r[4];
+        lerpComponents(a.getW(), a.getX(), a.getY(), a.getZ(),
+                       b.getW(), b.getX(), b.getY(), b.getZ(), t, false, r);
+        return Quaternion(r[0], r[1], r[2], r[3], Quaternion::Unnormalized());
+    }
+    
+    Quaternion approxSlerp(const Quaternion& a, const Quaternion& b, float t) {
+        float r[4];
+        lerpComponents(a.getW(), a.getX(), a.getY(), a.getZ(),
+                       b.getW(), b.getX(), b.getY(), b.getZ(), t, true, r);
+        return Quaternion(r[0], r[1], r[2], r[3], Quaternion::Unnormalized());
+    }
+    
+    Quaternion interpolate(InterpolationMode mode, const Quaternion& a, const Quaternion& b, float t) {
+        switch (mode) {
+            case InterpolationMode::Nlerp: return nlerp(a, b, t);
+            case InterpolationMode::ApproxSlerp: return approxSlerp(a, b, t);
+            case InterpolationMode::Slerp: break;
+        }
+        return slerp(a, b, t);
+    }
+
+#if defined(QUATERNION_MATH_SSE)
+    // Four lanes starting at i
+    static inline void lerpSSE(const ConstStream& a, const ConstStream& b, const float* t,
+                               const Stream& out, size_t i, bool correct) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        
+        __m128 aw = _mm_loadu_ps(a.w + i), ax = _mm_loadu_ps(a.x + i);
+        __m128 ay = _mm_loadu_ps(a.y + i), az = _mm_loadu_ps(a.z + i);
+        __m128 bw = _mm_loadu_ps(b.w + i), bx = _mm_loadu_ps(b.x + i);
+        __m128 by = _mm_loadu_ps(b.y + i), bz = _mm_loadu_ps(b.z + i);
+        __m128 tv = _mm_loadu_ps(t + i);
+        
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bw), _mm_mul_ps(ax, bx)),
+                              _mm_add_ps(_mm_mul_ps(ay, by), _mm_mul_ps(az, bz)));
+        __m128 sign = _mm_and_ps(d, signMask);
+        
+        if (correct) {
+            __m128 absDot = _mm_andnot_ps(signMask, d);
+            __m128 ka = _mm_sub_ps(_mm_set1_ps(3.55645f), _mm_mul_ps(absDot, _mm_set1_ps(1.43519f)));
+            ka = _mm_add_ps(_mm_set1_ps(-3.2452f), _mm_mul_ps(absDot, ka));
+            ka = _mm_add_ps(_mm_set1_ps(1.0904f), _mm_mul_ps(absDot, ka));
+            __m128 kb = _mm_add_ps(_mm_set1_ps(-1.06021f), _mm_mul_ps(absDot, _mm_set1_ps(0.215638f)));
+            kb = _mm_add_ps(_mm_set1_ps(0.848013f), _mm_mul_ps(absDot, kb));
+            __m128 centered = _mm_sub_ps(tv, half);
+            __m128 k = _mm_add_ps(_mm_mul_ps(ka, _mm_mul_ps(centered, centered)), kb);
+            tv = _mm_add_ps(tv, _mm_mul_ps(_mm_mul_ps(tv, centered), _mm_mul_ps(_mm_sub_ps(tv, one), k)));
+        }
+        
+        __m128 tb = _mm_xor_ps(tv, sign);
+        __m128 ta = _mm_sub_ps(one, tv);
+        
+        __m128 rw = _mm_add_ps(_mm_mul_ps(aw, ta), _mm_mul_ps(bw, tb));
+        __m128 rx = _mm_add_ps(_mm_mul_ps(ax, ta), _mm_mul_ps(bx, tb));
+        __m128 ry = _mm_add_ps(_mm_mul_ps(ay, ta), _mm_mul_ps(by, tb));
+        __m128 rz = _mm_add_ps(_mm_mul_ps(az, ta), _mm_mul_ps(bz, tb));
+        
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rw, rw), _mm_mul_ps(rx, rx)),
+                                     _mm_add_ps(_mm_mul_ps(ry, ry), _mm_mul_ps(rz, rz)));
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+        _mm_storeu_ps(out.w + i, _mm_mul_ps(rw, invLength));
+        _mm_storeu_ps(out.x + i, _mm_mul_ps(rx, invLength));
+        _mm_storeu_ps(out.y + i, _mm_mul_ps(ry, invLength));
+        _mm_storeu_ps(out.z + i, _mm_mul_ps(rz, invLength));
+    }
+#endif
+
+#if defined(QUATERNION_MATH_AVX)
+    // Eight lanes starting at i
+    static inline void lerpAVX(const ConstStream& a, const ConstStream& b, const float* t,
+                               const Stream& out, size_t i, bool correct) {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        
+        __m256 aw = _mm256_loadu_ps(a.w + i), ax = _mm256_loadu_ps(a.x + i);
+        __m256 ay = _mm256_loadu_ps(a.y + i), az = _mm256_loadu_ps(a.z + i);
+        __m256 bw = _mm256_loadu_ps(b.w + i), bx = _mm256_loadu_ps(b.x + i);
+        __m256 by = _mm256_loadu_ps(b.y + i), bz = _mm256_loadu_ps(b.z + i);
+        __m256 tv = _mm256_loadu_ps(t + i);
+        
+        __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, bw), _mm256_mul_ps(ax, bx)),
+                                 _mm256_add_ps(_mm256_mul_ps(ay, by), _mm256_mul_ps(az, bz)));
+        __m256 sign = _mm256_and_ps(d, signMask);
+        
+        if (correct) {
+            __m256 absDot = _mm256_andnot_ps(signMask, d);
+            __m256 ka = _mm256_sub_ps(_mm256_set1_ps(3.55645f), _mm256_mul_ps(absDot, _mm256_set1_ps(1.43519f)));
+            ka = _mm256_add_ps(_mm256_set1_ps(-3.2452f), _mm256_mul_ps(absDot, ka));
+            ka = _mm256_add_ps(_mm256_set1_ps(1.0904f), _mm256_mul_ps(absDot, ka));
+            __m256 kb = _mm256_add_ps(_mm256_set1_ps(-1.06021f), _mm256_mul_ps(absDot, _mm256_set1_ps(0.215638f)));
+            kb = _mm256_add_ps(_mm256_set1_ps(0.848013f), _mm256_mul_ps(absDot, kb));
+            __m256 centered = _mm256_sub_ps(tv, half);
+            __m256 k = _mm256_add_ps(_mm256_mul_ps(ka, _mm256_mul_ps(centered, centered)), kb);
+            tv = _mm256_add_ps(tv, _mm256_mul_ps(_mm256_mul_ps(tv, centered), _mm256_mul_ps(_mm256_sub_ps(tv, one), k)));
+        }
+        
+        __m256 tb = _mm256_xor_ps(tv, sign);
+        __m256 ta = _mm256_sub_ps(one, tv);
+        
+        __m256 rw = _mm256_add_ps(_mm256_mul_ps(aw, ta), _mm256_mul_ps(bw, tb));
+        __m256 rx = _mm256_add_ps(_mm256_mul_ps(ax, ta), _mm256_mul_ps(bx, tb));
+        __m256 ry = _mm256_add_ps(_mm256_mul_ps(ay, ta), _mm256_mul_ps(by, tb));
+        __m256 rz = _mm256_add_ps(_mm256_mul_ps(az, ta), _mm256_mul_ps(bz, tb));
+        
+        __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(rw, rw), _mm256_mul_ps(rx, rx)),
+                                        _mm256_add_ps(_mm256_mul_ps(ry, ry), _mm256_mul_ps(rz, rz)));
+        __m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSq));
+        _mm256_storeu_ps(out.w + i, _mm256_mul_ps(rw, invLength));
+        _mm256_storeu_ps(out.x + i, _mm256_mul_ps(rx, invLength));
+        _mm256_storeu_ps(out.y + i, _mm256_mul_ps(ry, invLength));
+        _mm256_storeu_ps(out.z + i, _mm256_mul_ps(rz, invLength));
+    }
+#endif
+
+    void interpolateBatch(InterpolationMode mode, size_t count,
+                          const ConstStream& a, const ConstStream& b, const float* t,
+                          const Stream& out, unsigned maxLanes) {
+        size_t i = 0;
+        
+        if (mode == InterpolationMode::Slerp) {
+            for (; i < count; i++) {
+                Quaternion r = slerp(Quaternion(a.w[i], a.x[i], a.y[i], a.z[i], Quaternion::Unnormalized()),
+                                     Quaternion(b.w[i], b.x[i], b.y[i], b.z[i], Quaternion::Unnormalized()), t[i]);
+                out.w[i] = r.getW();
+                out.x[i] = r.getX();
+                out.y[i] = r.getY();
+                out.z[i] = r.getZ();
+            }
+            return;
+        }
+        
+        const bool correct = mode == InterpolationMode::ApproxSlerp;
+
+#if defined(QUATERNION_MATH_AVX)
+        if (maxLanes >= 8) {
+            for (; i + 8 <= count; i += 8) {
+                lerpAVX(a, b, t, out, i, correct);
+            }
+        }
+#endif
+#if defined(QUATERNION_MATH_SSE)
+        if (maxLanes >= 4) {
+            for (; i + 4 <= count; i += 4) {
+                lerpSSE(a, b, t, out, i, correct);
+            }
+        }
+#endif
+
+        // Remaining lanes (or everything without SIMD)
+        for (; i < count; i++) {
+            float r[4];
+            lerpComponents(a.w[i], a.x[i], a.y[i], a.z[i], b.w[i], b.x[i], b.y[i], b.z[i], t[i], correct, r);
+            out.w[i] = r[0];
+            out.x[i] = r[1];
+            out.y[i] = r[2];
+            out.z[i] = r[3];
+        }
+    }
+    
+    const char* simdPathName() {
+#if defined(QUATERNION_MATH_AVX)
+        return "AVX";
+#elif defined(QUATERNION_MATH_SSE)
+        return "SSE";
+#else
+        return "scalar";
+#endif
+    }
+    
+    // Angle in degrees between two rotations, from the vector part of conjugate(q) * r
+    // (atan2 keeps precision for tiny angles, where acos of a dot product does not)
+    static double angleBetween(const double* q, float w, float x, float y, float z) {
+        double dw = q[0] * w + q[1] * x + q[2] * y + q[3] * z;
+        double dx = q[0] * x - q[1] * w - q[2] * z + q[3] * y;
+        double dy = q[0] * y + q[1] * z - q[2] * w - q[3] * x;
+        double dz = q[0] * z - q[1] * y + q[2] * x - q[3] * w;
+        double vectorLength = std::sqrt(dx * dx + dy * dy + dz * dz);
+        return 2.0 * std::atan2(vectorLength, std::fabs(dw)) * 180.0 / 3.14159265358979323846;
+    }
+    
+    void runBenchmark(size_t count, int iterations, std::ostream& out) {
+        std::ios::fmtflags savedFlags = out.flags();
+        std::streamsize savedPrecision = out.precision();
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> zeroOne(0.0f, 1.0f);
+        
+        const InterpolationMode modes[3] = { InterpolationMode::Slerp, InterpolationMode::Nlerp, InterpolationMode::ApproxSlerp };
+        const float maxAngles[4] = { 10.0f, 45.0f, 90.0f, 179.0f };
+        
+        // Accuracy: key pairs separated by up to each angle, compared against a double-precision slerp
+        out << "Quaternion interpolation: max angular error vs exact slerp (degrees)" << std::endl;
+        out << std::left << std::setw(10) << "mode";
+        for (float angle : maxAngles) {
+            out << std::setw(14) << ("<= " + std::to_string(static_cast<int>(angle)) + " deg");
+        }
+        out << std::endl;
+        
+        for (InterpolationMode mode : modes) {
+            out << std::left << std::setw(10) << modeName(mode);
+            for (float maxAngle : maxAngles) {
+                double maxError = 0.0;
+                for (int sampleIndex = 0; sampleIndex < 20000; sampleIndex++) {
+                    Quaternion a(unit(rng), unit(rng), unit(rng), unit(rng));
+                    glm::vec3 axis(unit(rng), unit(rng), unit(rng) + 1.5f);
+                    float angle = maxAngle * zeroOne(rng);
+                    Quaternion b = a * Quaternion(angle, axis);
+                    if (sampleIndex & 1) {
+                        b = Quaternion(-b.getW(), -b.getX(), -b.getY(), -b.getZ(), Quaternion::Unnormalized());
+                    }
+                    float t = zeroOne(rng);
+                    
+                    // Reference slerp in double precision
+                    double qa[4] = { a.getW(), a.getX(), a.getY(), a.getZ() };
+                    double qb[4] = { b.getW(), b.getX(), b.getY(), b.getZ() };
+                    double d = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+                    double sign = d < 0.0 ? -1.0 : 1.0;
+                    double theta = std::acos(std::min(1.0, std::fabs(d)));
+                    double s1 = theta > 1e-9 ? std::sin((1.0 - t) * theta) / std::sin(theta) : 1.0 - t;
+                    double s2 = theta > 1e-9 ? std::sin(t * theta) / std::sin(theta) : t;
+                    double reference[4];
+                    for (int c = 0; c < 4; c++) {
+                        reference[c] = qa[c] * s1 + qb[c] * s2 * sign;
+                    }
+                    
+                    Quaternion r = interpolate(mode, a, b, t);
+                    maxError = std::max(maxError, angleBetween(reference, r.getW(), r.getX(), r.getY(), r.getZ()));
+                }
+                out << std::setw(14) << std::scientific << std::setprecision(2) << maxError;
+            }
+            out << std::defaultfloat << std::endl;
+        }
+        
+        // Throughput: key pairs typical of animation playback (up to 45 degrees apart)
+        std::vector<float> aw(count), ax(count), ay(count), az(count);
+        std::vector<float> bw(count), bx(count), by(count), bz(count);
+        std::vector<float> alpha(count);
+        std::vector<float> ow(count), ox(count), oy(count), oz(count);
+        for (size_t i = 0; i < count; i++) {
+            Quaternion a(unit(rng), unit(rng), unit(rng), unit(rng));
+            Quaternion b = a * Quaternion(45.0f * zeroOne(rng), glm::vec3(unit(rng), unit(rng), unit(rng) + 1.5f));
+            aw[i] = a.getW(); ax[i] = a.getX(); ay[i] = a.getY(); az[i] = a.getZ();
+            bw[i] = b.getW(); bx[i] = b.getX(); by[i] = b.getY(); bz[i] = b.getZ();
+            alpha[i] = zeroOne(rng);
+        }
+        ConstStream a = { aw.data(), ax.data(), ay.data(), az.data() };
+        ConstStream b = { bw.data(), bx.data(), by.data(), bz.data() };
+        Stream result = { ow.data(), ox.data(), oy.data(), oz.data() };
+        
+        std::vector<unsigned> laneCounts = { 1 };
+#if defined(QUATERNION_MATH_SSE)
+        laneCounts.push_back(4);
+#endif
+#if defined(QUATERNION_MATH_AVX)
+        laneCounts.push_back(8);
+#endif
+
+        out << std::endl << "Quaternion interpolation throughput: " << count << " pairs, "
+            << iterations << " iterations, SIMD path " << simdPathName() << std::endl;
+        out << std::left << std::setw(10) << "mode" << std::setw(8) << "lanes"
+            << std::setw(12) << "ns/quat" << "Mquat/sec" << std::endl;
+        
+        for (InterpolationMode mode : modes) {
+            for (unsigned lanes : laneCounts) {
+                // Slerp has no SIMD variant
+                if (mode == InterpolationMode::Slerp && lanes > 1) break;
+                
+                interpolateBatch(mode, count, a, b, alpha.data(), result, lanes);   // Warm-up
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < iterations; ++i) {
+                    interpolateBatch(mode, count, a, b, alpha.data(), result, lanes);
+                }
+                auto stop = std::chrono::steady_clock::now();
+                
+                double seconds = std::chrono::duration<double>(stop - start).count();
+                double total = static_cast<double>(count) * std::max(1, iterations);
+                out << std::left << std::setw(10) << modeName(mode) << std::setw(8) << lanes
+                    << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1.0e9 / total
+                    << std::setprecision(1) << (seconds > 0.0 ? total / seconds / 1.0e6 : 0.0)
+                    << std::defaultfloat << std::endl;
+            }
+        }
+        
+        out.flags(savedFlags);
+        out.precision(savedPrecision);
+    }
+}
@@ -0,0 +1,382 @@
+#include "RenderGraph.hpp"
+#include <algorithm>
+#include <iostream>
+
+// ----- PassBuilder Implementation -----
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(const std::string& resourceName) {
+    graph.passes[passIndex].readNames.push_back(resourceName);
+    graph.compiled = false;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(const std::string& resourceName) {
+    graph.passes[passIndex].writeNames.push_back(resourceName);
+    graph.compiled = false;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffects() {
+    graph.passes[passIndex].hasSideEffects = true;
+    graph.compiled = false;
+    return *this;
+}
+
+// ----- RenderGraph Implementation -----
+
+RenderGraph::RenderGraph() : physicalTargetCount(0), compiled(false) {}
+
+void RenderGraph::createResource(const std::string& name, const RenderTargetDesc& desc) {
+    if (resourceLookup.count(name)) {
+        std::cerr << "Warning: Render graph resource '" << name << "' declared twice" << std::endl;
+        return;
+    }
+    
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.imported = false;
+    resource.external = nullptr;
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+    resource.physicalSlot = -1;
+    
+    resourceLookup[name] = static_cast<int>(resources.size());
+    resources.push_back(resource);
+    compiled = false;
+}
+
+void RenderGraph::importResource(const std::string& name, Framebuffer* framebuffer) {
+    if (resourceLookup.count(name)) {
+        std::cerr << "Warning: Render graph resource '" << name << "' declared twice" << std::endl;
+        return;
+    }
+    
+    Resource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.external = framebuffer;
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+    resource.physicalSlot = -1;
+    
+    resourceLookup[name] = static_cast<int>(resources.size());
+    resources.push_back(resource);
+    compiled = false;
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string& name, ExecuteFunction execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.enabled = true;
+    pass.hasSideEffects = false;
+    pass.active = false;
+    
+    int index = static_cast<int>(passes.size());
+    passLookup[name] = index;
+    passes.push_back(pass);
+    compiled = false;
+    
+    return PassBuilder(*this, index);
+}
+
+void RenderGraph::setPassEnabled(const std::string& name, bool enabled) {
+    auto it = passLookup.find(name);
+    if (it == passLookup.end()) {
+        std::cerr << "Warning: Unknown render pass '" << name << "'" << std::endl;
+        return;
+    }
+    
+    if (passes[it->second].enabled != enabled) {
+        passes[it->second].enabled = enabled;
+        compiled = false;
+    }
+}
+
+int RenderGraph::findResource(const std::string& name) const {
+    auto it = resourceLookup.find(name);
+    return it != resourceLookup.end() ? it->second : -1;
+}
+
+bool RenderGraph::resolvePasses() {
+    for (auto& resource : resources) {
+        resource.writers.clear();
+        resource.readers.clear();
+    }
+    
+    for (size_t p = 0; p < passes.size(); ++p) {
+        Pass& pass = passes[p];
+        pass.reads.clear();
+        pass.writes.clear();
+        
+        for (const auto& name : pass.readNames) {
+            int index = findResource(name);
+            if (index < 0) {
+                std::cerr << "Render graph error: Pass '" << pass.name << "' reads unknown resource '" << name << "'" << std::endl;
+                return false;
+            }
+            pass.reads.push_back(index);
+            resources[index].readers.push_back(static_cast<int>(p));
+        }
+        
+        for (const auto& name : pass.writeNames) {
+            int index = findResource(name);
+            if (index < 0) {
+                std::cerr << "Render graph error: Pass '" << pass.name << "' writes unknown resource '" << name << "'" << std::endl;
+                return false;
+            }
+            pass.writes.push_back(index);
+            resources[index].writers.push_back(static_cast<int>(p));
+        }
+    }
+    
+    return true;
+}
+
+bool RenderGraph::cullPasses() {
+    std::vector<int> worklist;
+    
+    // Roots: enabled passes with visible results (imported outputs or explicit side effects)
+    for (size_t p = 0; p < passes.size(); ++p) {
+        Pass& pass = passes[p];
+        pass.active = false;
+        if (!pass.enabled) continue;
+        
+        bool isRoot = pass.hasSideEffects;
+        for (int r : pass.writes) {
+            if (resources[r].imported) isRoot = true;
+        }
+        
+        if (isRoot) {
+            pass.active = true;
+            worklist.push_back(static_cast<int>(p));
+        }
+    }
+    
+    // Walk dependencies backwards: every enabled writer of a read resource is needed
+    while (!worklist.empty()) {
+        int p = worklist.back();
+        worklist.pop_back();
+        
+        for (int r : passes[p].reads) {
+            const Resource& resource = resources[r];
+            
+            bool hasWriter = resource.imported;
+            for (int writer : resource.writers) {
+                if (writer == p || !passes[writer].enabled) continue;
+                hasWriter = true;
+                if (!passes[writer].active) {
+                    passes[writer].active = true;
+                    worklist.push_back(writer);
+                }
+            }
+            
+            if (!hasWriter) {
+                std::cerr << "Render graph error: Pass '" << passes[p].name << "' reads '" << resource.name
+                          << "' but no enabled pass writes it" << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool RenderGraph::sortPasses() {
+    const size_t passCount = passes.size();
+    std::vector<std::vector<int>> edges(passCount);
+    std::vector<int> inDegree(passCount, 0);
+    
+    auto addEdge = [&](int from, int to) {
+        if (from == to) return;
+        if (std::find(edges[from].begin(), edges[from].end(), to) != edges[from].end()) return;
+        edges[from].push_back(to);
+        inDegree[to]++;
+    };
+    
+    for (const auto& resource : resources) {
+        // Active writers in declaration order: each writer precedes the next, and all precede readers
+        std::vector<int> writers;
+        for (int w : resource.writers) {
+            if (passes[w].active) writers.push_back(w);
+        }
+        
+        for (size_t i = 1; i < writers.size(); ++i) {
+            addEdge(writers[i - 1], writers[i]);
+        }
+        
+        for (int reader : resource.readers) {
+            if (!passes[reader].active) continue;
+            for (int writer : writers) {
+                addEdge(writer, reader);
+            }
+        }
+    }
+    
+    // Kahn's algorithm; ties resolved by declaration order to keep the schedule stable
+    executionOrder.clear();
+    std::vector<int> ready;
+    size_t activeCount = 0;
+    for (size_t p = 0; p < passCount; ++p) {
+        if (!passes[p].active) continue;
+        activeCount++;
+        if (inDegree[p] == 0) ready.push_back(static_cast<int>(p));
+    }
+    
+    while (!ready.empty()) {
+        auto next = std::min_element(ready.begin(), ready.end());
+        int p = *next;
+        ready.erase(next);
+        executionOrder.push_back(p);
+        
+        for (int to : edges[p]) {
+            if (--inDegree[to] == 0) {
+                ready.push_back(to);
+            }
+        }
+    }
+    
+    if (executionOrder.size() != activeCount) {
+        std::cerr << "Render graph error: Dependency cycle between passes" << std::endl;
+        executionOrder.clear();
+        return false;
+    }
+    
+    return true;
+}
+
+void RenderGraph::computeLifetimes() {
+    for (auto& resource : resources) {
+        resource.firstUse = -1;
+        resource.lastUse = -1;
+    }
+    
+    for (size_t i = 0; i < executionOrder.size(); ++i) {
+        const Pass& pass = passes[executionOrder[i]];
+        
+        auto touch = [&](int r) {
+            Resource& resource = resources[r];
+            if (resource.firstUse < 0) resource.firstUse = static_cast<int>(i);
+            resource.lastUse = static_cast<int>(i);
+        };
+        
+        for (int r : pass.writes) touch(r);
+        for (int r : pass.reads) touch(r);
+    }
+}
+
+void RenderGraph::assignPhysicalTargets() {
+    physicalTargets.clear();
+    
+    // Visit transient resources in order of first use
+    std::vector<int> order;
+    for (size_t r = 0; r < resources.size(); ++r) {
+        resources[r].physicalSlot = -1;
+        if (!resources[r].imported && resources[r].firstUse >= 0) {
+            order.push_back(static_cast<int>(r));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return resources[a].firstUse < resources[b].firstUse;
+    });
+    
+    // Greedy interval packing: reuse a compatible target whose lifetime already ended
+    for (int r : order) {
+        Resource& resource = resources[r];
+        
+        int slot = -1;
+        for (size_t t = 0; t < physicalTargets.size(); ++t) {
+            if (physicalTargets[t].desc == resource.desc && physicalTargets[t].lastUse < resource.firstUse) {
+                slot = static_cast<int>(t);
+                break;
+            }
+        }
+        
+        if (slot < 0) {
+            PhysicalTarget target;
+            target.desc = resource.desc;
+            target.firstUse = resource.firstUse;
+            target.framebuffer = nullptr;
+            slot = static_cast<int>(physicalTargets.size());
+            physicalTargets.push_back(target);
+        }
+        
+        physicalTargets[slot].lastUse = resource.lastUse;
+        resource.physicalSlot = slot;
+    }
+    
+    physicalTargetCount = static_cast<int>(physicalTargets.size());
+}
+
+bool RenderGraph::compile() {
+    compiled = false;
+    executionOrder.clear();
+    physicalTargets.clear();
+    physicalTargetCount = 0;
+    
+    if (!resolvePasses() || !cullPasses() || !sortPasses()) {
+        return false;
+    }
+    
+    computeLifetimes();
+    assignPhysicalTargets();
+    
+    compiled = true;
+    return true;
+}
+
+Framebuffer* RenderGraph::getFramebuffer(const std::string& resourceName) const {
+    int index = findResource(resourceName);
+    if (index < 0) {
+        std::cerr << "Warning: Unknown render graph resource '" << resourceName << "'" << std::endl;
+        return nullptr;
+    }
+    
+    const Resource& resource = resources[index];
+    if (resource.imported) {
+        return resource.external;
+    }
+    if (resource.physicalSlot < 0) {
+        return nullptr;
+    }
+    return physicalTargets[resource.physicalSlot].framebuffer;
+}
+
+std::vector<std::string> RenderGraph::getExecutionOrder() const {
+    std::vector<std::string> names;
+    for (int p : executionOrder) {
+        names.push_back(passes[p].name);
+    }
+    return names;
+}
+
+bool RenderGraph::isPassActive(const std::string& name) const {
+    auto it = passLookup.find(name);
+    return it != passLookup.end() && passes[it->second].active;
+}
+
+int RenderGraph::getPhysicalSlot(const std::string& resourceName) const {
+    int index = findResource(resourceName);
+    return index >= 0 ? resources[index].physicalSlot : -1;
+}
+
+void RenderGraph::dumpSchedule(std::ostream& out) const {
+    out << "Render graph: " << executionOrder.size() << " of " << passes.size() << " passes active, "
+        << physicalTargetCount << " physical targets" << std::endl;
+    
+    for (size_t i = 0; i < executionOrder.size(); ++i) {
+        out << "  " << i << ": " << passes[executionOrder[i]].name << std::endl;
+    }
+    
+    for (const auto& resource : resources) {
+        if (resource.firstUse < 0) continue;
+        out << "  [" << resource.name << "] passes " << resource.firstUse << "-" << resource.lastUse;
+        if (resource.imported) {
+            out << " (imported)";
+        } else {
+            out << " -> slot " << resource.physicalSlot;
+        }
+        out << std::endl;
+    }
+}
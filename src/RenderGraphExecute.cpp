@@ -0,0 +1,39 @@
+#include "RenderGraph.hpp"
+#include "Profiler.hpp"
+#include "RenderTargetPool.hpp"
+#include <iostream>
+
+// Kept apart from RenderGraph.cpp: compiling a graph needs no GL, running it does
+
+void RenderGraph::execute(RenderTargetPool& pool) {
+    PROFILE_ZONE("RenderGraph::execute");
+    
+    if (!compiled && !compile()) {
+        std::cerr << "Render graph error: Cannot execute, compilation failed" << std::endl;
+        return;
+    }
+    
+    for (size_t i = 0; i < executionOrder.size(); ++i) {
+        const int position = static_cast<int>(i);
+        
+        // Materialize targets whose lifetime starts here
+        for (auto& target : physicalTargets) {
+            if (target.firstUse == position) {
+                target.framebuffer = pool.acquire(target.desc);
+            }
+        }
+        
+        Pass& pass = passes[executionOrder[i]];
+        if (pass.execute) {
+            pass.execute(*this);
+        }
+        
+        // Hand back targets after their last use so later passes can alias them
+        for (auto& target : physicalTargets) {
+            if (target.lastUse == position && target.framebuffer) {
+                pool.release(target.framebuffer);
+                target.framebuffer = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include "RenderTargetPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+RenderTargetPool::RenderTargetPool(int screenWidth, int screenHeight, std::uint64_t maxIdleFrames)
+    : screenWidth(screenWidth),
+      screenHeight(screenHeight),
+      screenResized(false),
+      frameIndex(0),
+      maxIdleFrames(maxIdleFrames),
+      acquiresThisFrame(0),
+      createdThisFrame(0) {}
+
+void RenderTargetPool::resolveSize(const RenderTargetDesc& desc, int& width, int& height) const {
+    if (desc.isScreenRelative()) {
+        width = std::max(1, static_cast<int>(std::lround(screenWidth * desc.scale)));
+        height = std::max(1, static_cast<int>(std::lround(screenHeight * desc.scale)));
+    } else {
+        width = desc.width;
+        height = desc.height;
+    }
+}
+
+bool RenderTargetPool::matches(const PooledTarget& target, const RenderTargetDesc& desc, int width, int height) {
+    return !target.inUse &&
+           target.width == width && target.height == height &&
+           target.desc.depthStencil == desc.depthStencil &&
+           target.desc.sampleableDepth == desc.sampleableDepth &&
+           target.desc.attachments == desc.attachments;
+}
+
+void RenderTargetPool::beginFrame() {
+    frameIndex++;
+    acquiresThisFrame = 0;
+    createdThisFrame = 0;
+    
+    // Transient targets only live for one frame
+    for (auto& target : targets) {
+        target.inUse = false;
+    }
+    
+    // Drop targets that are no longer the right size or haven't been used lately
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [this](const PooledTarget& target) {
+        if (screenResized && target.desc.isScreenRelative()) {
+            int width, height;
+            resolveSize(target.desc, width, height);
+            if (width != target.width || height != target.height) {
+                return true;
+            }
+        }
+        return frameIndex - target.lastUsedFrame > maxIdleFrames;
+    }), targets.end());
+    
+    screenResized = false;
+}
+
+Framebuffer* RenderTargetPool::acquire(const RenderTargetDesc& desc) {
+    int width, height;
+    resolveSize(desc, width, height);
+    acquiresThisFrame++;
+    
+    // Reuse a free target with the same key (aliasing with earlier passes)
+    for (auto& target : targets) {
+        if (matches(target, desc, width, height)) {
+            target.inUse = true;
+            target.lastUsedFrame = frameIndex;
+            return target.framebuffer.get();
+        }
+    }
+    
+    // Nothing suitable - create a new target
+    PooledTarget target;
+    target.framebuffer = std::make_unique<Framebuffer>(width, height, desc.attachments, desc.depthStencil, desc.sampleableDepth);
+    target.desc = desc;
+    target.width = width;
+    target.height = height;
+    target.inUse = true;
+    target.lastUsedFrame = frameIndex;
+    
+    size_t pixelBytes = desc.depthStencil ? 4 : 0;  // DEPTH24_STENCIL8
+    for (const auto& attachment : desc.attachments) {
+        pixelBytes += bytesPerPixel(attachment.internalFormat);
+    }
+    target.bytes = pixelBytes * static_cast<size_t>(width) * static_cast<size_t>(height);
+    
+    createdThisFrame++;
+    targets.push_back(std::move(target));
+    return targets.back().framebuffer.get();
+}
+
+void RenderTargetPool::release(Framebuffer* framebuffer) {
+    for (auto& target : targets) {
+        if (target.framebuffer.get() == framebuffer) {
+            target.inUse = false;
+            return;
+        }
+    }
+    
+    std::cerr << "Warning: Releasing a framebuffer that does not belong to the pool" << std::endl;
+}
+
+void RenderTargetPool::resize(int width, int height) {
+    if (width == screenWidth && height == screenHeight) {
+        return;
+    }
+    
+    screenWidth = width;
+    screenHeight = height;
+    screenResized = true;
+}
+
+void RenderTargetPool::clear() {
+    targets.clear();
+}
+
+size_t RenderTargetPool::getAllocatedBytes() const {
+    size_t total = 0;
+    for (const auto& target : targets) {
+        total += target.bytes;
+    }
+    return total;
+}
+
+size_t RenderTargetPool::bytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_R8:
+            return 1;
+        case GL_RG8:
+        case GL_R16:
+        case GL_R16F:
+            return 2;
+        case GL_RGB8:
+            return 3;
+        case GL_RGBA:
+        case GL_RGBA8:
+        case GL_RG16:
+        case GL_RG16F:
+        case GL_R32F:
+        case GL_R11F_G11F_B10F:
+        case GL_RGB10_A2:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+            return 4;
+        case GL_RGB16F:
+            return 6;
+        case GL_RGBA16F:
+        case GL_RG32F:
+            return 8;
+        case GL_RGB32F:
+            return 12;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
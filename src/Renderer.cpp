@@ -1,4 +1,7 @@
 #include "Renderer.hpp"
+#include "Camera.hpp"
+#include "Profiler.hpp"
+#include "SceneGraph.hpp"
 #include <iostream>
 
 Renderer::Renderer() {
@@ -31,14 +34,40 @@ void Renderer::submit(GameObject* object) {
 
 // Draws all objects
 void Renderer::render(Shader& shader, const glm::mat4& view, const glm::mat4& proj) {
+    PROFILE_ZONE("Renderer::render");
+    
+    // Gather every skinned object's bone matrices into the palette and upload them once
+    bonePalette.beginFrame();
+    boneOffsets.clear();
+    for (auto object : renderQueue) {
+        boneOffsets.push_back(object->hasAnimatableSkeleton()
+                              ? bonePalette.allocate(object->getBoneMatrices())
+                              : -1);
+    }
+    bonePalette.upload();
+    
     shader.use();
     GLint projLoc = shader.getUniform("proj");
     GLint viewLoc = shader.getUniform("view");
     
     glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(proj));
     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+    
+    // Bone palette lives on texture unit 1 (unit 0 is the material texture)
+    GLint paletteLoc = shader.getUniform("bonePalette");
+    if (paletteLoc != -1) {
+        bonePalette.bind(1);
+        glUniform1i(paletteLoc, 1);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    GLint usePaletteLoc = shader.getUniform("useBonePalette");
+    if (usePaletteLoc != -1) {
+        glUniform1i(usePaletteLoc, GL_TRUE);
+    }
 
-    for (auto object : renderQueue) {
+    for (size_t i = 0; i < renderQueue.size(); i++) {
+        GameObject* object = renderQueue[i];
+        
         // Bind the object's VAO and VBO for rendering
         glBindVertexArray(object->getVAO());
         glBindBuffer(GL_ARRAY_BUFFER, object->getVBO());
@@ -50,25 +79,20 @@ void Renderer::render(Shader& shader, const glm::mat4& view, const glm::mat4& pr
 
         // Check if object has an armature and set appropriate uniforms
         if (object->hasAnimatableSkeleton()) {
-            // Set bone matrices in shader if the uniform exists
+            // Set skinning uniforms in shader if they exist
             GLint hasArmatureLoc = shader.getUniform("hasArmature");
             if (hasArmatureLoc != -1) {
                 glUniform1i(hasArmatureLoc, GL_TRUE);
                 
-                // Get bone count and matrices
-                const auto& boneMatrices = object->getBoneMatrices();
                 GLint boneCountLoc = shader.getUniform("boneCount");
                 if (boneCountLoc != -1) {
-                    glUniform1i(boneCountLoc, static_cast<int>(boneMatrices.size()));
+                    glUniform1i(boneCountLoc, static_cast<int>(object->getBoneMatrices().size()));
                 }
                 
-                // Upload bone matrices to shader
-                for (size_t i = 0; i < boneMatrices.size(); i++) {
-                    std::string uniformName = "boneMatrices[" + std::to_string(i) + "]";
-                    GLint matrixLoc = shader.getUniform(uniformName.c_str());
-                    if (matrixLoc != -1) {
-                        glUniformMatrix4fv(matrixLoc, 1, GL_FALSE, glm::value_ptr(boneMatrices[i]));
-                    }
+                // Point the shader at this object's slice of the bone palette
+                GLint boneOffsetLoc = shader.getUniform("boneOffset");
+                if (boneOffsetLoc != -1) {
+                    glUniform1i(boneOffsetLoc, boneOffsets[i]);
                 }
             }
         } else {
@@ -87,4 +111,37 @@ void Renderer::render(Shader& shader, const glm::mat4& view, const glm::mat4& pr
     }
 
     renderQueue.clear();
-}
\ No newline at end of file
+}
+
+// Scene graph submission lives here so the scene graph itself builds without GL
+void SceneNode::render(Renderer& renderer, const Frustum& frustum) {
+    // Check if node is visible
+    if (!frustum.containsAABB(getWorldBounds())) {
+        return;
+    }
+    
+    // Render all attached objects
+    for (auto* obj : objects) {
+        renderer.submit(obj);
+    }
+    
+    // Render all children
+    for (auto& child : children) {
+        child->render(renderer, frustum);
+    }
+}
+
+void SceneGraph::render(Renderer& renderer, const Camera& camera) {
+    // Create frustum from camera
+    Frustum frustum;
+    frustum.updateFromCamera(camera);
+    
+    // Collect visible objects
+    std::vector<GameObject*> visibleObjects;
+    getVisibleObjects(visibleObjects, camera);
+    
+    // Submit them to the renderer
+    for (auto* obj : visibleObjects) {
+        renderer.submit(obj);
+    }
+}
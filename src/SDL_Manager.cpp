@@ -1,4 +1,5 @@
 #include "SDL_Manager.hpp"
+#include "ShapeGpu.hpp"
 
 SDL_Manager::SDL_Manager() : count(0) {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
@@ -84,6 +85,9 @@ void SDL_Manager::spawnWindow(const std::string& title, int width, int height, S
         while ((glErr = glGetError()) != GL_NO_ERROR) {
             std::cerr << "OpenGL Error: " << glErr << "\n";
         }
+
+        // Shapes built from here on get vertex buffers
+        ShapeGpu::install();
     }
 
     // Add window to list
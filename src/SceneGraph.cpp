@@ -1,6 +1,6 @@
 #include "SceneGraph.hpp"
 #include "Camera.hpp"
-#include "Renderer.hpp"
+#include "Profiler.hpp"
 #include <algorithm>
 #include <iostream>
 
@@ -290,23 +290,6 @@ const std::vector<GameObject*>& SceneNode::getObjects() const {
     return objects;
 }
 
-void SceneNode::render(Renderer& renderer, const Frustum& frustum) {
-    // Check if node is visible
-    if (!frustum.containsAABB(getWorldBounds())) {
-        return;
-    }
-    
-    // Render all attached objects
-    for (auto* obj : objects) {
-        renderer.submit(obj);
-    }
-    
-    // Render all children
-    for (auto& child : children) {
-        child->render(renderer, frustum);
-    }
-}
-
 void SceneNode::update(float deltaTime) {
     // Update attached objects
     for (auto* obj : objects) {
@@ -587,21 +570,6 @@ void SceneGraph::updateTransforms() {
     rootNode->updateWorldBounds();
 }
 
-void SceneGraph::render(Renderer& renderer, const Camera& camera) {
-    // Create frustum from camera
-    Frustum frustum;
-    frustum.updateFromCamera(camera);
-    
-    // Collect visible objects
-    std::vector<GameObject*> visibleObjects;
-    getVisibleObjects(visibleObjects, camera);
-    
-    // Submit them to the renderer
-    for (auto* obj : visibleObjects) {
-        renderer.submit(obj);
-    }
-}
-
 SceneNode* SceneGraph::createNode(SceneNode* parent) {
     auto node = std::make_unique<SceneNode>();
     SceneNode* nodePtr = node.get();
@@ -639,6 +607,8 @@ void SceneGraph::getVisibleObjects(std::vector<GameObject*>& visibleObjects, con
 }
 
 void SceneGraph::updateSpatialStructure() {
+    PROFILE_ZONE("SceneGraph::updateSpatialStructure (rebuild)");
+    
     // Clear and rebuild octree
     octreeRoot = std::make_unique<OctreeNode>(worldBounds);
     
@@ -659,6 +629,8 @@ void SceneGraph::updateSpatialStructure() {
 
 // Update objects in the scene - call this per frame
 void SceneGraph::updateSpatialStructure(float deltaTime) {
+    PROFILE_ZONE("SceneGraph::updateSpatialStructure");
+    
     // First, update all objects in the scene hierarchy
     std::function<void(SceneNode*, float)> updateNode = [&](SceneNode* node, float dt) {
         // Update all objects attached to this node
@@ -791,6 +763,7 @@ void SceneGraph::updateObject(GameObject* obj) {
 }
 
 void SceneGraph::processCollisionResponses() {
+    PROFILE_ZONE("SceneGraph::processCollisionResponses");
     std::vector<std::pair<GameObject*, GameObject*>> collisions;
     detectCollisions(collisions);
     
@@ -1,4 +1,5 @@
 #include "Shape.hpp"
+#include "Skeleton.hpp"
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -6,6 +7,14 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <cmath>
+
+Shape::GpuHooks Shape::gpuHooks = { nullptr, nullptr, nullptr };
+
+void Shape::setGpuHooks(const GpuHooks& hooks) {
+    gpuHooks = hooks;
+}
 
 // Original constructor for backward compatibility
 Shape::Shape(const size_t triangleCount, const std::vector<float>& vertexData) {
@@ -13,43 +22,31 @@ Shape::Shape(const size_t triangleCount, const std::vector<float>& vertexData) {
         std::cerr << "Error: Empty mesh data!" << std::endl;
         return;
     }
-
+    
     size_t totalVertices = triangleCount * 3;
-
+    
     if (vertexData.size() != totalVertices * 6) {
         std::cerr << "Error: Incorrect vertex data size!" << std::endl;
         return;
     }
-
+    
     // Extract position and normal data into pos and norm vectors
     for (size_t i = 0; i < totalVertices; i++) {
         float x = vertexData[i * 6 + 0];
         float y = vertexData[i * 6 + 1];
         float z = vertexData[i * 6 + 2];
         pos.emplace_back(x, y, z);
-
+        
         float nx = vertexData[i * 6 + 3];
         float ny = vertexData[i * 6 + 4];
         float nz = vertexData[i * 6 + 5];
         norm.emplace_back(nx, ny, nz);
     }
-
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0); // Positions
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    glEnableVertexAttribArray(1); // Normals
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)(totalVertices * 3 * sizeof(float)));
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
+    
+    if (gpuHooks.uploadTriangles) {
+        gpuHooks.uploadTriangles(*this, triangleCount, vertexData);
+    }
+    
     std::cout << "Shape successfully created with " << triangleCount << " triangles and " << totalVertices << " vertices." << std::endl;
 }
 
@@ -94,100 +91,15 @@ Shape::Shape(const size_t vertexCount,
         }
     }
     
-    // Create and setup OpenGL buffers
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    
-    glBindVertexArray(vao);
-    
-    // Calculate buffer sizes and offsets
-    size_t positionSize = vertexCount * 3 * sizeof(float);
-    size_t normalSize = vertexCount * 3 * sizeof(float);
-    size_t uvSize = !uvData.empty() ? vertexCount * 2 * sizeof(float) : 0;
-    
-    // Calculate total buffer size
-    size_t totalSize = positionSize + normalSize + uvSize;
-    
-    // Add space for bone data if needed
-    size_t boneIndicesSize = 0;
-    size_t boneWeightsSize = 0;
-    std::vector<float> boneIndicesData;
-    std::vector<float> boneWeightsData;
-    
+    // The skeleton needs the positions to build its per-bone bounds
     if (hasBones) {
-        boneIndicesSize = vertexCount * 4 * sizeof(float);
-        boneWeightsSize = vertexCount * 4 * sizeof(float);
-        totalSize += boneIndicesSize + boneWeightsSize;
-        
-        // Prepare bone data for GPU
-        boneIndicesData.resize(vertexCount * 4);
-        boneWeightsData.resize(vertexCount * 4);
-        
-        for (size_t i = 0; i < vertexCount; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                boneIndicesData[i * 4 + j] = static_cast<float>(vertexBoneData[i].indices[j]);
-                boneWeightsData[i * 4 + j] = vertexBoneData[i].weights[j];
-            }
-        }
+        this->skeleton = std::make_shared<const Skeleton>(bones, pos, vertexBoneData);
     }
     
-    // Allocate buffer
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STATIC_DRAW);
-    
-    // Upload position data
-    size_t offset = 0;
-    glBufferSubData(GL_ARRAY_BUFFER, offset, positionSize, positionData.data());
-    offset += positionSize;
-    
-    // Upload normal data
-    glBufferSubData(GL_ARRAY_BUFFER, offset, normalSize, normalData.data());
-    offset += normalSize;
-    
-    // Upload UV data if present
-    if (!uvData.empty()) {
-        glBufferSubData(GL_ARRAY_BUFFER, offset, uvSize, uvData.data());
-        offset += uvSize;
-    }
-    
-    // Upload bone data if present
-    if (hasBones) {
-        glBufferSubData(GL_ARRAY_BUFFER, offset, boneIndicesSize, boneIndicesData.data());
-        offset += boneIndicesSize;
-        
-        glBufferSubData(GL_ARRAY_BUFFER, offset, boneWeightsSize, boneWeightsData.data());
+    if (gpuHooks.uploadMesh) {
+        gpuHooks.uploadMesh(*this, positionData, normalData, uvData);
     }
     
-    // Set up vertex attributes
-    offset = 0;
-    glEnableVertexAttribArray(0);  // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)offset);
-    offset += positionSize;
-    
-    glEnableVertexAttribArray(1);  // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)offset);
-    offset += normalSize;
-    
-    // Set up UV attribute if present
-    if (!uvData.empty()) {
-        glEnableVertexAttribArray(2);  // UV
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)offset);
-        offset += uvSize;
-    }
-    
-    // Set up bone attributes if present
-    if (hasBones) {
-        glEnableVertexAttribArray(3);  // Bone indices
-        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, (void*)offset);
-        offset += boneIndicesSize;
-        
-        glEnableVertexAttribArray(4);  // Bone weights
-        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 0, (void*)offset);
-    }
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    
     std::cout << "Shape successfully created with " << vertexCount << " vertices";
     if (hasBones) {
         std::cout << " and " << bones.size() << " bones";
@@ -196,11 +108,14 @@ Shape::Shape(const size_t vertexCount,
 }
 
 Shape::~Shape() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    vao = 0;
-    vbo = 0;
-    std::cout << "Shape destroyed, OpenGL buffers deleted." << std::endl;
+    // Never uploaded (headless, or the mesh data was rejected)
+    if (vao == 0 && vbo == 0) {
+        return;
+    }
+    
+    if (gpuHooks.release) {
+        gpuHooks.release(*this);
+    }
 }
 
 void Shape::updateBoneTransforms(const std::vector<glm::quat>& boneRotations) {
@@ -256,7 +171,7 @@ bool loadMeshData(const std::string& filename, size_t& triangleCount, std::vecto
         std::cerr << "Error: Could not open mesh file " << filename << std::endl;
         return false;
     }
-
+    
     std::string line;
     
     // Read number of triangles
@@ -265,7 +180,7 @@ bool loadMeshData(const std::string& filename, size_t& triangleCount, std::vecto
         return false;
     }
     triangleCount = std::stoi(line);
-
+    
     // Read vertex positions first
     for (size_t i = 0; i < triangleCount * 3; ++i) {
         float x, y, z;
@@ -277,7 +192,7 @@ bool loadMeshData(const std::string& filename, size_t& triangleCount, std::vecto
         vertexData.push_back(y);
         vertexData.push_back(z);
     }
-
+    
     // Read normal vectors next
     for (size_t i = 0; i < triangleCount * 3; ++i) {
         float nx, ny, nz;
@@ -289,7 +204,7 @@ bool loadMeshData(const std::string& filename, size_t& triangleCount, std::vecto
         vertexData.push_back(ny);
         vertexData.push_back(nz);
     }
-
+    
     input.close();
     std::cout << "Loaded " << triangleCount << " triangles from " << filename << std::endl;
     return true;
@@ -311,7 +226,7 @@ bool loadMeshWithArmature(const std::string& filename,
         std::cerr << "Error: Could not open mesh file " << filename << std::endl;
         return false;
     }
-
+    
     std::string line;
     hasBones = false;
     vertexCount = 0;
@@ -0,0 +1,176 @@
+#include "ShapeGpu.hpp"
+#include "CpuSkinner.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+void ShapeGpu::install() {
+    Shape::setGpuHooks(Shape::GpuHooks{ uploadTriangles, uploadMesh, release });
+}
+
+void ShapeGpu::uploadSkinned(unsigned int vbo, CpuSkinner& skinner) {
+    const std::vector<float>& vertexData = skinner.packVertexData();
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertexData.size() * sizeof(float), vertexData.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ShapeGpu::uploadTriangles(Shape& shape, size_t triangleCount, const std::vector<float>& vertexData) {
+    size_t totalVertices = triangleCount * 3;
+    
+    glGenVertexArrays(1, &shape.vao);
+    glGenBuffers(1, &shape.vbo);
+    
+    glBindVertexArray(shape.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, shape.vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
+    
+    glEnableVertexAttribArray(0); // Positions
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    
+    glEnableVertexAttribArray(1); // Normals
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)(totalVertices * 3 * sizeof(float)));
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void ShapeGpu::uploadMesh(Shape& shape, const std::vector<float>& positionData,
+                          const std::vector<float>& normalData, const std::vector<float>& uvData) {
+    const size_t vertexCount = shape.getVertexCount();
+    const bool hasBones = shape.hasArmature();
+    const std::vector<Bone>& bones = shape.getBones();
+    const std::vector<VertexBoneData>& vertexBoneData = shape.getVertexBoneData();
+    
+    // Create and setup OpenGL buffers
+    glGenVertexArrays(1, &shape.vao);
+    glGenBuffers(1, &shape.vbo);
+    
+    glBindVertexArray(shape.vao);
+    
+    // Calculate buffer sizes and offsets
+    size_t positionSize = vertexCount * 3 * sizeof(float);
+    size_t normalSize = vertexCount * 3 * sizeof(float);
+    size_t uvSize = !uvData.empty() ? vertexCount * 2 * sizeof(float) : 0;
+    
+    // Calculate total buffer size
+    size_t totalSize = positionSize + normalSize + uvSize;
+    
+    // Add space for bone data if needed
+    // Bone indices and weights are packed as 4 bytes each per vertex (8 bytes instead of 32)
+    size_t boneIndicesSize = 0;
+    size_t boneWeightsSize = 0;
+    std::vector<uint8_t> boneIndicesData;
+    std::vector<uint8_t> boneWeightsData;
+    
+    if (hasBones) {
+        if (bones.size() > 256) {
+            std::cerr << "Warning: " << bones.size() << " bones exceed the 8-bit bone index range (256)" << std::endl;
+        }
+        
+        boneIndicesSize = vertexCount * 4 * sizeof(uint8_t);
+        boneWeightsSize = vertexCount * 4 * sizeof(uint8_t);
+        totalSize += boneIndicesSize + boneWeightsSize;
+        
+        // Prepare bone data for GPU
+        boneIndicesData.resize(vertexCount * 4);
+        boneWeightsData.resize(vertexCount * 4);
+        
+        for (size_t i = 0; i < vertexCount; ++i) {
+            const VertexBoneData& vbd = vertexBoneData[i];
+            
+            float weightSum = 0.0f;
+            for (int j = 0; j < 4; ++j) {
+                boneIndicesData[i * 4 + j] = static_cast<uint8_t>(std::min(std::max(vbd.indices[j], 0), 255));
+                weightSum += vbd.weights[j];
+            }
+            
+            // Quantize normalized weights to 0..255 and push the rounding error onto the
+            // largest weight so every vertex still sums to exactly 1.0 in the shader
+            int quantized[4] = {0, 0, 0, 0};
+            int total = 0;
+            int largest = 0;
+            if (weightSum > 0.0f) {
+                for (int j = 0; j < 4; ++j) {
+                    quantized[j] = static_cast<int>(std::round(vbd.weights[j] / weightSum * 255.0f));
+                    total += quantized[j];
+                    if (vbd.weights[j] > vbd.weights[largest]) largest = j;
+                }
+                quantized[largest] += 255 - total;
+            } else {
+                quantized[0] = 255;
+            }
+            
+            for (int j = 0; j < 4; ++j) {
+                boneWeightsData[i * 4 + j] = static_cast<uint8_t>(std::min(std::max(quantized[j], 0), 255));
+            }
+        }
+    }
+    
+    // Allocate buffer
+    glBindBuffer(GL_ARRAY_BUFFER, shape.vbo);
+    glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STATIC_DRAW);
+    
+    // Upload position data
+    size_t offset = 0;
+    glBufferSubData(GL_ARRAY_BUFFER, offset, positionSize, positionData.data());
+    offset += positionSize;
+    
+    // Upload normal data
+    glBufferSubData(GL_ARRAY_BUFFER, offset, normalSize, normalData.data());
+    offset += normalSize;
+    
+    // Upload UV data if present
+    if (!uvData.empty()) {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, uvSize, uvData.data());
+        offset += uvSize;
+    }
+    
+    // Upload bone data if present
+    if (hasBones) {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, boneIndicesSize, boneIndicesData.data());
+        offset += boneIndicesSize;
+        
+        glBufferSubData(GL_ARRAY_BUFFER, offset, boneWeightsSize, boneWeightsData.data());
+    }
+    
+    // Set up vertex attributes
+    offset = 0;
+    glEnableVertexAttribArray(0);  // Position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)offset);
+    offset += positionSize;
+    
+    glEnableVertexAttribArray(1);  // Normal
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)offset);
+    offset += normalSize;
+    
+    // Set up UV attribute if present
+    if (!uvData.empty()) {
+        glEnableVertexAttribArray(2);  // UV
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, (void*)offset);
+        offset += uvSize;
+    }
+    
+    // Set up bone attributes if present
+    if (hasBones) {
+        glEnableVertexAttribArray(3);  // Bone indices (integer attribute, read as uvec4)
+        glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, 0, (void*)offset);
+        offset += boneIndicesSize;
+        
+        glEnableVertexAttribArray(4);  // Bone weights (normalized bytes, read as vec4)
+        glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)offset);
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void ShapeGpu::release(Shape& shape) {
+    glDeleteVertexArrays(1, &shape.vao);
+    glDeleteBuffers(1, &shape.vbo);
+    shape.vao = 0;
+    shape.vbo = 0;
+    std::cout << "Shape destroyed, OpenGL buffers deleted." << std::endl;
+}
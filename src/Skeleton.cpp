@@ -0,0 +1,202 @@
+#include "Skeleton.hpp"
+#include "Shape.hpp"
+#include <algorithm>
+#include <iostream>
+
+// Box containing an affine-transformed box: transform the center, and project the
+// extents onto each output axis through the absolute linear part
+static AABB transformBounds(const glm::mat4& m, const AABB& box) {
+    const glm::vec3 center = glm::vec3(m * glm::vec4(box.getCenter(), 1.0f));
+    const glm::vec3 extents = box.getExtents();
+    const glm::vec3 worldExtents = glm::abs(glm::vec3(m[0])) * extents.x +
+                                   glm::abs(glm::vec3(m[1])) * extents.y +
+                                   glm::abs(glm::vec3(m[2])) * extents.z;
+    return AABB(center - worldExtents, center + worldExtents);
+}
+
+Skeleton::Skeleton(const std::vector<Bone>& bones)
+    : Skeleton(bones, std::vector<glm::vec3>(), std::vector<VertexBoneData>()) {}
+
+Skeleton::Skeleton(const std::vector<Bone>& bones,
+                   const std::vector<glm::vec3>& positions,
+                   const std::vector<VertexBoneData>& vertexBoneData)
+    : hasUnskinnedBounds(false), fileOrderTopological(true) {
+    const size_t boneCount = bones.size();
+    if (boneCount > 65535) {
+        std::cerr << "Skeleton: " << boneCount << " bones exceed the 16-bit evaluation order" << std::endl;
+    }
+    
+    names.resize(boneCount);
+    parents.resize(boneCount);
+    for (size_t i = 0; i < boneCount; i++) {
+        names[i] = bones[i].name;
+        int parent = std::max(-1, bones[i].parentIndex);
+        if (parent >= static_cast<int>(boneCount) || parent == static_cast<int>(i)) {
+            std::cerr << "Skeleton: bone '" << bones[i].name << "' has invalid parent " << parent
+                      << ", treating it as a root" << std::endl;
+            parent = -1;
+        }
+        parents[i] = parent;
+        if (parent >= static_cast<int>(i)) {
+            fileOrderTopological = false;
+        }
+    }
+    
+    // Parent-before-child evaluation order (file order when it already qualifies)
+    evaluationOrder.reserve(boneCount);
+    if (fileOrderTopological) {
+        for (size_t i = 0; i < boneCount; i++) {
+            evaluationOrder.push_back(static_cast<uint16_t>(i));
+        }
+    } else {
+        // 0 = unvisited, 1 = on the current ancestor path, 2 = placed
+        std::vector<uint8_t> state(boneCount, 0);
+        std::vector<int> path;
+        for (size_t i = 0; i < boneCount; i++) {
+            path.clear();
+            int bone = static_cast<int>(i);
+            while (bone >= 0 && state[bone] == 0) {
+                state[bone] = 1;
+                path.push_back(bone);
+                bone = parents[bone];
+            }
+            
+            // Walked back into the current path: break the cycle by making that bone a root
+            int cycleRoot = -1;
+            if (bone >= 0 && state[bone] == 1) {
+                std::cerr << "Skeleton: bone hierarchy cycle at '" << names[bone]
+                          << "', treating it as a root" << std::endl;
+                parents[bone] = -1;
+                cycleRoot = bone;
+                evaluationOrder.push_back(static_cast<uint16_t>(bone));
+                state[bone] = 2;
+            }
+            
+            // Ancestors were collected child-first; place them root-first
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                if (*it == cycleRoot) continue;
+                evaluationOrder.push_back(static_cast<uint16_t>(*it));
+                state[*it] = 2;
+            }
+        }
+    }
+    
+    // Bind pose has no rotation: each bone sits at its head position in model space
+    bindTranslations.resize(boneCount);
+    inverseBind.resize(boneCount);
+    for (size_t i = 0; i < boneCount; i++) {
+        const glm::vec3& head = bones[i].localPosition;
+        bindTranslations[i] = parents[i] >= 0 ? head - bones[parents[i]].localPosition : head;
+        inverseBind[i] = Affine(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                                glm::vec3(0.0f, 0.0f, 1.0f), -head);
+    }
+    
+    // Per-bone boxes: every vertex grows the box of each bone that influences it
+    std::vector<AABB> bounds(boneCount);
+    std::vector<uint8_t> bounded(boneCount, 0);
+    for (size_t v = 0; v < positions.size(); v++) {
+        const glm::vec3& p = positions[v];
+        bool weighted = false;
+        if (v < vertexBoneData.size()) {
+            const VertexBoneData& data = vertexBoneData[v];
+            for (int j = 0; j < 4; j++) {
+                int bone = data.indices[j];
+                if (data.weights[j] <= 0.0f || bone < 0 || bone >= static_cast<int>(boneCount)) {
+                    continue;
+                }
+                bounds[bone] = bounded[bone] ? AABB(glm::min(bounds[bone].min, p), glm::max(bounds[bone].max, p))
+                                             : AABB(p, p);
+                bounded[bone] = 1;
+                weighted = true;
+            }
+        }
+        
+        // The shaders leave unweighted vertices rigid under the model matrix
+        if (!weighted) {
+            unskinnedBounds = hasUnskinnedBounds ? AABB(glm::min(unskinnedBounds.min, p), glm::max(unskinnedBounds.max, p))
+                                                 : AABB(p, p);
+            hasUnskinnedBounds = true;
+        }
+    }
+    
+    for (size_t i = 0; i < boneCount; i++) {
+        if (bounded[i]) {
+            boundedBones.push_back(static_cast<uint16_t>(i));
+            boneBounds.push_back(bounds[i]);
+        }
+    }
+}
+
+int Skeleton::findBone(const std::string& name) const {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void Skeleton::computeModelSpace(const std::vector<Quaternion>& localRotations,
+                                 std::vector<Affine>& modelSpace,
+                                 std::vector<Affine>& skinning) const {
+    // No-ops once the buffers are sized
+    modelSpace.resize(parents.size());
+    skinning.resize(parents.size());
+    
+    for (uint16_t bone : evaluationOrder) {
+        glm::mat3 rotation = bone < localRotations.size() ? localRotations[bone].toMatrix3() : glm::mat3(1.0f);
+        Affine local(rotation[0], rotation[1], rotation[2], bindTranslations[bone]);
+        
+        int parent = parents[bone];
+        modelSpace[bone] = parent >= 0 ? multiply(modelSpace[parent], local) : local;
+        skinning[bone] = multiply(modelSpace[bone], inverseBind[bone]);
+    }
+}
+
+void Skeleton::computeWorldMatrices(const std::vector<Affine>& skinning, const glm::mat4& modelMatrix,
+                                    std::vector<glm::mat4>& worldMatrices) const {
+    const Affine model = fromMatrix(modelMatrix);
+    const size_t count = std::min(skinning.size(), parents.size());
+    worldMatrices.resize(count);
+    
+    for (size_t i = 0; i < count; i++) {
+        worldMatrices[i] = toMatrix(multiply(model, skinning[i]));
+    }
+}
+
+bool Skeleton::computeSkinnedBounds(const std::vector<glm::mat4>& worldMatrices, const glm::mat4& modelMatrix,
+                                    AABB& bounds) const {
+    if (!hasBoneBounds()) {
+        return false;
+    }
+    
+    bool empty = true;
+    if (hasUnskinnedBounds) {
+        bounds = transformBounds(modelMatrix, unskinnedBounds);
+        empty = false;
+    }
+    
+    for (size_t i = 0; i < boundedBones.size(); i++) {
+        const uint16_t bone = boundedBones[i];
+        const AABB box = transformBounds(bone < worldMatrices.size() ? worldMatrices[bone] : modelMatrix,
+                                         boneBounds[i]);
+        bounds = empty ? box : bounds.merge(box);
+        empty = false;
+    }
+    return true;
+}
+
+Skeleton::Affine Skeleton::multiply(const Affine& a, const Affine& b) {
+    // Linear parts multiply; b's translation is transformed by a
+    const glm::mat3 linear(a[0], a[1], a[2]);
+    return Affine(linear * b[0], linear * b[1], linear * b[2], linear * b[3] + a[3]);
+}
+
+Skeleton::Affine Skeleton::fromMatrix(const glm::mat4& m) {
+    return Affine(glm::vec3(m[0]), glm::vec3(m[1]), glm::vec3(m[2]), glm::vec3(m[3]));
+}
+
+glm::mat4 Skeleton::toMatrix(const Affine& a) {
+    return glm::mat4(glm::vec4(a[0], 0.0f), glm::vec4(a[1], 0.0f),
+                     glm::vec4(a[2], 0.0f), glm::vec4(a[3], 1.0f));
+}
@@ -0,0 +1,289 @@
+#include "SoundBank.hpp"
+#include "SoundSystem.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// .sbank layout: header, entry table (sorted by ID), name blob, then the sample arena.
+// The arena and every sound in it start on a 64-byte boundary. Native endianness.
+static const char SBANK_MAGIC[4] = { 'S', 'B', 'N', 'K' };
+static const uint32_t SBANK_VERSION = 1;
+static const uint32_t SBANK_ENDIAN_CHECK = 0x01020304;
+static const size_t SBANK_ALIGNMENT = 64;
+
+struct SoundBankHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t endianCheck;
+    uint32_t sampleRate;
+    uint32_t soundCount;
+    uint32_t nameBytes;
+    uint64_t entriesOffset;
+    uint64_t namesOffset;
+    uint64_t arenaOffset;
+    uint64_t arenaBytes;
+};
+static_assert(sizeof(SoundBankHeader) == 56, "SoundBankHeader layout is part of the file format");
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+SoundID SoundID::fromName(const std::string& name) {
+    // FNV-1a; 0 is reserved for "no sound"
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : name) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return SoundID{ hash != 0 ? hash : 1u };
+}
+
+void SoundBankBuildStats::print(std::ostream& out) const {
+    out << "Sounds: " << sounds << " (" << sharedSounds << " sharing another's samples)" << std::endl;
+    out << "Size: " << sourceBytes << " bytes of WAV -> " << bankBytes << " byte bank" << std::endl;
+}
+
+SoundBank::SoundBank()
+    : data(nullptr), size(0), mapped(false), entries(nullptr), soundCount(0), names(nullptr), arena(nullptr), sampleRate(0) {}
+
+SoundBank::~SoundBank() {
+#if !defined(_WIN32)
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
+
+bool SoundBank::build(const std::string& directory, const std::string& outputPath, int sampleRate,
+                      SoundBankBuildStats* stats) {
+    static_assert(sizeof(Entry) == 32, "SoundBank::Entry layout is part of the file format");
+    namespace fs = std::filesystem;
+    
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (const fs::directory_entry& item : fs::directory_iterator(directory, error)) {
+        std::string extension = item.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (item.is_regular_file() && extension == ".wav") {
+            files.push_back(item.path());
+        }
+    }
+    if (error) {
+        std::cerr << "Failed to read sound directory " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+    
+    SoundBankBuildStats buildStats;
+    std::vector<Entry> table;
+    std::string nameBlob;
+    std::vector<float> samples;
+    std::unordered_multimap<uint64_t, size_t> entriesByContent;   // Sample hash -> table row
+    
+    for (const fs::path& file : files) {
+        const std::string name = file.stem().string();
+        const SoundID id = SoundID::fromName(name);
+        for (const Entry& entry : table) {
+            if (entry.id == id.value) {
+                std::cerr << "Sound bank: " << name << " has the same ID as "
+                          << nameBlob.substr(entry.nameOffset, entry.nameLength) << std::endl;
+                return false;
+            }
+        }
+        
+        std::unique_ptr<Sound> sound = SoundSystem::decodeWAV(file.string(), sampleRate);
+        if (!sound) {
+            return false;
+        }
+        const float* soundSamples = sound->getSamples();
+        const size_t sampleCount = static_cast<size_t>(sound->getFrameCount()) * sound->getChannels();
+        buildStats.sourceBytes += static_cast<size_t>(fs::file_size(file, error));
+        
+        Entry entry = {};
+        entry.id = id.value;
+        entry.nameOffset = static_cast<uint32_t>(nameBlob.size());
+        entry.nameLength = static_cast<uint32_t>(name.size());
+        entry.frameCount = sound->getFrameCount();
+        entry.channels = static_cast<uint32_t>(sound->getChannels());
+        nameBlob += name;
+        
+        // FNV-1a over the converted samples finds duplicates; equal hashes are compared in full
+        uint64_t hash = 14695981039346656037ull ^ entry.channels;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(soundSamples);
+        for (size_t i = 0; i < sampleCount * sizeof(float); i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        
+        bool shared = false;
+        auto range = entriesByContent.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            const Entry& other = table[it->second];
+            if (other.frameCount == entry.frameCount && other.channels == entry.channels &&
+                std::memcmp(&samples[other.firstSample], soundSamples, sampleCount * sizeof(float)) == 0) {
+                entry.firstSample = other.firstSample;
+                shared = true;
+                break;
+            }
+        }
+        
+        if (shared) {
+            buildStats.sharedSounds++;
+        } else {
+            samples.resize(alignUp(samples.size(), SBANK_ALIGNMENT / sizeof(float)));
+            entry.firstSample = samples.size();
+            samples.insert(samples.end(), soundSamples, soundSamples + sampleCount);
+            entriesByContent.emplace(hash, table.size());
+        }
+        table.push_back(entry);
+    }
+    
+    std::sort(table.begin(), table.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+    
+    SoundBankHeader header = {};
+    std::memcpy(header.magic, SBANK_MAGIC, sizeof(SBANK_MAGIC));
+    header.version = SBANK_VERSION;
+    header.endianCheck = SBANK_ENDIAN_CHECK;
+    header.sampleRate = static_cast<uint32_t>(sampleRate);
+    header.soundCount = static_cast<uint32_t>(table.size());
+    header.nameBytes = static_cast<uint32_t>(nameBlob.size());
+    header.entriesOffset = alignUp(sizeof(SoundBankHeader), alignof(Entry));
+    header.namesOffset = header.entriesOffset + table.size() * sizeof(Entry);
+    header.arenaOffset = alignUp(header.namesOffset + nameBlob.size(), SBANK_ALIGNMENT);
+    header.arenaBytes = samples.size() * sizeof(float);
+    
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open sound bank for writing: " << outputPath << std::endl;
+        return false;
+    }
+    
+    std::vector<char> padding(SBANK_ALIGNMENT, 0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding.data(), header.entriesOffset - sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Entry));
+    out.write(nameBlob.data(), nameBlob.size());
+    out.write(padding.data(), header.arenaOffset - header.namesOffset - nameBlob.size());
+    out.write(reinterpret_cast<const char*>(samples.data()), header.arenaBytes);
+    if (!out) {
+        std::cerr << "Failed to write sound bank: " << outputPath << std::endl;
+        return false;
+    }
+    
+    buildStats.sounds = table.size();
+    buildStats.bankBytes = static_cast<size_t>(header.arenaOffset + header.arenaBytes);
+    if (stats) {
+        *stats = buildStats;
+    }
+    return true;
+}
+
+std::unique_ptr<SoundBank> SoundBank::load(const std::string& path) {
+    std::unique_ptr<SoundBank> bank(new SoundBank());
+
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    bank->fallback.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bank->fallback.data()), bank->fallback.size());
+    bank->data = bank->fallback.data();
+    bank->size = bank->fallback.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        std::cerr << "Failed to read sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    
+    // Samples are paged in on first use; the descriptor is not needed once mapped
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    bank->data = static_cast<const uint8_t*>(mapping);
+    bank->size = static_cast<size_t>(info.st_size);
+    bank->mapped = true;
+#endif
+
+    // Everything is validated once here so lookups can trust the table
+    SoundBankHeader header;
+    if (bank->size < sizeof(header)) {
+        std::cerr << "Invalid sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    std::memcpy(&header, bank->data, sizeof(header));
+    if (std::memcmp(header.magic, SBANK_MAGIC, sizeof(SBANK_MAGIC)) != 0 || header.version != SBANK_VERSION ||
+        header.endianCheck != SBANK_ENDIAN_CHECK) {
+        std::cerr << "Invalid or incompatible sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    if (header.entriesOffset % alignof(Entry) != 0 || header.arenaOffset % SBANK_ALIGNMENT != 0 ||
+        header.entriesOffset + static_cast<uint64_t>(header.soundCount) * sizeof(Entry) > header.namesOffset ||
+        header.namesOffset + header.nameBytes > header.arenaOffset ||
+        header.arenaOffset + header.arenaBytes > bank->size) {
+        std::cerr << "Corrupt sound bank: " << path << std::endl;
+        return nullptr;
+    }
+    
+    bank->entries = reinterpret_cast<const Entry*>(bank->data + header.entriesOffset);
+    bank->soundCount = header.soundCount;
+    bank->names = reinterpret_cast<const char*>(bank->data + header.namesOffset);
+    bank->arena = reinterpret_cast<const float*>(bank->data + header.arenaOffset);
+    bank->sampleRate = static_cast<int>(header.sampleRate);
+    
+    const uint64_t arenaSamples = header.arenaBytes / sizeof(float);
+    for (size_t i = 0; i < bank->soundCount; i++) {
+        const Entry& entry = bank->entries[i];
+        if ((i > 0 && entry.id <= bank->entries[i - 1].id) ||
+            static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header.nameBytes ||
+            (entry.channels != 1 && entry.channels != 2) ||
+            entry.firstSample + static_cast<uint64_t>(entry.frameCount) * entry.channels > arenaSamples) {
+            std::cerr << "Corrupt sound bank entry " << i << ": " << path << std::endl;
+            return nullptr;
+        }
+    }
+    return bank;
+}
+
+const SoundBank::Entry* SoundBank::findEntry(SoundID id) const {
+    const Entry* end = entries + soundCount;
+    const Entry* entry = std::lower_bound(entries, end, id.value,
+                                          [](const Entry& e, uint32_t value) { return e.id < value; });
+    return entry != end && entry->id == id.value ? entry : nullptr;
+}
+
+SoundSamples SoundBank::find(SoundID id) const {
+    SoundSamples result;
+    if (const Entry* entry = findEntry(id)) {
+        result.samples = arena + entry->firstSample;
+        result.frameCount = entry->frameCount;
+        result.channels = static_cast<int>(entry->channels);
+    }
+    return result;
+}
+
+std::string SoundBank::getName(SoundID id) const {
+    const Entry* entry = findEntry(id);
+    return entry ? std::string(names + entry->nameOffset, entry->nameLength) : std::string();
+}
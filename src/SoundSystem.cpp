@@ -1,197 +1,539 @@
 #include "SoundSystem.hpp"
+#include "AudioKernels.hpp"
+#include "Camera.hpp"
+#include "GameObject.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
-void SoundSystem::audioCallback(void* userdata, Uint8* stream, int len) {
-    static int callCount = 0;
-    if (callCount++ % 100 == 0) {
-        std::cout << "Audio callback called, len: " << len << std::endl;
+static uint64_t framesToNanos(uint64_t frames) {
+    return frames * 1000000000ull / SoundSystem::OUTPUT_RATE;
+}
+
+// The SDL formats the kernels can decode (SDL_LoadWAV yields little-endian data)
+static bool toSampleFormat(SDL_AudioFormat format, AudioKernels::SampleFormat& out) {
+    switch (format) {
+        case AUDIO_U8: out = AudioKernels::SampleFormat::U8; return true;
+        case AUDIO_S8: out = AudioKernels::SampleFormat::S8; return true;
+        case AUDIO_S16: out = AudioKernels::SampleFormat::S16; return true;
+        case AUDIO_S32: out = AudioKernels::SampleFormat::S32; return true;
+        case AUDIO_F32: out = AudioKernels::SampleFormat::F32; return true;
+        default: return false;
     }
-    
+}
+
+static uint64_t steadyNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void SoundSystem::audioCallback(void* userdata, Uint8* stream, int len) {
     SoundSystem* system = static_cast<SoundSystem*>(userdata);
     
-    // Initialize stream to silence
-    SDL_memset(stream, 0, len);
-    
-    // Count active sounds
-    int activeCount = 0;
-    for (auto& state : system->activeSounds) {
-        if (state.playing) activeCount++;
+    // The device's thread takes the profiler ring reserved by the constructor; offline, the
+    // callback runs on the caller's thread, which may allocate its own
+    if (system->backend != AudioBackend::Offline) {
+        PROFILE_REALTIME_THREAD("Audio");
     }
+    PROFILE_ZONE("SoundSystem::audioCallback");
+    const uint64_t start = steadyNanos();
+    system->callbackTime = system->backend == AudioBackend::Offline ? framesToNanos(system->offlineFrames) : start;
     
-    if (activeCount > 0 && callCount % 100 == 0) {
-        std::cout << "Active sounds: " << activeCount << std::endl;
-    }
+    // Real-time thread: no allocation, locking or I/O from here on.
+    // Apply play/stop/gain requests queued since the last callback, then mix.
+    system->processCommands();
     
-    // Process each active sound
-    for (auto& state : system->activeSounds) {
-        if (!state.playing) continue;
-        
-        // Calculate how many bytes we can mix
-        Uint32 bytesLeft = state.length - state.position;
-        int bytesToMix = (bytesLeft < len) ? bytesLeft : len;
-        
-        if (callCount % 100 == 0) {
-            std::cout << "Mixing " << bytesToMix << " bytes, position: " << state.position 
-                      << ", length: " << state.length << std::endl;
-        }
-        
-        // Use direct copying instead of SDL_MixAudio to debug
-        SDL_MixAudioFormat(stream, state.buffer + state.position, 
-                          AUDIO_S16, bytesToMix, SDL_MIX_MAXVOLUME);
-        
-        // Update position
-        state.position += bytesToMix;
-        
-        // Mark as not playing if done
-        if (state.position >= state.length) {
-            state.playing = false;
-            if (callCount % 100 == 0) {
-                std::cout << "Sound finished playing" << std::endl;
+    const size_t frames = static_cast<size_t>(len) / (sizeof(Sint16) * OUTPUT_CHANNELS);
+    system->mixer.mix(reinterpret_cast<Sint16*>(stream), frames);
+    
+    // Real time even offline: that is what a device would have to wait for
+    system->instrumentation.recordCallback(steadyNanos() - start, frames, OUTPUT_RATE,
+                                           system->mixer.getStreamUnderrunCount());
+}
+
+uint64_t SoundSystem::now() const {
+    return backend == AudioBackend::Offline ? static_cast<uint64_t>(offlineTime * 1.0e9) : steadyNanos();
+}
+
+void SoundSystem::processCommands() {
+    PROFILE_ZONE("SoundSystem::processCommands");
+    AudioCommand command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+            case AudioCommand::Type::Play: {
+                VoiceDesc desc;
+                desc.samples = command.samples.samples;
+                desc.frameCount = command.samples.frameCount;
+                desc.channels = command.samples.channels;
+                desc.stream = command.stream;
+                desc.pan = command.pan;
+                desc.attenuation = command.attenuation;
+                desc.pitch = command.pitch;
+                desc.priority = command.priority;
+                desc.bus = command.bus;
+                desc.notifyEnd = command.positional;
+                mixer.play(command.handle, desc);
+                instrumentation.recordPlayLatency(callbackTime > command.queuedAt ? callbackTime - command.queuedAt : 0);
+                break;
             }
+            case AudioCommand::Type::Stop:
+                mixer.stop(command.handle);
+                break;
+            case AudioCommand::Type::StopAll:
+                mixer.stopAll();
+                break;
+            case AudioCommand::Type::SetGain:
+                mixer.setGain(command.handle, command.gain);
+                break;
+            case AudioCommand::Type::SetPan:
+                mixer.setPan(command.handle, command.pan);
+                break;
+            case AudioCommand::Type::SetSpatial:
+                mixer.setSpatial(command.handle, command.attenuation, command.pan, command.pitch);
+                break;
+            case AudioCommand::Type::SetBusGain:
+                mixer.getBuses().setGain(command.bus, command.gain);
+                break;
+            case AudioCommand::Type::SetBusLowPass:
+                mixer.getBuses().setLowPass(command.bus, command.cutoff);
+                break;
+            case AudioCommand::Type::SetBusReverbSend:
+                mixer.getBuses().setReverbSend(command.bus, command.gain);
+                break;
         }
     }
 }
 
-SoundSystem::SoundSystem() : deviceID(0), mixBuffer(nullptr), mixBufferSize(0) {
-    SDL_Init(SDL_INIT_AUDIO);
+SoundSystem::SoundSystem(AudioBackend backend)
+    : backend(backend), deviceID(0), mixer(MAX_VOICES, OUTPUT_FRAMES, OUTPUT_RATE), callbackTime(0),
+      offlineFrames(0), offlineTime(0.0), nextHandle(0), droppedCommands(0),
+      listenerPosition(0.0f), listenerVelocity(0.0f), listenerRight(1.0f, 0.0f, 0.0f), listenerPlaced(false) {
+    mixer.setVoiceEndCallback(voiceEnded, this);
     SDL_zero(audioSpec);
+    if (backend == AudioBackend::Offline) {
+        // No device to open: advanceOffline() calls the callback itself
+        offlineBuffer.resize(OUTPUT_FRAMES * OUTPUT_CHANNELS);
+        return;
+    }
+    
+    SDL_Init(SDL_INIT_AUDIO);
     
     // Use 16-bit signed audio instead of 8-bit unsigned
-    audioSpec.freq = 44100;
+    audioSpec.freq = OUTPUT_RATE;
     audioSpec.format = AUDIO_S16LSB;
-        audioSpec.channels = 2;
-    audioSpec.samples = 1024;      // Smaller buffer (was 4096)
+    audioSpec.channels = OUTPUT_CHANNELS;
+    audioSpec.samples = OUTPUT_FRAMES;      // Smaller buffer (was 4096)
     audioSpec.callback = audioCallback;
     audioSpec.userdata = this;
     
+    // The device's thread must not allocate its profiler ring in the callback
+    PROFILE_RESERVE_REALTIME_THREADS(1);
     deviceID = SDL_OpenAudioDevice(nullptr, 0, &audioSpec, nullptr, 0);
     if (deviceID == 0) {
         std::cerr << "Failed to open audio device: " << SDL_GetError() << std::endl;
     } else {
-        // Allocate mix buffer (twice the size of the audio buffer for stereo, 2 bytes per sample)
-        mixBufferSize = audioSpec.samples * audioSpec.channels * 2;
-        mixBuffer = new Uint8[mixBufferSize];
-        
+        // The mixer's voices and float accumulator are already allocated
         SDL_PauseAudioDevice(deviceID, 0);
     }
 }
 
 SoundSystem::~SoundSystem() {
-    // Pause the audio device as specified
-    SDL_PauseAudioDevice(deviceID, 1);
-    
-    // Close the audio device
-    SDL_CloseAudioDevice(deviceID);
-    
-    // Delete mix buffer
-    delete[] mixBuffer;
+    if (deviceID != 0) {
+        // Pause the audio device as specified
+        SDL_PauseAudioDevice(deviceID, 1);
+        
+        // Close the audio device
+        SDL_CloseAudioDevice(deviceID);
+    }
     
     // Sound objects will clean up themselves thanks to unique_ptr and RAII
     
-    // For any active sounds that have autoFree set
-    for (auto& state : activeSounds) {
-        if (state.autoFree && state.buffer) {
-            SDL_FreeWAV(state.buffer);
+    // The device is closed, so this thread now owns the command ring and the voices.
+    // Release streams still queued or playing; the streamer deletes them as it shuts down.
+    AudioCommand command;
+    while (commands.pop(command)) {
+        if (command.type == AudioCommand::Type::Play && command.stream) {
+            command.stream->release();
         }
     }
+    mixer.stopAll();
     
-    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    if (backend == AudioBackend::Device) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+}
+
+void SoundSystem::advanceOffline(double seconds) {
+    if (backend != AudioBackend::Offline) {
+        std::cerr << "advanceOffline needs the offline audio backend" << std::endl;
+        return;
+    }
+    
+    // Callback k starts at frame k * OUTPUT_FRAMES of the simulated clock
+    offlineTime += std::max(0.0, seconds);
+    const int len = static_cast<int>(offlineBuffer.size() * sizeof(Sint16));
+    while (static_cast<double>(offlineFrames) / OUTPUT_RATE < offlineTime) {
+        streamer.sync();
+        audioCallback(this, reinterpret_cast<Uint8*>(offlineBuffer.data()), len);
+        capture.write(offlineBuffer.data(), OUTPUT_FRAMES);
+        offlineFrames += OUTPUT_FRAMES;
+    }
+}
+
+bool SoundSystem::startCapture(const std::string& filepath) {
+    if (backend != AudioBackend::Offline) {
+        // Writing files from the device callback would not be real-time safe
+        std::cerr << "Audio capture needs the offline audio backend" << std::endl;
+        return false;
+    }
+    return capture.open(filepath, OUTPUT_RATE, OUTPUT_CHANNELS);
 }
 
-bool SoundSystem::loadSound(const std::string& filepath) {
+std::unique_ptr<Sound> SoundSystem::decodeWAV(const std::string& filepath, int sampleRate) {
     SDL_AudioSpec wavSpec;
     Uint8* wavBuffer;
     Uint32 wavLength;
     
     if (!SDL_LoadWAV(filepath.c_str(), &wavSpec, &wavBuffer, &wavLength)) {
         std::cerr << "Error: Failed to load WAV file: " << filepath << std::endl;
-        return -1;
+        return nullptr;
+    }
+    
+    std::vector<float> decoded;
+    AudioKernels::SampleFormat format;
+    bool supported = toSampleFormat(wavSpec.format, format);
+    if (supported) {
+        AudioKernels::decodeToFloat(wavBuffer, wavLength, format, decoded);
+    }
+    SDL_FreeWAV(wavBuffer);
+    if (!supported || wavSpec.channels == 0 || decoded.size() < wavSpec.channels) {
+        std::cerr << "Error: Unsupported WAV format " << wavSpec.format << ": " << filepath << std::endl;
+        return nullptr;
+    }
+    
+    // Mono and stereo are mixed as they are; anything wider is folded down to mono
+    int channels = wavSpec.channels;
+    if (channels > OUTPUT_CHANNELS) {
+        const size_t frames = decoded.size() / channels;
+        for (size_t frame = 0; frame < frames; frame++) {
+            float sum = 0.0f;
+            for (int c = 0; c < channels; c++) {
+                sum += decoded[frame * channels + c];
+            }
+            decoded[frame] = sum / channels;
+        }
+        decoded.resize(frames);
+        channels = 1;
     }
     
-    if (wavSpec.channels != 1) {
-        std::cerr << "Error: Only mono WAV files are supported!" << std::endl;
-        SDL_FreeWAV(wavBuffer);
-        return -1;
+    std::vector<float> samples;
+    AudioKernels::resample(decoded, channels, wavSpec.freq, sampleRate, samples);
+    if (samples.empty()) {
+        std::cerr << "Error: Empty WAV file: " << filepath << std::endl;
+        return nullptr;
     }
     
     // Add debug information
     std::cout << "Loaded WAV file: " << filepath << std::endl;
     std::cout << "  Format: " << wavSpec.format << std::endl;
-    std::cout << "  Frequency: " << wavSpec.freq << std::endl;
-    std::cout << "  Channels: " << wavSpec.channels << std::endl;
+    std::cout << "  Frequency: " << wavSpec.freq << " (resampled to " << sampleRate << ")" << std::endl;
+    std::cout << "  Channels: " << static_cast<int>(wavSpec.channels) << std::endl;
     std::cout << "  Length: " << wavLength << " bytes" << std::endl;
     
-    // Create and add sound object
-    sounds.push_back(std::make_unique<Sound>(wavBuffer, wavLength));
-    return sounds.size() - 1;
+    return std::make_unique<Sound>(std::move(samples), channels);
 }
 
-void SoundSystem::playSound(int soundIndex) {
-    if (soundIndex < 0 || soundIndex >= sounds.size()) {
-        std::cerr << "Invalid sound index: " << soundIndex << std::endl;
-        return;
+bool SoundSystem::loadBank(const std::string& filepath) {
+    std::unique_ptr<SoundBank> bank = SoundBank::load(filepath);
+    if (!bank) {
+        return false;
     }
+    if (bank->getSampleRate() != OUTPUT_RATE) {
+        std::cerr << "Error: Sound bank " << filepath << " was built for " << bank->getSampleRate()
+                  << " Hz, the output runs at " << OUTPUT_RATE << " Hz" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Loaded sound bank: " << filepath << " (" << bank->getSoundCount() << " sounds, "
+              << bank->getFileSize() << " bytes)" << std::endl;
+    banks.push_back(std::move(bank));
+    return true;
+}
+
+SoundID SoundSystem::loadSound(const std::string& filepath) {
+    // Same ID as the sound would have in a bank built from its directory
+    const SoundID id = SoundID::fromName(std::filesystem::path(filepath).stem().string());
     
-    // Lock audio before modifying the active sounds
-    SDL_LockAudioDevice(deviceID);
+    std::unique_ptr<Sound> sound = decodeWAV(filepath);
+    if (!sound) {
+        return SoundID();
+    }
     
-    SoundState newState;
-    newState.buffer = sounds[soundIndex]->getBuffer();
-    newState.length = sounds[soundIndex]->getLength();
-    newState.position = 0;
-    newState.playing = true;
-    newState.autoFree = false;  // We don't free preloaded sounds
+    // Reloading a name replaces the old samples, which must not be playing
+    sounds[id.value] = std::move(sound);
+    return id;
+}
+
+SoundSamples SoundSystem::findSound(SoundID id) const {
+    for (const auto& bank : banks) {
+        SoundSamples samples = bank->find(id);
+        if (samples.isValid()) {
+            return samples;
+        }
+    }
     
-    activeSounds.push_back(newState);
+    auto it = sounds.find(id.value);
+    if (it != sounds.end()) {
+        return it->second->getView();
+    }
     
-    SDL_UnlockAudioDevice(deviceID);
+    std::cerr << "Unknown sound ID: " << id.value << std::endl;
+    return SoundSamples();
 }
 
-void SoundSystem::playSound(const std::string& filepath) {
-    SDL_AudioSpec wavSpec;
-    Uint8* wavBuffer;
-    Uint32 wavLength;
+SoundHandle SoundSystem::playSound(SoundID id, int priority, AudioBusID bus) {
+    SoundSamples samples = findSound(id);
+    if (!samples.isValid()) {
+        return 0;
+    }
     
-    if (!SDL_LoadWAV(filepath.c_str(), &wavSpec, &wavBuffer, &wavLength)) {
-        std::cerr << "Error: Failed to load WAV file: " << filepath << std::endl;
-        return;
+    return queuePlay(samples, nullptr, priority, bus);
+}
+
+SoundHandle SoundSystem::playSound(const std::string& filepath, int priority) {
+    // Decoding the whole file here would stall the game thread on every call
+    return playStream(filepath, false, priority, AudioBusID::SFX);
+}
+
+SoundHandle SoundSystem::playStream(const std::string& filepath, bool looping, int priority, AudioBusID bus) {
+    return queuePlay(SoundSamples(), new AudioStream(filepath, OUTPUT_RATE, looping), priority, bus);
+}
+
+SoundHandle SoundSystem::playSoundAt(SoundID id, const glm::vec3& position, int priority,
+                                     const SpatialSettings& settings) {
+    return playPositional(id, position, nullptr, priority, settings);
+}
+
+SoundHandle SoundSystem::playSoundAt(SoundID id, const GameObject* object, int priority,
+                                     const SpatialSettings& settings) {
+    if (!object) return 0;
+    return playPositional(id, object->getPosition(), object, priority, settings);
+}
+
+SoundHandle SoundSystem::playPositional(SoundID id, const glm::vec3& position, const GameObject* object,
+                                        int priority, const SpatialSettings& settings) {
+    SoundSamples samples = findSound(id);
+    if (!samples.isValid()) {
+        return 0;
     }
     
-    if (wavSpec.channels != 1) {
-        std::cerr << "Error: Only mono WAV files are supported!" << std::endl;
-        SDL_FreeWAV(wavBuffer);
-        return;
+    Emitter emitter;
+    emitter.handle = 0;
+    emitter.object = object;
+    emitter.position = position;
+    emitter.velocity = object ? object->getVelocity() : glm::vec3(0.0f);
+    emitter.settings = settings;
+    emitter.settings.minDistance = std::max(settings.minDistance, 0.001f);
+    emitter.settings.maxDistance = std::max(settings.maxDistance, emitter.settings.minDistance);
+    return queuePlay(samples, nullptr, priority, AudioBusID::SFX, &emitter);
+}
+
+SoundHandle SoundSystem::queuePlay(const SoundSamples& samples, AudioStream* stream, int priority, AudioBusID bus,
+                                   const Emitter* emitter) {
+    // Handles wrap around but skip 0, which means "no sound"
+    if (++nextHandle == 0) {
+        ++nextHandle;
     }
     
-    // Lock audio before modifying the active sounds
-    SDL_LockAudioDevice(deviceID);
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::Play;
+    command.handle = nextHandle;
+    command.samples = samples;
+    command.stream = stream;
+    command.priority = priority;
+    command.bus = bus;
+    command.queuedAt = now();
+    command.attenuation = 1.0f;
+    command.pitch = 1.0f;
+    if (emitter) {
+        // Start already placed so the first chunk is not heard at full volume
+        command.positional = true;
+        spatialize(*emitter, command.attenuation, command.pan, command.pitch);
+    }
+    if (!sendCommand(command)) {
+        delete stream;
+        return 0;
+    }
+    
+    if (emitter) {
+        emitters.push_back(*emitter);
+        emitters.back().handle = nextHandle;
+    }
     
-    SoundState newState;
-    newState.buffer = wavBuffer;
-    newState.length = wavLength;
-    newState.position = 0;
-    newState.playing = true;
-    newState.autoFree = true;  // We will free this buffer when done
+    // The callback may already be reading it; that is safe before the first block arrives
+    if (stream) {
+        streamer.add(stream);
+    }
+    return nextHandle;
+}
+
+void SoundSystem::stopSound(SoundHandle handle) {
+    if (handle == 0) return;
     
-    activeSounds.push_back(newState);
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::Stop;
+    command.handle = handle;
+    sendCommand(command);
+}
+
+void SoundSystem::stopAllSounds() {
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::StopAll;
+    sendCommand(command);
+}
+
+void SoundSystem::setSoundGain(SoundHandle handle, float gain) {
+    if (handle == 0) return;
     
-    SDL_UnlockAudioDevice(deviceID);
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::SetGain;
+    command.handle = handle;
+    command.gain = std::max(0.0f, std::min(gain, 1.0f));
+    sendCommand(command);
 }
 
-void SoundSystem::cleanup() {
-    SDL_LockAudioDevice(deviceID);
+void SoundSystem::setSoundPan(SoundHandle handle, float pan) {
+    if (handle == 0) return;
     
-    auto it = activeSounds.begin();
-    while (it != activeSounds.end()) {
-        if (!it->playing) {
-            if (it->autoFree && it->buffer) {
-                SDL_FreeWAV(it->buffer);
-                it->buffer = nullptr;
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::SetPan;
+    command.handle = handle;
+    command.pan = std::max(-1.0f, std::min(pan, 1.0f));
+    sendCommand(command);
+}
+
+void SoundSystem::setBusGain(AudioBusID bus, float gain) {
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::SetBusGain;
+    command.bus = bus;
+    command.gain = std::max(0.0f, gain);
+    sendCommand(command);
+}
+
+void SoundSystem::setBusLowPass(AudioBusID bus, float cutoff) {
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::SetBusLowPass;
+    command.bus = bus;
+    command.cutoff = std::max(0.0f, cutoff);
+    sendCommand(command);
+}
+
+void SoundSystem::setBusReverbSend(AudioBusID bus, float send) {
+    AudioCommand command = {};
+    command.type = AudioCommand::Type::SetBusReverbSend;
+    command.bus = bus;
+    command.gain = std::max(0.0f, std::min(send, 1.0f));
+    sendCommand(command);
+}
+
+void SoundSystem::setSoundPosition(SoundHandle handle, const glm::vec3& position) {
+    for (Emitter& emitter : emitters) {
+        if (emitter.handle == handle) {
+            emitter.object = nullptr;
+            emitter.position = position;
+            emitter.velocity = glm::vec3(0.0f);
+        }
+    }
+}
+
+void SoundSystem::detachEmitters(const GameObject* object) {
+    for (Emitter& emitter : emitters) {
+        if (emitter.object == object) {
+            emitter.position = object->getPosition();
+            emitter.velocity = glm::vec3(0.0f);
+            emitter.object = nullptr;
+        }
+    }
+}
+
+void SoundSystem::voiceEnded(void* userdata, SoundHandle handle) {
+    // Dropped if the game thread stops calling update; the emitter then stays until it does
+    static_cast<SoundSystem*>(userdata)->endedVoices.push(handle);
+}
+
+void SoundSystem::update(const Camera& listener, float deltaTime) {
+    // Forget positional sounds that have finished
+    SoundHandle ended;
+    while (endedVoices.pop(ended)) {
+        for (size_t i = 0; i < emitters.size(); i++) {
+            if (emitters[i].handle == ended) {
+                emitters[i] = emitters.back();
+                emitters.pop_back();
+                break;
             }
-            it = activeSounds.erase(it);
-        } else {
-            ++it;
         }
     }
     
-    SDL_UnlockAudioDevice(deviceID);
-}
\ No newline at end of file
+    // Listener velocity from its movement since the last update (for Doppler)
+    const glm::vec3 position = listener.getPosition();
+    listenerVelocity = listenerPlaced && deltaTime > 0.0f ? (position - listenerPosition) / deltaTime : glm::vec3(0.0f);
+    listenerPosition = position;
+    listenerRight = listener.getRightVector();
+    listenerPlaced = true;
+    
+    // One command per emitter carries attenuation, pan and pitch together
+    for (Emitter& emitter : emitters) {
+        if (emitter.object) {
+            emitter.position = emitter.object->getPosition();
+            emitter.velocity = emitter.object->getVelocity();
+        }
+        
+        AudioCommand command = {};
+        command.type = AudioCommand::Type::SetSpatial;
+        command.handle = emitter.handle;
+        spatialize(emitter, command.attenuation, command.pan, command.pitch);
+        sendCommand(command);
+    }
+}
+
+void SoundSystem::spatialize(const Emitter& emitter, float& attenuation, float& pan, float& pitch) const {
+    const SpatialSettings& settings = emitter.settings;
+    const glm::vec3 offset = emitter.position - listenerPosition;
+    const float distance = glm::length(offset);
+    
+    // Inverse distance, faded to silence over the end of the range so the cut-off is not heard
+    attenuation = settings.minDistance / std::max(distance, settings.minDistance);
+    const float fadeStart = 0.8f * settings.maxDistance;
+    if (distance > fadeStart) {
+        attenuation *= std::max(0.0f, (settings.maxDistance - distance) / (settings.maxDistance - fadeStart));
+    }
+    
+    pan = 0.0f;
+    pitch = 1.0f;
+    if (distance < 1e-4f) {
+        return;
+    }
+    
+    // Pan by how far the sound is to the listener's side
+    const glm::vec3 direction = offset / distance;
+    pan = glm::dot(direction, listenerRight);
+    
+    // Doppler: listener speed towards the sound over source speed away from the listener,
+    // each kept under half the speed of sound
+    if (settings.dopplerFactor > 0.0f) {
+        const float limit = 0.5f * SPEED_OF_SOUND;
+        const float listenerSpeed = std::max(-limit, std::min(glm::dot(listenerVelocity, direction) * settings.dopplerFactor, limit));
+        const float sourceSpeed = std::max(-limit, std::min(glm::dot(emitter.velocity, direction) * settings.dopplerFactor, limit));
+        pitch = (SPEED_OF_SOUND + listenerSpeed) / (SPEED_OF_SOUND + sourceSpeed);
+    }
+}
+
+bool SoundSystem::sendCommand(const AudioCommand& command) {
+    // Never wait for the callback: a full ring drops the command
+    if (!commands.push(command)) {
+        droppedCommands++;
+        return false;
+    }
+    return true;
+}
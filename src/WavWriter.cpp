@@ -0,0 +1,66 @@
+#include "WavWriter.hpp"
+#include <iostream>
+
+template <typename T>
+static void writeValue(std::ofstream& file, T value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+WavWriter::WavWriter() : channels(0), frames(0) {}
+
+WavWriter::~WavWriter() {
+    close();
+}
+
+bool WavWriter::open(const std::string& filepath, int sampleRate, int channels) {
+    close();
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open WAV file for writing: " << filepath << std::endl;
+        return false;
+    }
+    this->filepath = filepath;
+    this->channels = channels;
+    frames = 0;
+    
+    // Canonical 44-byte header; both sizes are patched on close
+    const uint16_t blockAlign = static_cast<uint16_t>(channels * sizeof(int16_t));
+    file.write("RIFF", 4);
+    writeValue<uint32_t>(file, 0);
+    file.write("WAVEfmt ", 8);
+    writeValue<uint32_t>(file, 16);
+    writeValue<uint16_t>(file, 1);     // PCM
+    writeValue<uint16_t>(file, static_cast<uint16_t>(channels));
+    writeValue<uint32_t>(file, static_cast<uint32_t>(sampleRate));
+    writeValue<uint32_t>(file, static_cast<uint32_t>(sampleRate) * blockAlign);
+    writeValue<uint16_t>(file, blockAlign);
+    writeValue<uint16_t>(file, 16);
+    file.write("data", 4);
+    writeValue<uint32_t>(file, 0);
+    return true;
+}
+
+void WavWriter::write(const int16_t* samples, size_t count) {
+    if (!file.is_open()) return;
+    
+    // Little-endian hosts only, like the rest of the audio code
+    file.write(reinterpret_cast<const char*>(samples), static_cast<std::streamsize>(count * channels * sizeof(int16_t)));
+    frames += count;
+}
+
+void WavWriter::close() {
+    if (!file.is_open()) return;
+    
+    const uint64_t dataBytes = frames * channels * sizeof(int16_t);
+    if (dataBytes > 0xFFFFFFFFull - 36) {
+        std::cerr << "Warning: WAV file over 4 GB, its header sizes are wrong: " << filepath << std::endl;
+    }
+    file.seekp(4);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(36 + dataBytes));
+    file.seekp(40);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(dataBytes));
+    if (!file) {
+        std::cerr << "Error: Failed to write WAV file: " << filepath << std::endl;
+    }
+    file.close();
+}